@@ -1,6 +1,6 @@
 #!/usr/bin/env python3
 
-import struct, sys, re
+import struct, sys, re, zlib
 
 # 3.7 for dataclasses, 3.8 for walrus (:=) in recovery
 assert (sys.version_info.major >= 3 and sys.version_info.minor >= 8), \
@@ -82,6 +82,15 @@ class Log:
     TIMESTAMP_FORMAT = re.compile(
         b'(\x00?\d){2}(\x00?:\x00?[0-5]\x00?\d){2}\x00?\.(\x00?\d){3}')
     MAX_TIMESTAMP_LENGTH = 12 * 2
+    # v2 logs are a little-endian sequence of chunks
+    #  magic, flags, number of records, payload length, payload crc32,
+    #  monotonic timestamp in ns of the first record
+    CHUNK_HEADER = struct.Struct('<5IQ')
+    CHUNK_MAGIC = 0x4b435650
+    # payload stored with qCompress: big-endian uint32 size + zlib stream
+    CHUNK_COMPRESSED = 1 << 0
+    #  data length, monotonic timestamp in ns, followed by data
+    RECORD_HEADER = struct.Struct('<IQ')
 
     def __init__(self, filename: str):
         self.filename = filename
@@ -165,6 +174,39 @@ class Log:
         self.header.sensor.family = self.unpack_int(file)
         self.header.sensor.type_sensor = self.unpack_int(file)
 
+    @staticmethod
+    def format_timestamp(timestamp_ns: int):
+        msecs = timestamp_ns // 1_000_000
+        return (f'{msecs // 3_600_000:02d}:{msecs // 60_000 % 60:02d}:'
+                f'{msecs // 1000 % 60:02d}.{msecs % 1000:03d}')
+
+    @classmethod
+    def unpack_chunks(cls, file: IO[Any]):
+        """ Yields (timestamp, message) pairs from v2 chunks.
+
+        Chunks with an invalid crc32 are skipped.
+
+        """
+        while len(data := file.read(cls.CHUNK_HEADER.size)) == cls.CHUNK_HEADER.size:
+            magic, flags, records, length, crc, _first_timestamp = cls.CHUNK_HEADER.unpack(data)
+            if magic != cls.CHUNK_MAGIC:
+                raise ValueError(f'Invalid chunk at {file.tell() - len(data)}')
+            payload = file.read(length)
+            if len(payload) != length:
+                break # truncated chunk
+            if zlib.crc32(payload) != crc:
+                print(f'Skipping chunk with invalid crc at {file.tell() - length}', file=sys.stderr)
+                continue
+            if flags & cls.CHUNK_COMPRESSED:
+                payload = zlib.decompress(payload[4:])
+
+            offset = 0
+            for _ in range(records):
+                size, timestamp = cls.RECORD_HEADER.unpack_from(payload, offset)
+                offset += cls.RECORD_HEADER.size
+                yield (cls.format_timestamp(timestamp), payload[offset:offset + size])
+                offset += size
+
     def process(self):
         """ Process and store the entire file into self.messages. """
         self.messages.extend(self)
@@ -177,6 +219,9 @@ class Log:
         """
         with open(self.filename, "rb") as file:
             self.unpack_header(file)
+            if self.header.version >= 2:
+                yield from self.unpack_chunks(file)
+                return
             while True:
                 try:
                     yield self.unpack_message(file)
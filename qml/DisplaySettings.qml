@@ -87,6 +87,16 @@ ColumnLayout {
                     }
                 }
 
+                CheckBox {
+                    id: compressSensorLogsChB
+
+                    text: "Compress sensor logs"
+                    checked: SettingsManager.compressSensorLogs
+                    Layout.columnSpan: 5
+                    Layout.fillWidth: true
+                    onCheckedChanged: SettingsManager.compressSensorLogs = checked
+                }
+
                 CheckBox {
                     id: replayChB
 
@@ -98,14 +108,13 @@ ColumnLayout {
                 }
 
                 CheckBox {
-                    id: realTimeReplayChB
+                    id: renderProfilerChB
 
-                    text: "Enable real-time replay"
-                    checked: SettingsManager.realTimeReplay
-                    visible: SettingsManager.replayMenu
+                    text: "Show render profiler"
+                    checked: SettingsManager.renderProfiler
                     Layout.columnSpan: 5
                     Layout.fillWidth: true
-                    onCheckedChanged: SettingsManager.realTimeReplay = checked
+                    onCheckedChanged: SettingsManager.renderProfiler = checked
                 }
 
                 Loader {
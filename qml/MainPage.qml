@@ -258,6 +258,18 @@ Item {
                         replayStartBt.text = "▶";
 
                 }
+
+                // Summary of the log behind the slider, a column per second
+                Image {
+                    anchors.fill: parent
+                    z: -1
+                    visible: ping ? ping.link.overviewReady === true : false
+                    source: visible ? ping.link.overviewThumbnail : ""
+                    fillMode: Image.Stretch
+                    smooth: false
+                    cache: false
+                    opacity: 0.5
+                }
             }
 
             Text {
@@ -267,6 +279,25 @@ Item {
                 color: Material.primary
             }
 
+            ComboBox {
+                id: replaySpeedCB
+
+                // 0 plays as fast as possible
+                property var speeds: [0.25, 0.5, 1, 2, 4, 8, 16, 32, 0]
+
+                model: ["0.25x", "0.5x", "1x", "2x", "4x", "8x", "16x", "32x", "Max"]
+                currentIndex: Math.max(0, speeds.indexOf(SettingsManager.replaySpeed))
+                onActivated: SettingsManager.replaySpeed = speeds[index]
+            }
+
+            Text {
+                id: replayAchievedSpeed
+
+                visible: ping ? !ping.link.isWritable() : false
+                text: ping ? ping.link.achievedReplaySpeed.toFixed(2) + "x" : ""
+                color: Material.primary
+            }
+
             Text {
                 id: replayFileName
 
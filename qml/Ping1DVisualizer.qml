@@ -194,6 +194,25 @@ Item {
         id: readout
     }
 
+    Column {
+        anchors.top: parent.top
+        anchors.left: parent.left
+        anchors.margins: 10
+        spacing: 5
+        visible: SettingsManager.renderProfiler
+
+        RenderStatisticsOverlay {
+            title: "Waterfall"
+            source: waterfall
+        }
+
+        RenderStatisticsOverlay {
+            title: "Chart"
+            source: chart
+        }
+
+    }
+
     Component {
         id: displaySettings
 
@@ -326,6 +326,25 @@ Item {
 
     }
 
+    Column {
+        anchors.top: parent.top
+        anchors.left: parent.left
+        anchors.margins: 10
+        spacing: 5
+        visible: SettingsManager.renderProfiler
+
+        RenderStatisticsOverlay {
+            title: "Polar plot"
+            source: waterfall
+        }
+
+        RenderStatisticsOverlay {
+            title: "Chart"
+            source: chart
+        }
+
+    }
+
     Component {
         id: displaySettings
 
@@ -30,7 +30,7 @@ Item {
         contentWidth: parent.width
         clip: true
         flickableDirection: Flickable.HorizontalAndVerticalFlick
-        model: Logger.logModel.filteredModel
+        model: Logger.logModel
 
         // After we moved from StringListModel to our own "QQmlListModel"
         // We forgot to add the count signal to be able to do the scroll lock
@@ -0,0 +1,54 @@
+import QtQuick 2.15
+import QtQuick.Layouts 1.3
+
+Rectangle {
+    id: root
+
+    property string title: ""
+    // Item with the render statistics, they are only updated while the overlay is visible
+    property var source: null
+    // RenderStatistics summary, updated every second
+    property var statistics: source ? source.renderStatistics : ({
+    })
+    property int marginPix: 5
+
+    function format(key, precision) {
+        var value = statistics[key];
+        return typeof (value) == "number" ? value.toFixed(precision) : "-";
+    }
+
+    color: "black"
+    opacity: 0.75
+    height: innerCol.height + 2 * marginPix
+    width: innerCol.width + 2 * marginPix
+
+    Binding {
+        target: root.source
+        property: "renderStatisticsEnabled"
+        value: root.visible
+        when: root.source !== null
+    }
+
+    ColumnLayout {
+        id: innerCol
+
+        anchors.left: parent.left
+        anchors.top: parent.top
+        anchors.margins: marginPix
+        spacing: 0
+
+        Repeater {
+            model: [root.title, "FPS: " + format("fps", 1), "Paint (ms): " + format("paintMeanMs", 2) + " / " + format("paintMaxMs", 2) + " max", "Interval (ms): " + format("intervalMeanMs", 1) + " / " + format("intervalMaxMs", 1) + " max", "Jitter (ms): " + format("jitterMs", 1), "Delay max (ms): " + format("delayMaxMs", 1), "Late / skipped: " + format("lateFrames", 0) + " / " + format("skippedFrames", 0), "Profiles: " + format("profiles", 0) + " (" + format("profilesPerFrame", 1) + "/frame, " + format("maxProfilesPerFrame", 0) + " max)", "Merged profiles: " + format("mergedProfiles", 0), "Upload (KiB/s): " + format("uploadKiBps", 0)]
+
+            delegate: Text {
+                text: modelData
+                color: "white"
+                font.pointSize: 8
+                font.bold: index == 0
+            }
+
+        }
+
+    }
+
+}
@@ -0,0 +1,572 @@
+#include <ctime>
+#include <limits>
+
+#include <QApplication>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QtMath>
+
+#include "filemanager.h"
+#include "logtool/logexporter.h"
+#include "logfilereader.h"
+#include "logfilewriter.h"
+#include "logger.h"
+#include "ping.h"
+#include "ping360.h"
+#include "polarplot.h"
+#include "profilechart.h"
+#include "profilecodec.h"
+#include "settingsmanager.h"
+#include "waterfallgradient.h"
+#include "waterfallplot.h"
+
+#include "benchmark.h"
+
+#include "ping-message-ping1d.h"
+#include "ping-message-ping360.h"
+#include "ping-parser.h"
+
+PING_LOGGING_CATEGORY(PING_BENCHMARK, "ping.benchmark")
+
+namespace {
+/**
+ * @brief Return a profile with noise floor and a target
+ *
+ * @param numberOfPoints
+ * @param target
+ * @return QVector<double>
+ */
+QVector<double> createPoints(int numberOfPoints, int target)
+{
+    QVector<double> points(numberOfPoints);
+    for (int i = 0; i < numberOfPoints; i++) {
+        points[i] = qAbs(i - target) < 40 ? 0.8 : QRandomGenerator::global()->bounded(0.2);
+    }
+    return points;
+}
+
+/**
+ * @brief Return Ping360 device data messages with a moving target
+ *
+ * @param numberOfProfiles
+ * @return QVector<QByteArray>
+ */
+QVector<QByteArray> createProfiles(int numberOfProfiles)
+{
+    QVector<QByteArray> messages;
+    for (int i = 0; i < numberOfProfiles; i++) {
+        const QVector<double> points = createPoints(1200, 500 + i % 100);
+        ping360_device_data deviceData(points.size());
+        deviceData.set_angle(i % 400);
+        deviceData.set_number_of_samples(points.size());
+        deviceData.set_data_length(points.size());
+        for (int sample = 0; sample < points.size(); sample++) {
+            deviceData.set_data_at(sample, static_cast<uint8_t>(points[sample] * 255));
+        }
+        deviceData.updateChecksum();
+        messages.append(QByteArray(reinterpret_cast<const char*>(deviceData.msgData), deviceData.msgDataLength()));
+    }
+    return messages;
+}
+
+/**
+ * @brief Return log records with the size of Ping360 profiles
+ *
+ * @return QVector<QByteArray>
+ */
+QVector<QByteArray> createRecords()
+{
+    QVector<QByteArray> records;
+    for (int i = 0; i < 16; i++) {
+        QByteArray record(1220, Qt::Uninitialized);
+        for (int sample = 0; sample < record.size(); sample++) {
+            const int target = qAbs(sample - 500 - 10 * i) < 40 ? 200 : 0;
+            record[sample] = static_cast<char>(target + QRandomGenerator::global()->bounded(30));
+        }
+        records.append(record);
+    }
+    return records;
+}
+
+// Release builds define NDEBUG, results are only compared with a baseline of the same build type
+#ifdef NDEBUG
+const bool optimized = true;
+#else
+const bool optimized = false;
+#endif
+} // namespace
+
+void Benchmark::initTestCase()
+{
+    FileManager::self();
+    Logger::self()->installHandler();
+    SettingsManager::self();
+
+    if (qEnvironmentVariableIsSet("PING_BENCHMARK_MARGIN")) {
+        _margin = qEnvironmentVariable("PING_BENCHMARK_MARGIN").toFloat();
+    }
+
+    const QString baselineFileName = qEnvironmentVariable("PING_BENCHMARK_BASELINE");
+    if (baselineFileName.isEmpty()) {
+        return;
+    }
+
+    QFile baselineFile(baselineFileName);
+    if (!baselineFile.open(QIODevice::ReadOnly)) {
+        qCWarning(PING_BENCHMARK) << "No baseline available:" << baselineFileName;
+        return;
+    }
+    const QJsonObject baseline = QJsonDocument::fromJson(baselineFile.readAll()).object();
+    // Timings of debug and release builds can not be compared
+    if (baseline[QStringLiteral("optimized")].toBool() != optimized) {
+        qCWarning(PING_BENCHMARK) << "Baseline was measured with a different build type, it will be ignored:"
+                                  << baselineFileName;
+        return;
+    }
+    _baseline = baseline[QStringLiteral("results")].toObject();
+    qCInfo(PING_BENCHMARK) << "Comparing" << _baseline.size() << "benchmarks with a margin of" << _margin;
+}
+
+void Benchmark::cleanupTestCase()
+{
+    const QString outputFileName = qEnvironmentVariable("PING_BENCHMARK_OUTPUT");
+    if (outputFileName.isEmpty()) {
+        return;
+    }
+
+    QJsonObject output;
+    output[QStringLiteral("qt")] = QString(qVersion());
+    output[QStringLiteral("optimized")] = optimized;
+    output[QStringLiteral("results")] = _results;
+
+    QFile outputFile(outputFileName);
+    QVERIFY2(outputFile.open(QIODevice::WriteOnly | QIODevice::Truncate),
+        qPrintable(QString("Failed to write benchmark results: %1").arg(outputFileName)));
+    outputFile.write(QJsonDocument(output).toJson());
+}
+
+QString Benchmark::measure(const QString& name, qint64 itemsPerIteration, const std::function<void()>& function)
+{
+    static const qint64 minimumBatchNs = 20 * 1000 * 1000;
+    static const int numberOfBatches = 5;
+
+    // Warm up caches and lazy initializations
+    function();
+
+    QElapsedTimer timer;
+    int iterations = 1;
+    for (;;) {
+        timer.start();
+        for (int i = 0; i < iterations; i++) {
+            function();
+        }
+        if (timer.nsecsElapsed() >= minimumBatchNs) {
+            break;
+        }
+        iterations *= 2;
+    }
+
+    double bestNs = std::numeric_limits<double>::max();
+    for (int batch = 0; batch < numberOfBatches; batch++) {
+        timer.start();
+        for (int i = 0; i < iterations; i++) {
+            function();
+        }
+        bestNs = std::min(bestNs, timer.nsecsElapsed() / static_cast<double>(iterations));
+    }
+
+    const double itemsPerSecond = itemsPerIteration * 1e9 / bestNs;
+    _results[name] = QJsonObject {{"nsPerIteration", bestNs}, {"itemsPerSecond", itemsPerSecond}};
+    qCInfo(PING_BENCHMARK) << qPrintable(name) << bestNs << "ns," << itemsPerSecond << "items/s";
+
+    if (!_baseline.contains(name)) {
+        return {};
+    }
+
+    const double baselineNs = _baseline[name].toObject()[QStringLiteral("nsPerIteration")].toDouble();
+    if (baselineNs > 0 && bestNs > baselineNs * (1 + _margin)) {
+        return QStringLiteral("%1 regressed: %2 ns, baseline %3 ns").arg(name).arg(bestNs).arg(baselineNs);
+    }
+    return {};
+}
+
+void Benchmark::readLog(const QString& name, uint version)
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable("Failed to create temporary directory."));
+
+    const QString fileName = dir.filePath(QStringLiteral("log.bin"));
+    LogSensorStruct logSensorStruct;
+    logSensorStruct.init();
+    logSensorStruct.version = version;
+    const QVector<QByteArray> records = createRecords();
+    const int numberOfRecords = 10000;
+    {
+        LogFileWriter writer;
+        QVERIFY2(writer.open(fileName, logSensorStruct), qPrintable("Failed to create log."));
+        for (int i = 0; i < numberOfRecords; i++) {
+            writer.append(i * 20000000ll, records[i % records.size()]);
+        }
+    }
+
+    QFile file(fileName);
+    QVERIFY2(file.open(QIODevice::ReadOnly), qPrintable("Failed to open log."));
+    QDataStream stream(&file);
+    LogSensorStruct readLogSensorStruct;
+    stream >> readLogSensorStruct;
+    QVERIFY2(readLogSensorStruct.version == version, qPrintable("Wrong log version."));
+
+    LogFileReader reader;
+    QVERIFY2(reader.open(fileName, file.pos(), readLogSensorStruct.version), qPrintable("Failed to read log."));
+    QVERIFY2(reader.size() == numberOfRecords, qPrintable("Wrong number of records."));
+
+    qint64 readBytes = 0;
+    const QString regression = measure(name, numberOfRecords, [&] {
+        for (int i = 0; i < reader.size(); i++) {
+            readBytes += reader.data(i).size();
+        }
+    });
+    QVERIFY2(regression.isEmpty(), qPrintable(regression));
+}
+
+void Benchmark::writeLog(const QString& name, uint version)
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable("Failed to create temporary directory."));
+
+    LogSensorStruct logSensorStruct;
+    logSensorStruct.init();
+    logSensorStruct.version = version;
+    const QVector<QByteArray> records = createRecords();
+    const int numberOfRecords = 1000;
+
+    LogFileWriter writer;
+    const QString fileName = dir.filePath(QStringLiteral("log.bin"));
+    QVERIFY2(writer.open(fileName, logSensorStruct), qPrintable("Failed to create log."));
+    qint64 timestampNs = 0;
+    const QString regression = measure(name, numberOfRecords, [&] {
+        for (int i = 0; i < numberOfRecords; i++) {
+            writer.append(timestampNs, records[i % records.size()]);
+            timestampNs += 20000000;
+        }
+        writer.flush();
+    });
+    QVERIFY2(writer.statistics().droppedRecords == 0, qPrintable("Records were dropped."));
+    QVERIFY2(regression.isEmpty(), qPrintable(regression));
+}
+
+void Benchmark::gradient()
+{
+    const WaterfallGradient gradient(
+        QStringLiteral("Benchmark"), {Qt::black, Qt::blue, Qt::cyan, Qt::green, Qt::yellow, Qt::red});
+    const QVector<double> points = createPoints(1200, 600);
+
+    QRgb checksum = 0;
+    const QString regression = measure(QStringLiteral("gradient"), points.size(), [&] {
+        for (const double point : points) {
+            checksum ^= gradient.getColor(point).rgb();
+        }
+    });
+    QVERIFY2(regression.isEmpty(), qPrintable(regression));
+    Q_UNUSED(checksum)
+}
+
+void Benchmark::logCompression()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable("Failed to create temporary directory."));
+
+    // One minute of Ping360 at 133 profiles per second
+    LogSensorStruct logSensorStruct;
+    logSensorStruct.init();
+    const QVector<QByteArray> records = createRecords();
+    const int numberOfRecords = 133 * 60;
+    const qint64 periodNs = 1000 * 1000 * 1000 / 133;
+
+    LogFileWriter writer;
+    writer.setCompression(true);
+    const QString fileName = dir.filePath(QStringLiteral("log.bin"));
+    QVERIFY2(writer.open(fileName, logSensorStruct), qPrintable("Failed to create log."));
+    for (int i = 0; i < numberOfRecords; i++) {
+        writer.append(i * periodNs, records[i % records.size()]);
+    }
+    writer.close();
+
+    const auto statistics = writer.statistics();
+    QVERIFY2(statistics.droppedRecords == 0 && statistics.rawBytes > 0, qPrintable("Records were not written."));
+    const double hours = numberOfRecords * periodNs / (3600 * 1e9);
+    const double savedMegabytesPerHour = (statistics.rawBytes - statistics.storedBytes) / (1024.0 * 1024.0) / hours;
+    const double compressionSecondsPerHour = statistics.compressionNs / 1e9 / hours;
+    _results[QStringLiteral("logCompression")] = QJsonObject {
+        {"savedMegabytesPerHour", savedMegabytesPerHour},
+        {"compressionSecondsPerHour", compressionSecondsPerHour},
+        {"storedPercentage", 100.0 * statistics.storedBytes / statistics.rawBytes},
+    };
+    qCInfo(PING_BENCHMARK).noquote() << QStringLiteral("logCompression: %1 MB saved and %2 s of compression per hour")
+                                            .arg(savedMegabytesPerHour, 0, 'f', 1)
+                                            .arg(compressionSecondsPerHour, 0, 'f', 2);
+}
+
+void Benchmark::logExport()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable("Failed to create temporary directory."));
+
+    // Ten seconds of Ping360 profiles, exported as the logtool does for each log
+    LogSensorStruct logSensorStruct;
+    logSensorStruct.init();
+    const QVector<QByteArray> profiles = createProfiles(1330);
+    const qint64 periodNs = 1000 * 1000 * 1000 / 133;
+
+    const QString fileName = dir.filePath(QStringLiteral("log.bin"));
+    {
+        LogFileWriter writer;
+        QVERIFY2(writer.open(fileName, logSensorStruct), qPrintable("Failed to create log."));
+        for (int i = 0; i < profiles.size(); i++) {
+            writer.append(i * periodNs, profiles[i]);
+        }
+    }
+    const qint64 logBytes = QFileInfo(fileName).size();
+
+    // Throughput is reported in log bytes per second, as printed by pingviewer-logtool
+    QJsonObject throughput;
+    for (const auto& format : QVector<QPair<LogExporter::Format, QString>> {
+             {LogExporter::Format::Npy, QStringLiteral("Npy")},
+             {LogExporter::Format::Csv, QStringLiteral("Csv")},
+         }) {
+        const QString outputDirectory = dir.filePath(format.second);
+        QVERIFY2(QDir().mkpath(outputDirectory), qPrintable("Failed to create output directory."));
+
+        bool ok = true;
+        int exportedProfiles = 0;
+        const QString name = QStringLiteral("logExport%1").arg(format.second);
+        const QString regression = measure(name, logBytes, [&] {
+            const LogExporter::Result result = LogExporter::exportLog(fileName, outputDirectory, format.first);
+            ok &= result.ok;
+            exportedProfiles = result.profiles;
+        });
+        QVERIFY2(ok && exportedProfiles == profiles.size(), qPrintable(QString("%1 failed.").arg(name)));
+
+        const double megabytesPerSecond = _results[name].toObject()[QStringLiteral("itemsPerSecond")].toDouble()
+            / (1024.0 * 1024.0);
+        throughput[format.second.toLower()] = megabytesPerSecond;
+        qCInfo(PING_BENCHMARK).noquote()
+            << QStringLiteral("%1: %2 MB/s").arg(name).arg(megabytesPerSecond, 0, 'f', 1);
+        QVERIFY2(regression.isEmpty(), qPrintable(regression));
+    }
+    _results[QStringLiteral("logExportMegabytesPerSecond")] = throughput;
+}
+
+void Benchmark::logRead() { readLog(QStringLiteral("logRead"), 2); }
+
+void Benchmark::logReadV1() { readLog(QStringLiteral("logReadV1"), 1); }
+
+void Benchmark::logWrite() { writeLog(QStringLiteral("logWrite"), 2); }
+
+void Benchmark::logWriteV1() { writeLog(QStringLiteral("logWriteV1"), 1); }
+
+void Benchmark::parser()
+{
+    // Profiles as they arrive from a ping1d
+    QByteArray data;
+    const int numberOfMessages = 100;
+    for (int i = 0; i < numberOfMessages; i++) {
+        ping1d_profile profile(200);
+        profile.set_distance(1000 + i);
+        profile.set_profile_data_length(200);
+        for (int point = 0; point < 200; point++) {
+            profile.set_profile_data_at(point, QRandomGenerator::global()->bounded(256));
+        }
+        profile.updateChecksum();
+        data.append(reinterpret_cast<const char*>(profile.msgData), profile.msgDataLength());
+    }
+
+    PingParser parser(10240);
+    int parsedMessages = 0;
+    const QString regression = measure(QStringLiteral("parser"), data.size(), [&] {
+        for (const auto byte : data) {
+            parsedMessages += parser.parseByte(byte) == PingParser::ParseState::NEW_MESSAGE;
+        }
+    });
+    QVERIFY2(parsedMessages % numberOfMessages == 0, qPrintable("Messages were not parsed."));
+    QVERIFY2(regression.isEmpty(), qPrintable(regression));
+}
+
+void Benchmark::polarPlot()
+{
+    PolarPlot plot;
+    QVector<QVector<double>> profiles;
+    for (int i = 0; i < 8; i++) {
+        profiles.append(createPoints(1200, 500 + 10 * i));
+    }
+
+    int angle = 0;
+    const QString regression = measure(QStringLiteral("polarPlot"), 1, [&] {
+        plot.draw(profiles[angle % profiles.size()], angle, 0, 50, 1, 360);
+        angle = (angle + 1) % 400;
+    });
+    QVERIFY2(regression.isEmpty(), qPrintable(regression));
+}
+
+void Benchmark::profileChart()
+{
+    const QVector<double> profile = createPoints(1200, 600);
+    const QVector<float> points(profile.cbegin(), profile.cend());
+    // Rows of a chart in a full HD display
+    QVector<float> rowMinimums(1000);
+    QVector<float> rowMaximums(1000);
+    const QString regression = measure(QStringLiteral("profileChart"), points.size(),
+        [&] { ProfileChart::decimate(points, 0, 50, 0, 50, rowMinimums, rowMaximums); });
+    QVERIFY2(regression.isEmpty(), qPrintable(regression));
+}
+
+void Benchmark::profileCodec()
+{
+    // Messages of a recorded log when available, otherwise simulated Ping360 profiles
+    QVector<QByteArray> messages;
+    const QString logFileName = qEnvironmentVariable("PING_BENCHMARK_PROFILE_LOG");
+    if (!logFileName.isEmpty()) {
+        QFile file(logFileName);
+        QVERIFY2(file.open(QIODevice::ReadOnly), qPrintable(QString("Failed to open log: %1").arg(logFileName)));
+        QDataStream stream(&file);
+        LogSensorStruct logSensorStruct;
+        stream >> logSensorStruct;
+
+        LogFileReader reader;
+        QVERIFY2(reader.open(logFileName, file.pos(), logSensorStruct.version), qPrintable("Failed to read log."));
+        PingParser parser(10240);
+        for (int i = 0; i < reader.size(); i++) {
+            for (const auto byte : reader.data(i)) {
+                if (parser.parseByte(byte) == PingParser::ParseState::NEW_MESSAGE) {
+                    messages.append(QByteArray(reinterpret_cast<const char*>(parser.rxMessage.msgData),
+                        parser.rxMessage.msgDataLength()));
+                }
+            }
+        }
+    } else {
+        messages = createProfiles(400);
+    }
+    QVERIFY2(!messages.isEmpty(), qPrintable("No messages to encode."));
+
+    qint64 rawBytes = 0;
+    for (const auto& message : messages) {
+        rawBytes += message.size();
+    }
+
+    // Encoding and decoding throughput are reported in raw bytes per second
+    QJsonObject ratios;
+    for (const auto& level : QVector<QPair<ProfileCodec::Level, QString>> {
+             {ProfileCodec::Level::Lossless, QStringLiteral("Lossless")},
+             {ProfileCodec::Level::Quantized, QStringLiteral("Quantized")},
+             {ProfileCodec::Level::Decimated, QStringLiteral("Decimated")},
+         }) {
+        QVector<QByteArray> frames;
+        qint64 encodedBytes = 0;
+        for (const auto& message : messages) {
+            frames.append(ProfileCodec::encode(message, level.first));
+            encodedBytes += frames.last().size();
+        }
+        const double ratio = static_cast<double>(rawBytes) / encodedBytes;
+        ratios[level.second.toLower()] = ratio;
+        qCInfo(PING_BENCHMARK) << qPrintable(QStringLiteral("profileCodec%1").arg(level.second)) << "compression ratio"
+                               << ratio;
+
+        qint64 outputBytes = 0;
+        QString regression = measure(QStringLiteral("profileEncode%1").arg(level.second), rawBytes, [&] {
+            for (const auto& message : messages) {
+                outputBytes += ProfileCodec::encode(message, level.first).size();
+            }
+        });
+        QVERIFY2(regression.isEmpty(), qPrintable(regression));
+
+        regression = measure(QStringLiteral("profileDecode%1").arg(level.second), rawBytes, [&] {
+            for (const auto& frame : frames) {
+                outputBytes += ProfileCodec::decode(frame).size();
+            }
+        });
+        QVERIFY2(outputBytes > 0, qPrintable("Nothing was encoded."));
+        QVERIFY2(regression.isEmpty(), qPrintable(regression));
+    }
+    _results[QStringLiteral("profileCodecRatio")] = ratios;
+}
+
+void Benchmark::sensors()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable("Failed to create temporary directory."));
+
+    // Sensors use their default rates, Ping360 profiles are requested as fast as the simulation answers
+    auto run = [&dir, this](const QString& name, bool withPing1d, bool withPing360) {
+        QVector<QSharedPointer<PingSensor>> sensors;
+        if (withPing1d) {
+            sensors.append(QSharedPointer<PingSensor>(new Ping()));
+            sensors.last()->connectLink({LinkType::Ping1DSimulation, {}, "Ping1D"},
+                {LinkType::File, {dir.filePath(name + QStringLiteral("_ping1d.bin")), "w"}, "Log"});
+        }
+        if (withPing360) {
+            sensors.append(QSharedPointer<PingSensor>(new Ping360()));
+            sensors.last()->connectLink({LinkType::Ping360Simulation, {}, "Ping360"},
+                {LinkType::File, {dir.filePath(name + QStringLiteral("_ping360.bin")), "w"}, "Log"});
+        }
+
+        // Process CPU time, it includes the parser threads of the sensors
+        QElapsedTimer elapsed;
+        elapsed.start();
+        const std::clock_t start = std::clock();
+        QTest::qWait(3000);
+        const double cpuSeconds = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+        const double cpuPercentage = 100 * cpuSeconds / (elapsed.elapsed() / 1e3);
+
+        int messages = 0;
+        for (const auto& sensor : sensors) {
+            messages += sensor->parsedMsgs();
+            sensor->disconnectLink();
+        }
+        _results[name] = QJsonObject {{"cpuPercentage", cpuPercentage}, {"messages", messages}};
+        qCInfo(PING_BENCHMARK).noquote() << QStringLiteral("%1: %2% of a core, %3 messages")
+                                                .arg(name)
+                                                .arg(cpuPercentage, 0, 'f', 1)
+                                                .arg(messages);
+        return messages;
+    };
+
+    QVERIFY2(run(QStringLiteral("sensorsPing1d"), true, false) > 0, qPrintable("Ping1D sent no messages."));
+    QVERIFY2(run(QStringLiteral("sensorsPing360"), false, true) > 0, qPrintable("Ping360 sent no messages."));
+    QVERIFY2(run(QStringLiteral("sensorsTogether"), true, true) > 0, qPrintable("Sensors sent no messages."));
+}
+
+void Benchmark::settings()
+{
+    auto settingsManager = SettingsManager::self();
+    int change = 0;
+    const QString regression = measure(QStringLiteral("settings"), 1, [&] {
+        settingsManager->replaySpeed(change++ % 2 ? 2 : 1);
+    });
+    settingsManager->replaySpeed(1);
+    settingsManager->settings().sync();
+    QVERIFY2(regression.isEmpty(), qPrintable(regression));
+}
+
+void Benchmark::waterfallPlot()
+{
+    WaterfallPlot plot;
+    QVector<QVector<double>> profiles;
+    for (int i = 0; i < 8; i++) {
+        profiles.append(createPoints(200, 100 + i));
+    }
+
+    int index = 0;
+    const QString regression = measure(QStringLiteral("waterfallPlot"), 1, [&] {
+        plot.draw(profiles[index % profiles.size()], 100, 0, 50, 25);
+        index++;
+    });
+    QVERIFY2(regression.isEmpty(), qPrintable(regression));
+}
+
+QTEST_MAIN(Benchmark)
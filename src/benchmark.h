@@ -0,0 +1,146 @@
+#include <functional>
+
+#include <QJsonObject>
+#include <QtTest/QtTest>
+
+/**
+ * @brief Benchmarks of the application hot paths
+ *  Results are written as JSON to PING_BENCHMARK_OUTPUT.
+ *  When PING_BENCHMARK_BASELINE points to a previous result, a benchmark fails if it is slower
+ *  than the baseline by more than PING_BENCHMARK_MARGIN (0.25 by default).
+ */
+class Benchmark : public QObject {
+    Q_OBJECT
+private slots:
+    /**
+     * @brief Initialize what is necessary and load the baseline
+     *
+     */
+    void initTestCase();
+
+    /**
+     * @brief Write the results
+     *
+     */
+    void cleanupTestCase();
+
+    /**
+     * @brief Benchmark gradient colorization
+     *
+     */
+    void gradient();
+
+    /**
+     * @brief Report the bytes saved and the compression CPU time per recorded hour of Ping360 profiles
+     *  Reported in the results, the CPU time is not compared with the baseline
+     *
+     */
+    void logCompression();
+
+    /**
+     * @brief Benchmark the NPY and CSV export of the logtool, reported in log megabytes per second
+     *
+     */
+    void logExport();
+
+    /**
+     * @brief Benchmark log reading
+     *
+     */
+    void logRead();
+
+    /**
+     * @brief Benchmark reading of v1 logs
+     *
+     */
+    void logReadV1();
+
+    /**
+     * @brief Benchmark log writing
+     *
+     */
+    void logWrite();
+
+    /**
+     * @brief Benchmark writing of v1 logs
+     *
+     */
+    void logWriteV1();
+
+    /**
+     * @brief Benchmark ping protocol parser
+     *
+     */
+    void parser();
+
+    /**
+     * @brief Benchmark polar plot drawing
+     *
+     */
+    void polarPlot();
+
+    /**
+     * @brief Benchmark profile chart decimation
+     *
+     */
+    void profileChart();
+
+    /**
+     * @brief Report the compression ratio and benchmark encoding and decoding of each profile level
+     *  Profiles of the sensor log in PING_BENCHMARK_PROFILE_LOG are used when it is set
+     *
+     */
+    void profileCodec();
+
+    /**
+     * @brief Measure the CPU used by simulated Ping1D and Ping360 sensors, alone and together
+     *  Reported in the results, it depends on the load of the machine and is not compared with the baseline
+     *
+     */
+    void sensors();
+
+    /**
+     * @brief Benchmark settings writes
+     *
+     */
+    void settings();
+
+    /**
+     * @brief Benchmark waterfall plot drawing
+     *
+     */
+    void waterfallPlot();
+
+private:
+    /**
+     * @brief Measure the time of a function and compare it with the baseline
+     *  The function runs in batches until each batch takes some milliseconds,
+     *  the fastest batch is used to reduce the noise of other processes.
+     *
+     * @param name
+     * @param itemsPerIteration number of items processed by each call, used to report the throughput
+     * @param function
+     * @return QString empty when there is no regression
+     */
+    QString measure(const QString& name, qint64 itemsPerIteration, const std::function<void()>& function);
+
+    /**
+     * @brief Benchmark reading a log of a version
+     *
+     * @param name
+     * @param version
+     */
+    void readLog(const QString& name, uint version);
+
+    /**
+     * @brief Benchmark writing a log of a version
+     *
+     * @param name
+     * @param version
+     */
+    void writeLog(const QString& name, uint version);
+
+    QJsonObject _baseline;
+    float _margin = 0.25;
+    QJsonObject _results;
+};
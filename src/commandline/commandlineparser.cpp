@@ -4,12 +4,16 @@
 
 PING_LOGGING_CATEGORY(COMMANDLINEPARSER, "ping.commandlineparser");
 
+const QCommandLineOption CommandLineParser::_headlessOption {
+    "headless", "Run without interface, connecting and logging the sensor given by --connect or the first one found."};
+
 CommandLineParser::CommandLineParser(const QCoreApplication& app)
     : QCommandLineParser()
 {
     setApplicationDescription("Graphical user interface for the Blue Robotics Ping1D and Ping360.");
     addHelpOption();
     addVersionOption();
+    addOption(_headlessOption);
 
     for (const auto& optionStruct : _optionsStruct) {
         addOption(optionStruct.option);
@@ -28,3 +32,13 @@ CommandLineParser::CommandLineParser(const QCoreApplication& app)
         }
     }
 };
+
+bool CommandLineParser::isHeadless(int argc, char* argv[])
+{
+    for (int i {1}; i < argc; i++) {
+        if (qstrcmp(argv[i], "--headless") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -26,13 +26,36 @@ public:
      */
     ~CommandLineParser() = default;
 
+    /**
+     * @brief Check if the application should run without interface
+     *  This is done before the application is created, since it defines the application type
+     *
+     * @param argc
+     * @param argv
+     * @return true
+     * @return false
+     */
+    static bool isHeadless(int argc, char* argv[]);
+
 private:
+    static const QCommandLineOption _headlessOption;
+
     struct OptionStruct {
         QCommandLineOption option;
         std::function<void(const QString&)> function;
     };
 
+    // Options are applied in this order, the forward link is used by the sensor given by --connect
     QList<OptionStruct> _optionsStruct {
+        {
+            {{"forward", "f"}, "Forward the sensor messages to an UDP link, compressing the profiles.",
+                "connectionString"},
+            [](const QString& result) {
+                LinkConfiguration forwardConfiguration {result};
+                forwardConfiguration.setName(QStringLiteral("Forward"));
+                DeviceManager::self()->setForwardConfiguration(forwardConfiguration);
+            },
+        },
         {
             {{"connect", "c"}, "Connect directly with the input.", "connectionString"
 #if defined(PING360_SPEED_TEST)
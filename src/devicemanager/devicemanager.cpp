@@ -1,3 +1,4 @@
+#include <QPointer>
 #include <QQmlEngine>
 
 #include "devicemanager.h"
@@ -96,19 +97,111 @@ void DeviceManager::connectLink(LinkConfiguration* linkConf)
     _sensors[Name][objIndex] = PingHelper::nameFromDeviceType(linkConf->deviceType());
     qCDebug(DEVICEMANAGER) << "Connecting with sensor:" << _sensors[Name][objIndex].toString() << *linkConf;
 
-    // We could use a single Ping instance, but since we are going to support multiple devices
-    // this pointer will hold everything for us
-    if (linkConf->deviceType() == PingDeviceType::PING1D) {
-        _primarySensor.reset(new Ping());
-    } else {
-        _primarySensor.reset(new Ping360());
+    // Each connection has its own sensor, connecting again with the same link reuses it
+    QSharedPointer<Sensor> sensor;
+    for (int i {0}; i < _connectedSensors.size(); i++) {
+        const auto link = _connectedSensors[i]->link();
+        if (link && *link->configuration() == *linkConf) {
+            if (link->configuration()->deviceType() == linkConf->deviceType()) {
+                sensor = _connectedSensors[i];
+            } else {
+                disconnectSensor(i);
+            }
+            break;
+        }
     }
 
+    if (!sensor) {
+        if (linkConf->deviceType() == PingDeviceType::PING1D) {
+            sensor.reset(new Ping());
+        } else {
+            sensor.reset(new Ping360());
+        }
+
+        // Sensors that are unplugged are dropped, so the detectors can find and connect them again
+        connect(
+            sensor.get(), &Sensor::connectionClose, this,
+            [this, lostSensor = QPointer<Sensor>(sensor.get())] {
+                const int index = indexOfSensor(lostSensor);
+                if (!_autoConnect || index < 0) {
+                    return;
+                }
+                qCWarning(DEVICEMANAGER) << "Connection with sensor lost:" << lostSensor->name();
+                disconnectSensor(index);
+                startDetecting();
+            },
+            Qt::QueuedConnection);
+
+        _connectedSensors.append(sensor);
+        emit sensorsChanged();
+    }
+
+    _primarySensor = sensor;
     emit primarySensorChanged();
     _primarySensor->connectLink(*linkConf);
+    if (_forwardConfiguration.type() != LinkType::None) {
+        _primarySensor->connectLinkForward(_forwardConfiguration);
+    }
     _sensors[Connected][objIndex] = true;
 }
 
+QVariantList DeviceManager::sensors() const
+{
+    QVariantList sensors;
+    for (const auto& sensor : _connectedSensors) {
+        sensors.append(QVariant::fromValue(sensor.get()));
+    }
+    return sensors;
+}
+
+int DeviceManager::indexOfSensor(const Sensor* sensor) const
+{
+    for (int i {0}; i < _connectedSensors.size(); i++) {
+        if (_connectedSensors[i].get() == sensor) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void DeviceManager::setPrimarySensor(int index)
+{
+    if (index < 0 || index >= _connectedSensors.size() || _primarySensor == _connectedSensors[index]) {
+        return;
+    }
+
+    _primarySensor = _connectedSensors[index];
+    emit primarySensorChanged();
+}
+
+void DeviceManager::disconnectSensor(int index)
+{
+    if (index < 0 || index >= _connectedSensors.size()) {
+        return;
+    }
+
+    const QSharedPointer<Sensor> sensor = _connectedSensors.takeAt(index);
+    qCDebug(DEVICEMANAGER) << "Disconnecting sensor:" << sensor->name();
+    if (sensor->link()) {
+        for (int i {0}; i < _sensors[Connection].size(); i++) {
+            const auto sensorLinkConf = _sensors[Connection][i].value<QSharedPointer<LinkConfiguration>>();
+            if (*sensorLinkConf == *sensor->link()->configuration()) {
+                _sensors[Connected][i] = false;
+                const auto indexRow = this->index(i);
+                emit dataChanged(indexRow, indexRow, _roles);
+            }
+        }
+    }
+    // The link is closed now, the sensor may still be used by the interface until it is released
+    sensor->disconnectLink();
+
+    if (_primarySensor == sensor) {
+        _primarySensor = _connectedSensors.isEmpty() ? nullptr : _connectedSensors.last();
+        emit primarySensorChanged();
+    }
+    emit sensorsChanged();
+}
+
 void DeviceManager::connectLinkDirectly(const LinkConfiguration& linkConfiguration)
 {
     if (linkConfiguration.deviceType() == PingEnumNamespace::PingDeviceType::UNKNOWN) {
@@ -165,6 +258,12 @@ void DeviceManager::updateAvailableConnections(
     for (const auto& link : availableLinkConfigurations) {
         append(link, PingHelper::nameFromDeviceType(link.deviceType()), detector);
     }
+
+    if (_autoConnect && _connectedSensors.isEmpty() && !availableLinkConfigurations.isEmpty()) {
+        LinkConfiguration linkConfiguration = availableLinkConfigurations.first();
+        qCInfo(DEVICEMANAGER) << "Connecting with the first available sensor:" << linkConfiguration;
+        connectLink(&linkConfiguration);
+    }
 }
 
 void DeviceManager::clear()
@@ -3,6 +3,7 @@
 #include <QAbstractListModel>
 #include <QLoggingCategory>
 #include <QThread>
+#include <QVector>
 
 #include "abstractlinknamespace.h"
 #include "ping360helperservice.h"
@@ -55,7 +56,8 @@ public:
 
     /**
      * @brief Create a sensor object with the desired link configuration
-     *  This sensor object will be available via primarySensor
+     *  This sensor object will be available via primarySensor and sensors,
+     *  other connected sensors continue to run.
      *
      * @param linkConf
      */
@@ -149,16 +151,59 @@ public:
     QVariant primarySensor() const { return QVariant::fromValue(_primarySensor.get()); }
     Q_PROPERTY(QVariant primarySensor READ primarySensor NOTIFY primarySensorChanged)
 
+    /**
+     * @brief Return all connected sensors
+     *  Each sensor has its own link, parser thread, state and visualizer
+     *
+     * @return QVariantList
+     */
+    QVariantList sensors() const;
+    Q_PROPERTY(QVariantList sensors READ sensors NOTIFY sensorsChanged)
+
+    /**
+     * @brief Use a connected sensor as the primary sensor
+     *
+     * @param index position in sensors
+     */
+    Q_INVOKABLE void setPrimarySensor(int index);
+
+    /**
+     * @brief Close the link of a sensor and remove it from the connected sensors
+     *
+     * @param index position in sensors
+     */
+    Q_INVOKABLE void disconnectSensor(int index);
+
     /**
      * @brief Remove all found items and create a clear model once again
      *
      */
     Q_INVOKABLE void clear();
 
+    /**
+     * @brief Connect with the first available sensor found by the detectors when there is no connected sensor
+     *  A sensor that loses its connection is dropped and the detectors search again.
+     *  Used when running without interface
+     *
+     * @param autoConnect
+     */
+    void setAutoConnect(bool autoConnect) { _autoConnect = autoConnect; };
+
+    /**
+     * @brief Forward the messages of the sensors that are connected after it to an UDP link
+     *
+     * @param forwardConfiguration
+     */
+    void setForwardConfiguration(const LinkConfiguration& forwardConfiguration)
+    {
+        _forwardConfiguration = forwardConfiguration;
+    };
+
 signals:
     void countChanged();
     void sensorChanged(int objIndex);
     void primarySensorChanged();
+    void sensorsChanged();
 
 private:
     Q_DISABLE_COPY(DeviceManager)
@@ -178,6 +223,14 @@ private:
     void updateAvailableConnections(
         const QVector<LinkConfiguration>& availableLinkConfigurations, const QString& detectorName);
 
+    /**
+     * @brief Return the position of a sensor in sensors
+     *
+     * @param sensor
+     * @return int -1 when it is not connected
+     */
+    int indexOfSensor(const Sensor* sensor) const;
+
     // Role and names
     enum Roles {
         Available = 0,
@@ -194,6 +247,9 @@ private:
         {DetectorName, "detectorName"},
     };
 
+    bool _autoConnect = false;
+    QVector<QSharedPointer<Sensor>> _connectedSensors;
+    LinkConfiguration _forwardConfiguration;
     QSharedPointer<Sensor> _primarySensor;
     ProtocolDetector* _detector;
     QThread _detectorThread;
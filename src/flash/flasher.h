@@ -1,15 +1,19 @@
 #pragma once
 
+#include "intelhex.h"
 #include "linkconfiguration.h"
 
 #include <QLoggingCategory>
-#include <QProcess>
+#include <QThread>
+
+#include <memory>
 
 Q_DECLARE_LOGGING_CATEGORY(FLASH)
 
 /**
  * @brief Manage the project Flasher
- *
+ *  The firmware is written through the STM32 serial bootloader from a worker thread,
+ *  the state and progress are updated in the thread of the flasher.
  */
 class Flasher : public QObject {
     Q_OBJECT
@@ -25,7 +29,7 @@ public:
      * @brief Destroy the Flasher object
      *
      */
-    ~Flasher() = default;
+    ~Flasher();
 
     /**
      * @brief Defines flash state
@@ -74,7 +78,7 @@ public:
 
     /**
      * @brief Start the flash procedure
-     *
+     *  Does nothing if a flash procedure is already running
      */
     void flash();
 
@@ -86,9 +90,11 @@ public:
     bool setBaudRate(int baudRate);
 
     /**
-     * @brief Set the binary path
+     * @brief Load the firmware image from an Intel HEX file
      *
      * @param firmwareFilePath
+     * @return true
+     * @return false when the file does not have a valid Intel HEX format
      */
     bool setFirmwarePath(const QString& firmwareFilePath);
 
@@ -112,16 +118,14 @@ signals:
     void stateChanged(Flasher::States state);
 
 private:
-    void firmwareUpdatePercentage(const QString& output);
-    static QString stm32flashPath();
+    void run();
 
     int _baudRate = 57600;
-    QString _binRelativePath;
-    QString _firmwareFilePath;
-    QSharedPointer<QProcess> _firmwareProcess;
+    IntelHex _firmware;
     LinkConfiguration _link;
     QString _message;
     States _state = Idle;
+    std::unique_ptr<QThread> _thread;
     const QList<int> _validBaudRates = {57600, 115200, 230400};
     bool _verify = true;
 };
@@ -0,0 +1,154 @@
+#include <algorithm>
+
+#include <QFile>
+
+#include "intelhex.h"
+#include "logger.h"
+
+PING_LOGGING_CATEGORY(INTEL_HEX, "ping.intelhex")
+
+namespace {
+enum RecordType {
+    Data = 0x00,
+    EndOfFile = 0x01,
+    ExtendedSegmentAddress = 0x02,
+    StartSegmentAddress = 0x03,
+    ExtendedLinearAddress = 0x04,
+    StartLinearAddress = 0x05,
+};
+} // namespace
+
+bool IntelHex::load(const QString& fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(INTEL_HEX) << "Not possible to open the file:" << fileName;
+        return false;
+    }
+
+    return parse(file.readAll());
+}
+
+bool IntelHex::parse(const QByteArray& content)
+{
+    _segments.clear();
+
+    // Line Format:
+    //      :AABBBBCCnXDD
+    // AA: Byte count
+    // BBBB: Address
+    // CC: Record type
+    // nX: n characters, where n is AA*2
+    // DD: Checksum byte, the sum of all bytes is zero
+    quint32 baseAddress = 0;
+    int lineNumber = 0;
+    for (const QByteArray& rawLine : content.split('\n')) {
+        lineNumber++;
+        const QByteArray line = rawLine.trimmed();
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        auto error = [&lineNumber, &line](const char* text) {
+            qCWarning(INTEL_HEX) << "Invalid record in line" << lineNumber << ":" << line;
+            qCWarning(INTEL_HEX) << text;
+            return false;
+        };
+
+        if (line[0] != ':' || line.size() < 11 || line.size() % 2 == 0) {
+            return error("No valid record format.");
+        }
+
+        const QByteArray hex = line.mid(1);
+        const bool validCharacters = std::all_of(hex.cbegin(), hex.cend(), [](char character) {
+            return (character >= '0' && character <= '9') || (character >= 'a' && character <= 'f')
+                || (character >= 'A' && character <= 'F');
+        });
+        if (!validCharacters) {
+            return error("No valid hexadecimal value.");
+        }
+
+        const QByteArray bytes = QByteArray::fromHex(hex);
+        const int byteCount = static_cast<quint8>(bytes[0]);
+        // (Byte Count) 1, (Address) 2, (Record type) 1, (Checksum) 1
+        if (byteCount != bytes.size() - 5) {
+            return error("Byte count does not match with line size.");
+        }
+
+        quint8 checksum = 0;
+        for (const char byte : bytes) {
+            checksum += static_cast<quint8>(byte);
+        }
+        if (checksum) {
+            return error("No valid checksum.");
+        }
+
+        const quint16 address = (static_cast<quint8>(bytes[1]) << 8) | static_cast<quint8>(bytes[2]);
+        const QByteArray data = bytes.mid(4, byteCount);
+        switch (static_cast<quint8>(bytes[3])) {
+        case Data: {
+            const quint32 dataAddress = baseAddress + address;
+            if (!_segments.isEmpty()
+                && _segments.last().address + static_cast<quint32>(_segments.last().data.size()) == dataAddress) {
+                _segments.last().data.append(data);
+            } else {
+                _segments.append({dataAddress, data});
+            }
+            break;
+        }
+        case EndOfFile:
+            break;
+        case ExtendedSegmentAddress:
+        case ExtendedLinearAddress:
+            if (byteCount != 2) {
+                return error("No valid extended address.");
+            }
+            baseAddress = ((static_cast<quint8>(data[0]) << 8) | static_cast<quint8>(data[1]))
+                << (bytes[3] == ExtendedLinearAddress ? 16 : 4);
+            break;
+        case StartSegmentAddress:
+        case StartLinearAddress:
+            // The application is started from the beginning of the flash
+            break;
+        default:
+            return error("Unknown record type.");
+        }
+    }
+
+    // Records can be in any order
+    std::sort(_segments.begin(), _segments.end(),
+        [](const Segment& first, const Segment& second) { return first.address < second.address; });
+    QVector<Segment> segments;
+    for (const auto& segment : qAsConst(_segments)) {
+        if (!segments.isEmpty()) {
+            const quint32 end = segments.last().address + segments.last().data.size();
+            if (segment.address < end) {
+                qCWarning(INTEL_HEX) << "Overlapping data at address:" << Qt::hex << segment.address;
+                _segments.clear();
+                return false;
+            }
+            if (segment.address == end) {
+                segments.last().data.append(segment.data);
+                continue;
+            }
+        }
+        segments.append(segment);
+    }
+    _segments = segments;
+
+    if (_segments.isEmpty()) {
+        qCWarning(INTEL_HEX) << "File does not contain data.";
+        return false;
+    }
+
+    return true;
+}
+
+qint64 IntelHex::size() const
+{
+    qint64 size = 0;
+    for (const auto& segment : _segments) {
+        size += segment.data.size();
+    }
+    return size;
+}
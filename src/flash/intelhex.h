@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QByteArray>
+#include <QLoggingCategory>
+#include <QString>
+#include <QVector>
+
+Q_DECLARE_LOGGING_CATEGORY(INTEL_HEX)
+
+/**
+ * @brief Memory image of an Intel HEX file
+ *  Records are validated and merged in contiguous segments when the file is parsed,
+ *  data, end of file and extended segment or linear address records are supported.
+ *  For more information:
+ *    https://en.wikipedia.org/wiki/Intel_HEX
+ */
+class IntelHex {
+public:
+    /**
+     * @brief Contiguous memory region
+     *
+     */
+    struct Segment {
+        quint32 address;
+        QByteArray data;
+    };
+
+    /**
+     * @brief Parse an Intel HEX file
+     *
+     * @param fileName
+     * @return true
+     * @return false when the file can't be read or contains an invalid record
+     */
+    bool load(const QString& fileName);
+
+    /**
+     * @brief Parse the content of an Intel HEX file
+     *
+     * @param content
+     * @return true
+     * @return false when there is an invalid record or overlapping data
+     */
+    bool parse(const QByteArray& content);
+
+    /**
+     * @brief Return the memory segments sorted by address
+     *
+     * @return const QVector<Segment>&
+     */
+    const QVector<Segment>& segments() const { return _segments; };
+
+    /**
+     * @brief Return the number of data bytes
+     *
+     * @return qint64
+     */
+    qint64 size() const;
+
+    /**
+     * @brief Check if there is no data
+     *
+     * @return true
+     * @return false
+     */
+    bool isEmpty() const { return _segments.isEmpty(); };
+
+private:
+    QVector<Segment> _segments;
+};
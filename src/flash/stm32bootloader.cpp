@@ -0,0 +1,365 @@
+#include <algorithm>
+
+#include <QElapsedTimer>
+#include <QtEndian>
+
+#include "logger.h"
+#include "stm32bootloader.h"
+
+PING_LOGGING_CATEGORY(STM32_BOOTLOADER, "ping.stm32bootloader")
+
+namespace {
+// Mass erase can take some seconds in devices with large flash
+const int eraseTimeoutMs = 30000;
+const int checksumTimeoutMs = 5000;
+const int replyTimeoutMs = 1000;
+} // namespace
+
+Stm32Bootloader::Stm32Bootloader(QIODevice* device)
+    : _device(device)
+{
+}
+
+bool Stm32Bootloader::flash(const IntelHex& image, bool verify)
+{
+    _progressOffset = 0;
+    _progressScale = 100;
+    setProgress(0);
+
+    if (image.isEmpty()) {
+        return setError(QStringLiteral("Firmware image is empty."));
+    }
+
+    if (!connect() || !eraseAll()) {
+        return false;
+    }
+
+    // Reading back takes as long as writing, the checksum is calculated by the bootloader
+    const bool readBack = verify && !supports(GetChecksum);
+    _progressScale = !verify ? 100 : readBack ? 50 : 95;
+    if (!write(image)) {
+        return false;
+    }
+
+    if (verify) {
+        _progressOffset = _progressScale;
+        _progressScale = 100 - _progressOffset;
+        if (!Stm32Bootloader::verify(image)) {
+            return false;
+        }
+    }
+
+    _progressOffset = 0;
+    _progressScale = 100;
+    if (!go(image.segments().first().address)) {
+        return false;
+    }
+
+    setProgress(1);
+    return true;
+}
+
+bool Stm32Bootloader::connect()
+{
+    // A bootloader that was already synchronized replies with a nack
+    bool synchronized = false;
+    for (int attempt = 0; attempt < 3 && !synchronized; attempt++) {
+        _device->readAll();
+        QByteArray reply;
+        synchronized = writeBytes(QByteArray(1, synchronization)) && readBytes(reply, 1, replyTimeoutMs)
+            && (static_cast<quint8>(reply[0]) == ack || static_cast<quint8>(reply[0]) == nack);
+    }
+    if (!synchronized) {
+        return setError(QStringLiteral("Bootloader did not answer, check if the device is in bootloader mode."));
+    }
+
+    // Get: ack, number of bytes, version, commands and ack
+    QByteArray numberOfBytes;
+    QByteArray reply;
+    if (!writeBytes(commandFrame(Get)) || !readAck(replyTimeoutMs) || !readBytes(numberOfBytes, 1, replyTimeoutMs)
+        || !readBytes(reply, static_cast<quint8>(numberOfBytes[0]) + 1, replyTimeoutMs) || !readAck(replyTimeoutMs)) {
+        return setError(QStringLiteral("Failed to get bootloader commands: %1").arg(_errorString));
+    }
+
+    _version = static_cast<quint8>(reply[0]);
+    _commands = reply.mid(1);
+    qCDebug(STM32_BOOTLOADER) << "Bootloader version:" << Qt::hex << _version << "commands:" << _commands.toHex(' ');
+    return true;
+}
+
+bool Stm32Bootloader::eraseAll()
+{
+    // Special codes of the global erase with their checksums
+    if (supports(ExtendedErase)) {
+        return transaction({commandFrame(ExtendedErase), QByteArray("\xFF\xFF\x00", 3)}, eraseTimeoutMs)
+            || setError(QStringLiteral("Failed to erase: %1").arg(_errorString));
+    }
+
+    if (supports(Erase)) {
+        return transaction({commandFrame(Erase), QByteArray("\xFF\x00", 2)}, eraseTimeoutMs)
+            || setError(QStringLiteral("Failed to erase: %1").arg(_errorString));
+    }
+
+    return setError(QStringLiteral("Bootloader does not support erase."));
+}
+
+bool Stm32Bootloader::write(const IntelHex& image)
+{
+    const qint64 total = image.size();
+    qint64 written = 0;
+    QByteArray dataFrame;
+    dataFrame.reserve(maxBlockSize + 5);
+    for (const auto& segment : image.segments()) {
+        for (int offset = 0; offset < segment.data.size(); offset += maxBlockSize) {
+            const int size = std::min(maxBlockSize, segment.data.size() - offset);
+            // Number of bytes minus one, data padded to a multiple of 4 bytes and checksum
+            dataFrame.resize(0);
+            dataFrame.append(char(0));
+            dataFrame.append(segment.data.constData() + offset, size);
+            if (size % 4) {
+                dataFrame.append(4 - size % 4, char(0xFF));
+            }
+            dataFrame[0] = static_cast<char>(dataFrame.size() - 2);
+            quint8 checksum = 0;
+            for (const char byte : qAsConst(dataFrame)) {
+                checksum ^= static_cast<quint8>(byte);
+            }
+            dataFrame.append(static_cast<char>(checksum));
+
+            const quint32 address = segment.address + offset;
+            if (!transaction({commandFrame(WriteMemory), wordFrame(address), dataFrame})) {
+                return setError(QStringLiteral("Failed to write at address 0x%1: %2")
+                                    .arg(address, 8, 16, QChar('0'))
+                                    .arg(_errorString));
+            }
+
+            written += size;
+            setProgress(static_cast<float>(written) / total);
+        }
+    }
+
+    return true;
+}
+
+bool Stm32Bootloader::verify(const IntelHex& image)
+{
+    const qint64 total = image.size();
+    qint64 verified = 0;
+
+    if (supports(GetChecksum)) {
+        for (const auto& segment : image.segments()) {
+            // Checksum of the memory region: the size is acknowledged, then another ack when the computation
+            // finishes, followed by the CRC and its checksum
+            const quint32 words = (segment.data.size() + 3) / 4;
+            QByteArray reply;
+            if (!transaction({commandFrame(GetChecksum), wordFrame(segment.address), wordFrame(words)})
+                || !readAck(checksumTimeoutMs) || !readBytes(reply, 5, replyTimeoutMs)) {
+                return setError(QStringLiteral("Failed to get checksum: %1").arg(_errorString));
+            }
+
+            quint8 checksum = 0;
+            for (int i = 0; i < 4; i++) {
+                checksum ^= static_cast<quint8>(reply[i]);
+            }
+            const quint32 crc = qFromBigEndian<quint32>(reply.constData());
+            if (checksum != static_cast<quint8>(reply[4]) || crc != crc32(segment.data)) {
+                return setError(QStringLiteral("Verification failed for the region at address 0x%1.")
+                                    .arg(segment.address, 8, 16, QChar('0')));
+            }
+
+            verified += segment.data.size();
+            setProgress(static_cast<float>(verified) / total);
+        }
+        return true;
+    }
+
+    if (!supports(ReadMemory)) {
+        return setError(QStringLiteral("Bootloader does not support verification."));
+    }
+
+    QByteArray reply;
+    for (const auto& segment : image.segments()) {
+        for (int offset = 0; offset < segment.data.size(); offset += maxBlockSize) {
+            const int size = std::min(maxBlockSize, segment.data.size() - offset);
+            const quint32 address = segment.address + offset;
+            const quint8 numberOfBytes = size - 1;
+            const QByteArray lengthFrame
+                = QByteArray(1, static_cast<char>(numberOfBytes)) + QByteArray(1, static_cast<char>(~numberOfBytes));
+            if (!transaction({commandFrame(ReadMemory), wordFrame(address), lengthFrame})
+                || !readBytes(reply, size, replyTimeoutMs)) {
+                return setError(QStringLiteral("Failed to read at address 0x%1: %2")
+                                    .arg(address, 8, 16, QChar('0'))
+                                    .arg(_errorString));
+            }
+
+            if (reply != QByteArray::fromRawData(segment.data.constData() + offset, size)) {
+                return setError(
+                    QStringLiteral("Verification failed at address 0x%1.").arg(address, 8, 16, QChar('0')));
+            }
+
+            verified += size;
+            setProgress(static_cast<float>(verified) / total);
+        }
+    }
+
+    return true;
+}
+
+bool Stm32Bootloader::go(quint32 address)
+{
+    return transaction({commandFrame(Go), wordFrame(address)})
+        || setError(QStringLiteral("Failed to start the application: %1").arg(_errorString));
+}
+
+quint32 Stm32Bootloader::crc32(const QByteArray& data)
+{
+    static const quint32 polynomial = 0x04C11DB7;
+    quint32 crc = 0xFFFFFFFF;
+    const int numberOfWords = (data.size() + 3) / 4;
+    for (int wordIndex = 0; wordIndex < numberOfWords; wordIndex++) {
+        quint32 word = 0;
+        for (int byte = 0; byte < 4; byte++) {
+            const int index = wordIndex * 4 + byte;
+            const quint32 value = index < data.size() ? static_cast<quint8>(data[index]) : 0xFF;
+            word |= value << (8 * byte);
+        }
+
+        crc ^= word;
+        for (int bit = 0; bit < 32; bit++) {
+            crc = crc & 0x80000000 ? (crc << 1) ^ polynomial : crc << 1;
+        }
+    }
+    return crc;
+}
+
+bool Stm32Bootloader::transaction(const QVector<QByteArray>& frames, int timeoutMs)
+{
+    if (!_pipelined) {
+        return sequentialTransaction(frames, timeoutMs);
+    }
+
+    QByteArray data;
+    for (const auto& frame : frames) {
+        data.append(frame);
+    }
+
+    bool acknowledged = writeBytes(data);
+    for (int i = 0; i < frames.size() && acknowledged; i++) {
+        acknowledged = readAck(i == frames.size() - 1 ? timeoutMs : replyTimeoutMs);
+    }
+    if (acknowledged) {
+        return true;
+    }
+
+    // The bootloader may lose bytes that arrive while it replies
+    qCWarning(STM32_BOOTLOADER) << "Pipelined command failed:" << _errorString;
+    qCWarning(STM32_BOOTLOADER) << "Waiting for each acknowledgment from now on.";
+    _pipelined = false;
+    return resynchronize() && sequentialTransaction(frames, timeoutMs);
+}
+
+bool Stm32Bootloader::sequentialTransaction(const QVector<QByteArray>& frames, int timeoutMs)
+{
+    for (int i = 0; i < frames.size(); i++) {
+        if (!writeBytes(frames[i]) || !readAck(i == frames.size() - 1 ? timeoutMs : replyTimeoutMs)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Stm32Bootloader::resynchronize()
+{
+    // Filler bytes complete any frame that the bootloader is waiting for with a wrong checksum,
+    // after the nack it waits for a new command
+    static const QByteArray filler(1, static_cast<char>(0xFE));
+    QByteArray reply;
+    _device->readAll();
+    for (int i = 0; i < maxBlockSize + 8; i++) {
+        if (!writeBytes(filler)) {
+            return false;
+        }
+        if (readBytes(reply, 1, 20) && static_cast<quint8>(reply[0]) == nack) {
+            _device->readAll();
+            return true;
+        }
+    }
+
+    return setError(QStringLiteral("Not possible to synchronize with the bootloader again."));
+}
+
+bool Stm32Bootloader::readAck(int timeoutMs)
+{
+    QByteArray reply;
+    if (!readBytes(reply, 1, timeoutMs)) {
+        return false;
+    }
+
+    switch (static_cast<quint8>(reply[0])) {
+    case ack:
+        return true;
+    case nack:
+        return setError(QStringLiteral("Command was not acknowledged."));
+    default:
+        return setError(QStringLiteral("Unexpected reply: 0x%1").arg(static_cast<quint8>(reply[0]), 2, 16, QChar('0')));
+    }
+}
+
+bool Stm32Bootloader::readBytes(QByteArray& data, int size, int timeoutMs)
+{
+    QElapsedTimer timer;
+    timer.start();
+    data.resize(0);
+    while (data.size() < size) {
+        if (!_device->bytesAvailable()) {
+            const qint64 remainingMs = timeoutMs - timer.elapsed();
+            if (remainingMs <= 0 || !_device->waitForReadyRead(remainingMs)) {
+                return setError(QStringLiteral("Timeout waiting for the bootloader."));
+            }
+        }
+        data.append(_device->read(size - data.size()));
+    }
+    return true;
+}
+
+bool Stm32Bootloader::writeBytes(const QByteArray& data)
+{
+    if (_device->write(data) != data.size()) {
+        return setError(QStringLiteral("Failed to write: %1").arg(_device->errorString()));
+    }
+
+    while (_device->bytesToWrite()) {
+        if (!_device->waitForBytesWritten(replyTimeoutMs)) {
+            return setError(QStringLiteral("Timeout writing to the device."));
+        }
+    }
+    return true;
+}
+
+bool Stm32Bootloader::setError(const QString& errorString)
+{
+    _errorString = errorString;
+    qCDebug(STM32_BOOTLOADER) << errorString;
+    return false;
+}
+
+void Stm32Bootloader::setProgress(float progress)
+{
+    if (_progress) {
+        _progress(_progressOffset + progress * _progressScale);
+    }
+}
+
+QByteArray Stm32Bootloader::commandFrame(Command command)
+{
+    return QByteArray(1, static_cast<char>(command)) + QByteArray(1, static_cast<char>(~command));
+}
+
+QByteArray Stm32Bootloader::wordFrame(quint32 word)
+{
+    // Most significant byte first, followed by the XOR of all bytes
+    QByteArray frame(5, 0);
+    qToBigEndian<quint32>(word, frame.data());
+    frame[4] = frame[0] ^ frame[1] ^ frame[2] ^ frame[3];
+    return frame;
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <functional>
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QLoggingCategory>
+#include <QVector>
+
+#include "intelhex.h"
+
+Q_DECLARE_LOGGING_CATEGORY(STM32_BOOTLOADER)
+
+/**
+ * @brief STM32 USART bootloader protocol
+ *  Implements the host side of ST AN3155 over a serial device configured with 8 data bits and even parity.
+ *  The device is used with blocking calls, so it should run in its own thread.
+ *
+ *  Writes use the maximum block size and, when pipelined, each command is sent with its address and data
+ *  in a single write and the acknowledgments are checked after it. If a pipelined command fails, the
+ *  bootloader is resynchronized and the remaining commands wait for each acknowledgment.
+ *  Verification uses the bootloader CRC when the get checksum command is available,
+ *  otherwise the memory is read back.
+ */
+class Stm32Bootloader {
+public:
+    /**
+     * @brief Bootloader commands
+     *
+     */
+    enum Command : quint8 {
+        Get = 0x00,
+        ReadMemory = 0x11,
+        Go = 0x21,
+        WriteMemory = 0x31,
+        Erase = 0x43,
+        ExtendedErase = 0x44,
+        GetChecksum = 0xA1,
+    };
+
+    // Bootloader replies
+    static const quint8 ack = 0x79;
+    static const quint8 nack = 0x1F;
+    static const quint8 synchronization = 0x7F;
+    // Maximum number of bytes in a read or write command
+    static const int maxBlockSize = 256;
+
+    /**
+     * @brief Construct a new Stm32 Bootloader object
+     *
+     * @param device open serial device
+     */
+    explicit Stm32Bootloader(QIODevice* device);
+
+    /**
+     * @brief Enable or disable pipelined commands
+     *
+     * @param pipelined
+     */
+    void setPipelined(bool pipelined) { _pipelined = pipelined; };
+
+    /**
+     * @brief Set the function called with the progress of flash, from 0 to 100
+     *
+     * @param progress
+     */
+    void setProgressCallback(std::function<void(float)> progress) { _progress = progress; };
+
+    /**
+     * @brief Erase, write, verify and start the firmware
+     *
+     * @param image
+     * @param verify
+     * @return true
+     * @return false
+     */
+    bool flash(const IntelHex& image, bool verify);
+
+    /**
+     * @brief Synchronize with the bootloader and get its commands
+     *
+     * @return true
+     * @return false
+     */
+    bool connect();
+
+    /**
+     * @brief Erase all the flash
+     *
+     * @return true
+     * @return false
+     */
+    bool eraseAll();
+
+    /**
+     * @brief Write the image in blocks of maximum size
+     *
+     * @param image
+     * @return true
+     * @return false
+     */
+    bool write(const IntelHex& image);
+
+    /**
+     * @brief Check if the memory has the image
+     *
+     * @param image
+     * @return true
+     * @return false
+     */
+    bool verify(const IntelHex& image);
+
+    /**
+     * @brief Start the application
+     *
+     * @param address
+     * @return true
+     * @return false
+     */
+    bool go(quint32 address);
+
+    /**
+     * @brief Check if the bootloader supports a command, valid after connect
+     *
+     * @param command
+     * @return true
+     * @return false
+     */
+    bool supports(Command command) const { return _commands.contains(static_cast<char>(command)); };
+
+    /**
+     * @brief Return the bootloader protocol version, valid after connect
+     *
+     * @return quint8
+     */
+    quint8 version() const { return _version; };
+
+    /**
+     * @brief Return the description of the last error
+     *
+     * @return QString
+     */
+    QString errorString() const { return _errorString; };
+
+    /**
+     * @brief Return the CRC calculated by the bootloader for a memory region
+     *  CRC-32 with polynomial 0x04C11DB7 and initial value 0xFFFFFFFF over little endian 32 bits words,
+     *  the size is padded with 0xFF to complete the last word.
+     *
+     * @param data
+     * @return quint32
+     */
+    static quint32 crc32(const QByteArray& data);
+
+private:
+    /**
+     * @brief Send frames that are acknowledged by the bootloader
+     *
+     * @param frames
+     * @param timeoutMs for the acknowledgment of the last frame
+     * @return true
+     * @return false
+     */
+    bool transaction(const QVector<QByteArray>& frames, int timeoutMs = 1000);
+
+    /**
+     * @brief Send frames and wait for the acknowledgment of each one
+     *
+     * @param frames
+     * @param timeoutMs for the acknowledgment of the last frame
+     * @return true
+     * @return false
+     */
+    bool sequentialTransaction(const QVector<QByteArray>& frames, int timeoutMs);
+
+    /**
+     * @brief Bring the bootloader back to the state where it waits for a command
+     *
+     * @return true
+     * @return false
+     */
+    bool resynchronize();
+
+    bool readAck(int timeoutMs);
+    bool readBytes(QByteArray& data, int size, int timeoutMs);
+    bool writeBytes(const QByteArray& data);
+    bool setError(const QString& errorString);
+    void setProgress(float progress);
+
+    static QByteArray commandFrame(Command command);
+    static QByteArray wordFrame(quint32 word);
+
+    QIODevice* _device;
+    QByteArray _commands;
+    QString _errorString;
+    bool _pipelined = true;
+    std::function<void(float)> _progress;
+    // Fraction of the progress used by the write and verify steps
+    float _progressOffset = 0;
+    float _progressScale = 100;
+    quint8 _version = 0;
+};
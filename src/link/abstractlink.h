@@ -6,6 +6,8 @@
 
 #include "linkconfiguration.h"
 
+class QIODevice;
+
 /**
  * @brief The abstract connection link base class
  *  This should be used in all connection types
@@ -35,6 +37,14 @@ public:
      */
     Q_INVOKABLE virtual qint64 byteSize() { return 0; };
 
+    /**
+     * @brief Return the replay speed achieved by offline sources
+     *  Ratio between the log time played and the elapsed time
+     *
+     * @return float
+     */
+    Q_INVOKABLE virtual float achievedReplaySpeed() { return 0; };
+
     /**
      * @brief Return the link configuration pointer
      *
@@ -56,6 +66,13 @@ public:
      */
     Q_INVOKABLE virtual QString elapsedTimeString() { return elapsedTime().toString(_timeFormat); };
 
+    /**
+     * @brief Return the device that writes the link data, used to measure the link throughput
+     *
+     * @return QIODevice* nullptr if the link does not write to a device
+     */
+    virtual QIODevice* device() { return nullptr; };
+
     /**
      * @brief Return error in a human friendly message
      *
@@ -70,6 +87,28 @@ public:
      */
     Q_INVOKABLE virtual bool finishConnection() { return true; };
 
+    /**
+     * @brief Wait for dataConsumed after each newData before sending more data
+     *  Only links that can wait for their consumer use it, like the log replay
+     *
+     * @param enabled
+     */
+    void setFlowControl(bool enabled) { _flowControl = enabled; };
+
+    /**
+     * @brief Check if the consumer reports the handled data with dataConsumed
+     *
+     * @return true
+     * @return false
+     */
+    bool flowControl() const { return _flowControl; };
+
+    /**
+     * @brief Report that the data of a newData signal was handled, used with flow control
+     *
+     */
+    virtual void dataConsumed() {};
+
     /**
      * @brief Check if connection is auto connected
      *
@@ -170,6 +209,20 @@ public:
      */
     Q_INVOKABLE virtual void setPackageIndex(int index) { Q_UNUSED(index) };
 
+    /**
+     * @brief Move to a time position
+     *
+     * @param msecs time since the beginning
+     */
+    Q_INVOKABLE virtual void seekToTime(int msecs) { Q_UNUSED(msecs) };
+
+    /**
+     * @brief Move to a percentage of the total time
+     *
+     * @param percentage [0, 1]
+     */
+    Q_INVOKABLE virtual void seekToPercentage(float percentage) { Q_UNUSED(percentage) };
+
     /**
      * @brief Set link type
      *
@@ -207,6 +260,13 @@ public:
      */
     Q_INVOKABLE virtual QString totalTimeString() { return totalTime().toString(_timeFormat); };
 
+    /**
+     * @brief Return the time format used in time strings and sensor logs
+     *
+     * @return const QString&
+     */
+    static const QString& timeFormat() { return _timeFormat; };
+
     /**
      * @brief Return LinkType
      *
@@ -248,6 +308,7 @@ public:
      */
     float upSpeed() { return _bitRateUpSpeed.speed; }
 
+    Q_PROPERTY(float achievedReplaySpeed READ achievedReplaySpeed NOTIFY achievedReplaySpeedChanged)
     Q_PROPERTY(qint64 byteSize READ byteSize NOTIFY byteSizeChanged)
     Q_PROPERTY(LinkConfiguration* configuration READ configuration NOTIFY configurationChanged)
     Q_PROPERTY(QTime elapsedTime READ elapsedTime NOTIFY elapsedTimeChanged)
@@ -271,8 +332,11 @@ signals:
     void linkChanged(AbstractLinkNamespace::LinkType link);
     void newData(const QByteArray& data);
     void sendData(const QByteArray& data);
+    // The link was closed by an error, like a removed device
+    void connectionLost();
     void speedChanged();
 
+    void achievedReplaySpeedChanged();
     void byteSizeChanged();
     void packageSizeChanged();
     void packageIndexChanged();
@@ -285,6 +349,7 @@ protected:
 
 private:
     bool _autoConnect;
+    bool _flowControl = false;
     QString _name;
     QTimer _oneSecondTimer;
     LinkType _type;
@@ -1,11 +1,13 @@
 #include <functional>
 
+#include <QBuffer>
 #include <QDebug>
 #include <QDir>
 #include <QLoggingCategory>
 #include <QUrl>
 
 #include "filelink.h"
+#include "logeditor.h"
 #include "logger.h"
 #include "settingsmanager.h"
 
@@ -16,6 +18,7 @@ FileLink::FileLink(QObject* parent)
     , _openModeFlag(QIODevice::ReadWrite)
     , _timer()
     , _inout(&_file)
+    , _dataOffset(0)
     , _processLog(nullptr)
 {
     _timer.start();
@@ -26,26 +29,28 @@ FileLink::FileLink(QObject* parent)
 void FileLink::writeData(const QByteArray& data)
 {
     // Check if we have already opened the file
-    if (!_file.isOpen()) {
+    if (!_logWriter.isOpen()) {
         qCDebug(PING_PROTOCOL_FILELINK) << "File will be opened.";
-        if (!_file.open(QIODevice::ReadWrite)) {
+        LogFileWriter::Configuration configuration;
+        configuration.compression = SettingsManager::self()->compressSensorLogs();
+        configuration.fsyncPolicy
+            = static_cast<LogFileWriter::FsyncPolicy>(qMin(SettingsManager::self()->sensorLogFsyncPolicy(), 2u));
+        configuration.rotationSize = qint64(SettingsManager::self()->sensorLogRotationSizeMB()) * 1024 * 1024;
+        configuration.rotationDurationNs
+            = qint64(SettingsManager::self()->sensorLogRotationMinutes()) * 60 * 1000 * 1000 * 1000;
+        _logWriter.setConfiguration(configuration);
+        if (!_logWriter.open(_file.fileName(), _logSensorStruct)) {
             qCDebug(PING_PROTOCOL_FILELINK) << "File was not open.";
             return;
         }
-
-        // Create log header
-        _inout << _logSensorStruct;
     }
 
-    // This save the data as a structure to deal with the timestamp
-    if (_openModeFlag == QIODevice::WriteOnly && _file.isWritable()) {
-        QString time = QTime::fromMSecsSinceStartOfDay(_timer.elapsed()).toString(_timeFormat);
-        Pack pack {time, data};
-        _inout << pack.time << pack.data;
+    // This save the data with a monotonic timestamp
+    if (_openModeFlag == QIODevice::WriteOnly) {
+        _logWriter.append(_timer.nsecsElapsed(), data);
     } else {
         qCWarning(PING_PROTOCOL_FILELINK) << "Something is wrong!";
         qCDebug(PING_PROTOCOL_FILELINK) << "File is opened as write only:" << (_openModeFlag == QIODevice::WriteOnly);
-        qCDebug(PING_PROTOCOL_FILELINK) << "File can be writable:" << _file.isWritable();
     }
 }
 
@@ -89,6 +94,8 @@ bool FileLink::setConfiguration(const LinkConfiguration& linkConfiguration)
 
         // Update internal struct
         _logSensorStruct = logSensorStruct;
+        // Records start right after the header
+        _dataOffset = _file.pos();
         qCDebug(PING_PROTOCOL_FILELINK) << "Valid log file.";
         qCDebug(PING_PROTOCOL_FILELINK) << _logSensorStruct;
     } else {
@@ -112,21 +119,27 @@ bool FileLink::startConnection()
     _processLog.reset(new ProcessLog());
     _processLog->moveToThread(&_processLogThread);
 
-    auto updateProcessReplayTime = [this]() {
-        int replayTimeMs = SettingsManager::self()->realTimeReplay() ? 0 : 100;
-        qCDebug(PING_PROTOCOL_FILELINK) << "Update replay time:" << replayTimeMs;
-        _processLog.get()->setReplayTimeMs(replayTimeMs);
+    auto updateReplaySpeed = [this]() {
+        const float speed = SettingsManager::self()->replaySpeed();
+        qCDebug(PING_PROTOCOL_FILELINK) << "Update replay speed:" << speed;
+        _processLog->setSpeed(speed);
     };
 
-    updateProcessReplayTime();
+    updateReplaySpeed();
 
     connect(&_processLogThread, &QThread::started, _processLog.get(), &ProcessLog::run);
     connect(&_processLogThread, &QThread::finished, _processLog.get(), &ProcessLog::stop);
-    connect(_processLog.get(), &ProcessLog::newPackage, this, &FileLink::newData);
+    // Without flow control packages are consumed when delivered, the consumer may still queue them
+    connect(_processLog.get(), &ProcessLog::newPackage, this, [this](const QByteArray& data) {
+        emit newData(data);
+        if (!flowControl()) {
+            _processLog->packageConsumed();
+        }
+    });
     connect(_processLog.get(), &ProcessLog::packageIndexChanged, this, &FileLink::packageIndexChanged);
     connect(_processLog.get(), &ProcessLog::packageIndexChanged, this, &FileLink::elapsedTimeChanged);
-    connect(SettingsManager::self(), &SettingsManager::realTimeReplayChanged, this,
-        [updateProcessReplayTime] { updateProcessReplayTime(); });
+    connect(_processLog.get(), &ProcessLog::achievedSpeedChanged, this, &FileLink::achievedReplaySpeedChanged);
+    connect(SettingsManager::self(), &SettingsManager::replaySpeedChanged, this, updateReplaySpeed);
 
     processFile();
     return true;
@@ -134,22 +147,29 @@ bool FileLink::startConnection()
 
 void FileLink::processFile()
 {
-    Pack pack;
+    // Records are read on demand from the mapped file, only their offsets are kept in memory
+    if (!_logReader.open(_file.fileName(), _dataOffset, _logSensorStruct.version)) {
+        qCWarning(PING_PROTOCOL_FILELINK) << "Failed to index log file.";
+    }
+    _processLog->setReader(&_logReader);
 
-    while (!_inout.atEnd()) {
-        // Get data
-        _inout >> pack.time >> pack.data;
+    // Keyframes allow seeks to show the complete view at the new position
+    _logKeyframes.build(_file.fileName(), &_logReader);
+    _processLog->setKeyframes(&_logKeyframes);
 
-        // Check if we have a new package
-        if (pack.time.isEmpty()) {
-            qCDebug(PING_PROTOCOL_FILELINK) << "No more packages !";
-            break;
-        }
+    // Summary of the whole log, from the cache or built in background
+    _logOverview.build(_file.fileName(), &_logReader,
+        [this] { QMetaObject::invokeMethod(this, &FileLink::overviewChanged, Qt::QueuedConnection); });
 
-        auto time = QTime::fromString(pack.time, _timeFormat);
-        _processLog->append(time, pack.data);
+    // Continue from where the last session stopped
+    const int lastPackageIndex = _logReader.lastPackageIndex();
+    if (lastPackageIndex > 0 && lastPackageIndex < _logReader.size() - 1) {
+        qCDebug(PING_PROTOCOL_FILELINK) << "Restoring last position:" << lastPackageIndex;
+        _processLog->setPackageIndex(lastPackageIndex);
     }
+
     _processLogThread.start();
+    emit packageIndexChanged();
     emit elapsedTimeChanged();
     emit totalTimeChanged();
 }
@@ -180,6 +200,89 @@ LogSensorStruct FileLink::staticLogSensorStruct(const LinkConfiguration& linkCon
     return logSensorStruct;
 }
 
+void FileLink::seekToTime(int msecs)
+{
+    if (!_processLog || !_logReader.size()) {
+        return;
+    }
+
+    const qint64 timestampNs = _logReader.timestampNs(0) + static_cast<qint64>(msecs) * 1000000;
+    _processLog->setPackageIndex(_logReader.indexForTimestamp(timestampNs));
+    emit packageIndexChanged();
+    emit elapsedTimeChanged();
+}
+
+void FileLink::seekToPercentage(float percentage)
+{
+    if (!_logReader.size()) {
+        return;
+    }
+
+    const qint64 totalNs = _logReader.timestampNs(_logReader.size() - 1) - _logReader.timestampNs(0);
+    seekToTime(qBound(0.0f, percentage, 1.0f) * totalNs / 1000000);
+}
+
+QVariantList FileLink::overviewDistances() const
+{
+    QVariantList distances;
+    if (!_logOverview.isReady()) {
+        return distances;
+    }
+
+    distances.reserve(_logOverview.bins().size());
+    for (const auto& bin : _logOverview.bins()) {
+        distances.append(bin.meanDistance);
+    }
+    return distances;
+}
+
+QVariantList FileLink::overviewConfidences() const
+{
+    QVariantList confidences;
+    if (!_logOverview.isReady()) {
+        return confidences;
+    }
+
+    confidences.reserve(_logOverview.bins().size());
+    for (const auto& bin : _logOverview.bins()) {
+        confidences.append(bin.meanConfidence);
+    }
+    return confidences;
+}
+
+QString FileLink::overviewThumbnail() const
+{
+    if (!_logOverview.isReady()) {
+        return {};
+    }
+
+    QByteArray png;
+    QBuffer buffer(&png);
+    buffer.open(QIODevice::WriteOnly);
+    _logOverview.thumbnail().save(&buffer, "PNG");
+    return QStringLiteral("data:image/png;base64,") + QString::fromLatin1(png.toBase64());
+}
+
+QVariantList FileLink::overviewLowConfidenceSeconds(int minConfidence) const
+{
+    QVariantList seconds;
+    for (const int second : _logOverview.lowConfidenceSeconds(minConfidence)) {
+        seconds.append(second);
+    }
+    return seconds;
+}
+
+bool FileLink::extractToFile(const QString& fileName, int startMsecs, int endMsecs) const
+{
+    if (_openModeFlag != QIODevice::ReadOnly || !_logReader.isOpen()) {
+        qCWarning(PING_PROTOCOL_FILELINK) << "Only logs being played can be extracted.";
+        return false;
+    }
+
+    return LogEditor::extract(
+        _file.fileName(), fileName, static_cast<qint64>(startMsecs) * 1000000, static_cast<qint64>(endMsecs) * 1000000);
+}
+
 bool FileLink::isOpen()
 {
     // If filelink exist to create a log, the file will be only created after receiving the first data
@@ -188,6 +291,13 @@ bool FileLink::isOpen()
         || _file.isReadable(); // If file is readable it's already opened and working
 };
 
+void FileLink::dataConsumed()
+{
+    if (_processLog) {
+        _processLog->packageConsumed();
+    }
+}
+
 bool FileLink::finishConnection()
 {
     // Stop reading log process if it's running
@@ -197,6 +307,15 @@ bool FileLink::finishConnection()
         _processLogThread.wait();
     }
 
+    _logKeyframes.cancel();
+    _logOverview.cancel();
+    if (_logReader.isOpen()) {
+        _logReader.saveLastPackageIndex(_processLog->packageIndex());
+        _logReader.close();
+    }
+
+    _logWriter.close();
+
     // Only close files that are open
     if (_file.isOpen()) {
         _file.close();
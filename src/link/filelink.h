@@ -9,6 +9,10 @@
 #include <memory>
 
 #include "abstractlink.h"
+#include "logfilereader.h"
+#include "logfilewriter.h"
+#include "logkeyframes.h"
+#include "logoverview.h"
 #include "logsensorstruct.h"
 #include "processlog.h"
 
@@ -27,6 +31,13 @@ public:
     FileLink(QObject* parent = nullptr);
     ~FileLink();
 
+    /**
+     * @brief Return the replay speed achieved in the last second
+     *
+     * @return float
+     */
+    float achievedReplaySpeed() final { return _processLog ? _processLog->achievedSpeed() : 0; };
+
     /**
      * @brief Return size of file in bytes
      *
@@ -56,6 +67,12 @@ public:
      */
     bool finishConnection() final;
 
+    /**
+     * @brief Allow the replay to send another package
+     *
+     */
+    void dataConsumed() final;
+
     /**
      * @brief Check if connection is open
      *
@@ -112,10 +129,27 @@ public:
      */
     void setPackageIndex(int index) final override
     {
-        if (_processLog)
+        if (_processLog) {
             _processLog->setPackageIndex(index);
+            emit packageIndexChanged();
+            emit elapsedTimeChanged();
+        }
     }
 
+    /**
+     * @brief Move to a time position
+     *
+     * @param msecs
+     */
+    void seekToTime(int msecs) final override;
+
+    /**
+     * @brief Move to a percentage of the total time
+     *
+     * @param percentage
+     */
+    void seekToPercentage(float percentage) final override;
+
     /**
      * @brief Start log
      *
@@ -156,12 +190,63 @@ public:
      */
     static LogSensorStruct staticLogSensorStruct(const LinkConfiguration& linkConfiguration);
 
-private:
-    struct Pack {
-        QString time;
-        QByteArray data;
-    };
+    /**
+     * @brief Check if the log overview is available
+     *
+     * @return true
+     * @return false
+     */
+    bool overviewReady() const { return _logOverview.isReady(); };
 
+    /**
+     * @brief Return the mean distance of each second of the log
+     *
+     * @return QVariantList distances in mm, -1 when not available
+     */
+    Q_INVOKABLE QVariantList overviewDistances() const;
+
+    /**
+     * @brief Return the mean confidence of each second of the log
+     *
+     * @return QVariantList confidences in %, -1 when not available
+     */
+    Q_INVOKABLE QVariantList overviewConfidences() const;
+
+    /**
+     * @brief Return the log thumbnail, with a column per second
+     *  The PNG data URL can be used as an Image source
+     *
+     * @return QString empty while the overview is not available
+     */
+    QString overviewThumbnail() const;
+
+    /**
+     * @brief Return the seconds of the log with low confidence
+     *
+     * @param minConfidence in %
+     * @return QVariantList
+     */
+    Q_INVOKABLE QVariantList overviewLowConfidenceSeconds(int minConfidence = 50) const;
+
+    /**
+     * @brief Save a time range of the log being played in a new log
+     *  Records are copied without being decoded, v2 logs are cut at chunk boundaries
+     *
+     * @param fileName new log
+     * @param startMsecs from the beginning of the log
+     * @param endMsecs from the beginning of the log
+     * @return true
+     * @return false
+     */
+    Q_INVOKABLE bool extractToFile(const QString& fileName, int startMsecs, int endMsecs) const;
+
+    Q_PROPERTY(bool overviewReady READ overviewReady NOTIFY overviewChanged)
+    Q_PROPERTY(QString overviewThumbnail READ overviewThumbnail NOTIFY overviewChanged)
+
+signals:
+    void overviewChanged();
+
+private:
     QIODevice::OpenModeFlag _openModeFlag;
     QElapsedTimer _timer;
 
@@ -170,6 +255,11 @@ private:
 
     LogSensorStruct _logSensorStruct;
 
+    qint64 _dataOffset;
+    LogFileReader _logReader;
+    LogKeyframes _logKeyframes;
+    LogOverview _logOverview;
+    LogFileWriter _logWriter;
     std::unique_ptr<ProcessLog> _processLog;
     QThread _processLogThread;
 
@@ -63,9 +63,9 @@ LinkConfiguration::Error LinkConfiguration::error() const
         return InvalidType;
     }
 
-    // Simulation does not need args
+    // Simulation does not need args, optional ones are checked by the simulation link
     // TODO: rework this check, check linkconfiguration capabilities or add new ones for this case
-    if (isSimulation() && !_linkConf.args.length()) {
+    if (isSimulation()) {
         return NoErrors;
     }
 
@@ -0,0 +1,394 @@
+#include <QDataStream>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTime>
+#include <QtEndian>
+
+#include <memory>
+#include <vector>
+
+#if defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+#include "abstractlink.h"
+#include "logeditor.h"
+#include "logfilereader.h"
+#include "logfilewriter.h"
+#include "logformat.h"
+#include "logger.h"
+#include "logsensorstruct.h"
+
+PING_LOGGING_CATEGORY(PING_LOGEDITOR, "ping.logeditor")
+
+namespace {
+const qint64 copyBufferSize = 4 * 1024 * 1024;
+// Pause between concatenated logs that overlap in time
+const qint64 concatenationGapNs = 100 * 1000 * 1000;
+
+/**
+ * @brief Copy bytes between files without passing through the application when possible
+ *
+ * @param input
+ * @param position
+ * @param length
+ * @param output data is appended at the actual position
+ * @return true
+ * @return false
+ */
+bool copyRange(QFile& input, qint64 position, qint64 length, QFile& output)
+{
+    // Output buffer must be empty before the file descriptor is used
+    if (!output.flush()) {
+        return false;
+    }
+    qint64 outputPosition = output.pos();
+
+#if defined(Q_OS_LINUX)
+    // Kernel copy, it can be a reflink or a server side copy depending on the filesystem
+    loff_t inputOffset = position;
+    loff_t outputOffset = outputPosition;
+    while (length > 0) {
+        const ssize_t copied
+            = ::copy_file_range(input.handle(), &inputOffset, output.handle(), &outputOffset, length, 0);
+        if (copied <= 0) {
+            break;
+        }
+        position += copied;
+        outputPosition += copied;
+        length -= copied;
+    }
+#endif
+
+    // Fallback for other systems or filesystems without support
+    if (!input.seek(position) || !output.seek(outputPosition)) {
+        return false;
+    }
+    while (length > 0) {
+        const QByteArray block = input.read(std::min(length, copyBufferSize));
+        if (block.isEmpty() || output.write(block) != block.size()) {
+            qCWarning(PING_LOGEDITOR) << "Failed to copy records:" << input.errorString() << output.errorString();
+            return false;
+        }
+        length -= block.size();
+    }
+    return true;
+}
+
+/**
+ * @brief Log being edited
+ *
+ */
+struct InputLog {
+    QFile file;
+    LogSensorStruct header;
+    LogFileReader reader;
+
+    bool open(const QString& fileName)
+    {
+        file.setFileName(fileName);
+        if (!file.open(QIODevice::ReadOnly)) {
+            qCWarning(PING_LOGEDITOR) << "Failed to open" << fileName << ":" << file.errorString();
+            return false;
+        }
+
+        QDataStream stream(&file);
+        stream >> header;
+        if (!header.isValid()) {
+            qCWarning(PING_LOGEDITOR) << "Invalid log header:" << fileName;
+            return false;
+        }
+        // Input directories are not ours, the index is only kept in memory
+        reader.setReadOnly(true);
+        return reader.open(fileName, file.pos(), header.version);
+    }
+
+    // First record of the storage unit that holds a record
+    int unitStart(int index) const
+    {
+        if (header.version < 2 || index >= reader.size()) {
+            return index;
+        }
+        const auto& logIndex = reader.index();
+        return logIndex.checkpoints()[logIndex.checkpointForPackage(index)].packageIndex;
+    }
+
+    // First record after the storage unit that holds the record before index
+    int unitEnd(int index) const
+    {
+        if (header.version < 2 || index <= 0) {
+            return index;
+        }
+        const auto& checkpoints = reader.index().checkpoints();
+        const int checkpoint = reader.index().checkpointForPackage(index - 1);
+        return checkpoint + 1 < checkpoints.size() ? checkpoints[checkpoint + 1].packageIndex : reader.size();
+    }
+
+    qint64 position(int index) const { return index < reader.size() ? reader.recordPosition(index) : reader.dataEnd(); }
+};
+
+/**
+ * @brief New log made of ranges of other logs
+ *
+ */
+class OutputLog {
+public:
+    bool open(const QString& fileName, const LogSensorStruct& header)
+    {
+        _file.setFileName(fileName);
+        if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qCWarning(PING_LOGEDITOR) << "Failed to create" << fileName << ":" << _file.errorString();
+            return false;
+        }
+
+        QDataStream stream(&_file);
+        stream << header;
+        _version = header.version;
+        _index.startRecording(fileName);
+        return true;
+    }
+
+    // Records in [first, end) should be aligned to the storage units of the input,
+    // they are copied in bulk unless the offset has to be added to their timestamps
+    bool append(InputLog& input, int first, int end, qint64 timestampOffsetNs = 0)
+    {
+        if (first >= end) {
+            return true;
+        }
+
+        const qint64 begin = input.position(first);
+        const qint64 length = input.position(end) - begin;
+        if (!_file.flush()) {
+            return false;
+        }
+        const qint64 outputBegin = _file.pos();
+
+        const auto& reader = input.reader;
+        _records += end - first;
+        _lastTimestampNs = reader.timestampNs(end - 1) + timestampOffsetNs;
+        if (timestampOffsetNs) {
+            return _version < 2 ? appendShiftedRecords(input, first, end, timestampOffsetNs)
+                                : appendShiftedChunks(input, first, end, timestampOffsetNs);
+        }
+
+        if (_version < 2) {
+            for (int index = first; index < end; index++) {
+                _index.append(reader.timestampNs(index), reader.recordPosition(index) - begin + outputBegin);
+            }
+        } else {
+            const auto& checkpoints = reader.index().checkpoints();
+            for (int checkpoint = reader.index().checkpointForPackage(first);
+                 checkpoint < checkpoints.size() && checkpoints[checkpoint].packageIndex < end; checkpoint++) {
+                const int next
+                    = checkpoint + 1 < checkpoints.size() ? checkpoints[checkpoint + 1].packageIndex : reader.size();
+                _index.appendChunk(checkpoints[checkpoint].timestampNs,
+                    checkpoints[checkpoint].offset - begin + outputBegin, next - checkpoints[checkpoint].packageIndex);
+            }
+        }
+
+        return copyRange(input.file, begin, length, _file);
+    }
+
+    int records() const { return _records; }
+
+    qint64 lastTimestampNs() const { return _lastTimestampNs; }
+
+    bool close()
+    {
+        const bool ok = _file.flush();
+        _index.finishRecording(_file.size());
+        qCDebug(PING_LOGEDITOR) << "Created" << _file.fileName() << "with" << _records << "records and"
+                                << _file.size() << "bytes.";
+        _file.close();
+        return ok;
+    }
+
+private:
+    // v1 records are written again with the time of the day of the new timestamps
+    bool appendShiftedRecords(const InputLog& input, int first, int end, qint64 timestampOffsetNs)
+    {
+        static const qint64 dayMSecs = 24 * 60 * 60 * 1000;
+
+        QDataStream stream(&_file);
+        for (int index = first; index < end; index++) {
+            const qint64 timestampNs = input.reader.timestampNs(index) + timestampOffsetNs;
+            const QString time = QTime::fromMSecsSinceStartOfDay(timestampNs / 1000000 % dayMSecs)
+                                     .toString(AbstractLink::timeFormat());
+            _index.append(timestampNs, _file.pos());
+            stream << time << input.reader.data(index);
+        }
+        return stream.status() == QDataStream::Ok;
+    }
+
+    // v2 chunks are decoded to update the timestamps of their records, then stored as they were
+    bool appendShiftedChunks(InputLog& input, int first, int end, qint64 timestampOffsetNs)
+    {
+        const auto& reader = input.reader;
+        const auto& checkpoints = reader.index().checkpoints();
+        for (int checkpoint = reader.index().checkpointForPackage(first);
+             checkpoint < checkpoints.size() && checkpoints[checkpoint].packageIndex < end; checkpoint++) {
+            if (!input.file.seek(checkpoints[checkpoint].offset)) {
+                return false;
+            }
+            QByteArray chunkHeader = input.file.read(LogFormat::chunkHeaderLength);
+            if (chunkHeader.size() != LogFormat::chunkHeaderLength) {
+                return false;
+            }
+            auto header = LogFormat::readChunkHeader(reinterpret_cast<const uchar*>(chunkHeader.constData()));
+            const bool compressed = header.flags & LogFormat::compressedChunkFlag;
+            const QByteArray stored = input.file.read(header.payloadLength);
+            QByteArray payload = compressed ? qUncompress(stored) : stored;
+
+            for (int position = 0; position + LogFormat::recordHeaderLength <= payload.size();) {
+                auto record = reinterpret_cast<uchar*>(payload.data()) + position;
+                qToLittleEndian<quint64>(qFromLittleEndian<quint64>(record + 4) + timestampOffsetNs, record + 4);
+                position += LogFormat::recordHeaderLength + qFromLittleEndian<quint32>(record);
+            }
+
+            const QByteArray output = compressed ? qCompress(payload) : payload;
+            header.payloadLength = output.size();
+            header.crc = LogFormat::crc32(output.constData(), output.size());
+            header.firstTimestampNs += timestampOffsetNs;
+            LogFormat::writeChunkHeader(header, reinterpret_cast<uchar*>(chunkHeader.data()));
+
+            _index.appendChunk(header.firstTimestampNs, _file.pos(), header.numberOfRecords);
+            if (_file.write(chunkHeader) != chunkHeader.size() || _file.write(output) != output.size()) {
+                qCWarning(PING_LOGEDITOR) << "Failed to write chunk:" << _file.errorString();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    QFile _file;
+    LogIndex _index;
+    int _records = 0;
+    qint64 _lastTimestampNs = 0;
+    uint _version = 0;
+};
+} // namespace
+
+bool LogEditor::extract(const QString& inputFileName, const QString& outputFileName, qint64 startNs, qint64 endNs)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    InputLog input;
+    if (!input.open(inputFileName)) {
+        return false;
+    }
+
+    const auto& reader = input.reader;
+    if (reader.size() == 0 || endNs < startNs) {
+        qCWarning(PING_LOGEDITOR) << "Nothing to extract from" << inputFileName;
+        return false;
+    }
+
+    const qint64 firstTimestampNs = reader.timestampNs(0);
+    int first = reader.indexForTimestamp(firstTimestampNs + startNs);
+    if (reader.timestampNs(first) < firstTimestampNs + startNs) {
+        first++;
+    }
+    first = input.unitStart(first);
+    const int end = input.unitEnd(reader.indexForTimestamp(firstTimestampNs + endNs) + 1);
+    if (first >= end) {
+        qCWarning(PING_LOGEDITOR) << "Range has no records.";
+        return false;
+    }
+
+    OutputLog output;
+    if (!output.open(outputFileName, input.header) || !output.append(input, first, end) || !output.close()) {
+        return false;
+    }
+
+    qCDebug(PING_LOGEDITOR) << "Records" << first << "to" << end << "extracted in" << timer.elapsed() << "ms.";
+    return true;
+}
+
+QStringList LogEditor::split(
+    const QString& inputFileName, const QString& outputFileName, qint64 maxSize, qint64 maxDurationNs)
+{
+    InputLog input;
+    if (!input.open(inputFileName) || input.reader.size() == 0) {
+        return {};
+    }
+
+    // Parts are cut at checkpoints, chunks in v2 and groups of records in v1
+    const auto& reader = input.reader;
+    const auto& checkpoints = reader.index().checkpoints();
+    QStringList parts;
+    int partStart = 0;
+    for (int checkpoint = 1; checkpoint <= checkpoints.size(); checkpoint++) {
+        bool cut = checkpoint == checkpoints.size();
+        if (!cut) {
+            const qint64 groupEnd
+                = checkpoint + 1 < checkpoints.size() ? checkpoints[checkpoint + 1].offset : reader.dataEnd();
+            cut = (maxSize && groupEnd - checkpoints[partStart].offset > maxSize)
+                || (maxDurationNs
+                    && checkpoints[checkpoint].timestampNs - checkpoints[partStart].timestampNs >= maxDurationNs);
+        }
+        if (!cut) {
+            continue;
+        }
+
+        const QString partFileName = LogFileWriter::partFileName(outputFileName, parts.size());
+        const int end = checkpoint < checkpoints.size() ? checkpoints[checkpoint].packageIndex : reader.size();
+        OutputLog output;
+        if (!output.open(partFileName, input.header)
+            || !output.append(input, checkpoints[partStart].packageIndex, end) || !output.close()) {
+            return {};
+        }
+        parts.append(partFileName);
+        partStart = checkpoint;
+    }
+
+    return parts;
+}
+
+bool LogEditor::concatenate(const QStringList& inputFileNames, const QString& outputFileName)
+{
+    if (inputFileNames.isEmpty() || inputFileNames.contains(outputFileName)) {
+        qCWarning(PING_LOGEDITOR) << "Invalid logs to concatenate.";
+        return false;
+    }
+
+    std::vector<std::unique_ptr<InputLog>> inputs;
+    for (const auto& fileName : inputFileNames) {
+        inputs.emplace_back(new InputLog);
+        if (!inputs.back()->open(fileName)) {
+            return false;
+        }
+
+        const auto& first = inputs.front()->header;
+        const auto& header = inputs.back()->header;
+        if (header.version != first.version || header.sensor.family != first.sensor.family
+            || header.sensor.type.value != first.sensor.type.value) {
+            qCWarning(PING_LOGEDITOR) << "Log does not match the format or sensor of the first one:" << fileName;
+            return false;
+        }
+    }
+
+    OutputLog output;
+    if (!output.open(outputFileName, inputs.front()->header)) {
+        return false;
+    }
+    for (auto& input : inputs) {
+        const auto& reader = input->reader;
+        if (reader.size() == 0) {
+            continue;
+        }
+
+        // Logs that restart their clock or are out of order are moved after the previous one
+        qint64 timestampOffsetNs = 0;
+        if (output.records() && reader.timestampNs(0) <= output.lastTimestampNs()) {
+            timestampOffsetNs = output.lastTimestampNs() + concatenationGapNs - reader.timestampNs(0);
+            qCWarning(PING_LOGEDITOR) << input->file.fileName() << "overlaps the previous log, it is moved"
+                                      << timestampOffsetNs / 1000000 << "ms later.";
+        }
+        if (!output.append(*input, 0, reader.size(), timestampOffsetNs)) {
+            return false;
+        }
+    }
+    return output.close();
+}
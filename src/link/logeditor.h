@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QLoggingCategory>
+#include <QStringList>
+
+Q_DECLARE_LOGGING_CATEGORY(PING_LOGEDITOR)
+
+/**
+ * @brief Cut, split and concatenate sensor logs
+ *  Records are never decoded, the stored bytes are copied in bulk from the input files
+ *  and the sidecar index of the output is created from the input index.
+ *  v1 logs are edited at record boundaries, v2 logs at chunk boundaries,
+ *  so a v2 range can include up to a chunk of records around its limits.
+ */
+class LogEditor {
+public:
+    /**
+     * @brief Copy a time range of a log to a new log
+     *
+     * @param inputFileName
+     * @param outputFileName
+     * @param startNs beginning of the range, from the beginning of the log
+     * @param endNs end of the range, from the beginning of the log
+     * @return true
+     * @return false
+     */
+    static bool extract(const QString& inputFileName, const QString& outputFileName, qint64 startNs, qint64 endNs);
+
+    /**
+     * @brief Split a log in parts of limited size or duration
+     *  Parts are named like the rotated logs of LogFileWriter
+     *
+     * @param inputFileName
+     * @param outputFileName name of the first part
+     * @param maxSize maximum size of each part in bytes, disabled with 0
+     * @param maxDurationNs maximum duration of each part, disabled with 0
+     * @return QStringList created parts, empty on error
+     */
+    static QStringList split(
+        const QString& inputFileName, const QString& outputFileName, qint64 maxSize, qint64 maxDurationNs);
+
+    /**
+     * @brief Concatenate logs with the same format and sensor in a new log
+     *  A log that starts before the end of the previous one has its record timestamps moved after it
+     *
+     * @param inputFileNames logs in chronological order
+     * @param outputFileName
+     * @return true
+     * @return false
+     */
+    static bool concatenate(const QStringList& inputFileNames, const QString& outputFileName);
+};
@@ -0,0 +1,345 @@
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QTime>
+#include <QtEndian>
+
+#include <algorithm>
+
+#include "abstractlink.h"
+#include "logfilereader.h"
+#include "logformat.h"
+#include "logger.h"
+
+PING_LOGGING_CATEGORY(PING_LOGFILEREADER, "ping.logfilereader")
+
+namespace {
+// QDataStream uses 0xFFFFFFFF as length of null strings and byte arrays
+const quint32 nullLength = 0xffffffff;
+const qint64 dayNs = 24LL * 60 * 60 * 1000 * 1000 * 1000;
+
+/**
+ * @brief v1 timestamps are a time of the day, unwrap them to be monotonic
+ *
+ * @param timestampNs time of the day
+ * @param lastTimestampNs last monotonic timestamp, updated with the new one
+ * @return qint64 monotonic timestamp
+ */
+qint64 unwrapTimestamp(qint64 timestampNs, qint64& lastTimestampNs)
+{
+    qint64 monotonicTimestampNs = timestampNs + (lastTimestampNs / dayNs) * dayNs;
+    if (monotonicTimestampNs + dayNs / 2 < lastTimestampNs) {
+        monotonicTimestampNs += dayNs;
+    }
+    lastTimestampNs = monotonicTimestampNs;
+    return monotonicTimestampNs;
+}
+} // namespace
+
+bool LogFileReader::open(const QString& fileName, qint64 dataOffset, uint version)
+{
+    close();
+
+    _dataOffset = dataOffset;
+    _version = version;
+    _file.setFileName(fileName);
+    if (!_file.open(QIODevice::ReadOnly)) {
+        qCWarning(PING_LOGFILEREADER) << "Failed to open log file:" << _file.errorString();
+        return false;
+    }
+
+    _mapSize = _file.size();
+    _map = _file.map(0, _mapSize);
+    if (!_map) {
+        qCWarning(PING_LOGFILEREADER) << "Failed to map log file:" << _file.errorString();
+        close();
+        return false;
+    }
+
+    if (_index.load(fileName, _mapSize)) {
+        return true;
+    }
+
+    // Old logs or interrupted recordings, index once and keep it for the next time
+    QElapsedTimer timer;
+    timer.start();
+    if (_version < 2) {
+        scanV1(dataOffset);
+    } else {
+        scanV2(dataOffset);
+    }
+    qCDebug(PING_LOGFILEREADER) << "Indexed" << _index.size() << "records in" << timer.elapsed() << "ms.";
+    if (!_readOnly) {
+        _index.save(fileName, _mapSize);
+    }
+
+    return true;
+}
+
+void LogFileReader::scanV1(qint64 dataOffset)
+{
+    _index.clear();
+
+    qint64 lastTimestampNs = 0;
+    qint64 position = dataOffset;
+    qint64 nextPosition;
+    while ((nextPosition = nextRecord(position)) > 0) {
+        _index.append(unwrapTimestamp(rawTimestampNs(position), lastTimestampNs), position);
+        position = nextPosition;
+    }
+}
+
+void LogFileReader::scanV2(qint64 dataOffset)
+{
+    _index.clear();
+
+    // Only chunk headers are necessary, records are located when the chunk is used
+    qint64 position = dataOffset;
+    while (position + LogFormat::chunkHeaderLength <= _mapSize) {
+        const auto header = LogFormat::readChunkHeader(_map + position);
+        const qint64 payloadPosition = position + LogFormat::chunkHeaderLength;
+        if (header.magic != LogFormat::chunkMagic) {
+            qCWarning(PING_LOGFILEREADER) << "Invalid chunk header at" << position;
+            break;
+        }
+        if (payloadPosition + header.payloadLength > _mapSize) {
+            qCWarning(PING_LOGFILEREADER) << "Last chunk is truncated.";
+            break;
+        }
+
+        // The header has the first timestamp, compressed payloads are not expanded
+        const auto payload = reinterpret_cast<const char*>(_map + payloadPosition);
+        if (LogFormat::crc32(payload, header.payloadLength) != header.crc) {
+            qCWarning(PING_LOGFILEREADER) << "Chunk with invalid CRC at" << position << "will be ignored.";
+        } else if (header.numberOfRecords > 0) {
+            _index.appendChunk(header.firstTimestampNs, position, header.numberOfRecords);
+        }
+
+        position = payloadPosition + header.payloadLength;
+    }
+}
+
+qint64 LogFileReader::nextRecord(qint64 position) const
+{
+    // v1 records are a QDataStream pair of QString (time) and QByteArray (data),
+    // only the length fields are necessary to jump between them
+    if (position + 4 > _mapSize) {
+        return -1;
+    }
+
+    const quint32 timeLength = readUint32(position);
+    // An empty time marks the end of the log
+    if (timeLength == 0 || timeLength == nullLength) {
+        return -1;
+    }
+
+    const qint64 dataPosition = position + 4 + timeLength;
+    if (dataPosition + 4 > _mapSize) {
+        return -1;
+    }
+
+    quint32 dataLength = readUint32(dataPosition);
+    dataLength = dataLength == nullLength ? 0 : dataLength;
+    const qint64 nextPosition = dataPosition + 4 + dataLength;
+    if (nextPosition > _mapSize) {
+        qCWarning(PING_LOGFILEREADER) << "Last record is truncated.";
+        return -1;
+    }
+
+    return nextPosition;
+}
+
+const LogFileReader::Block& LogFileReader::block(int checkpoint) const
+{
+    if (_block.checkpoint == checkpoint) {
+        return _block;
+    }
+
+    const auto& checkpoints = _index.checkpoints();
+    const int lastPackage
+        = checkpoint + 1 < checkpoints.size() ? checkpoints[checkpoint + 1].packageIndex : _index.size();
+    const int numberOfRecords = lastPackage - checkpoints[checkpoint].packageIndex;
+
+    _block.checkpoint = checkpoint;
+    _block.base = _map;
+    _block.buffer.clear();
+    _block.positions.fill(checkpoints[checkpoint].offset, numberOfRecords);
+    _block.dataOffsets.fill(0, numberOfRecords);
+    _block.dataLengths.fill(0, numberOfRecords);
+    _block.timestamps.fill(0, numberOfRecords);
+
+    if (_version < 2) {
+        loadBlockV1(checkpoint, numberOfRecords);
+    } else {
+        loadBlockV2(checkpoint, numberOfRecords);
+    }
+
+    return _block;
+}
+
+void LogFileReader::loadBlockV1(int checkpoint, int numberOfRecords) const
+{
+    const auto& start = _index.checkpoints()[checkpoint];
+    qint64 position = start.offset;
+
+    // Index timestamps are monotonic, even for concatenated logs, records keep their distance to the checkpoint
+    qint64 lastTimestampNs = rawTimestampNs(position);
+    const qint64 timestampOffsetNs = start.timestampNs - lastTimestampNs;
+    for (int i = 0; i < numberOfRecords && position > 0; i++) {
+        const qint64 dataPosition = position + 4 + readUint32(position);
+        const quint32 dataLength = readUint32(dataPosition);
+        _block.positions[i] = position;
+        _block.dataOffsets[i] = dataPosition + 4;
+        _block.dataLengths[i] = dataLength == nullLength ? 0 : dataLength;
+        _block.timestamps[i] = unwrapTimestamp(rawTimestampNs(position), lastTimestampNs) + timestampOffsetNs;
+        position = nextRecord(position);
+    }
+}
+
+void LogFileReader::loadBlockV2(int checkpoint, int numberOfRecords) const
+{
+    const qint64 chunkPosition = _index.checkpoints()[checkpoint].offset;
+    const auto header = LogFormat::readChunkHeader(_map + chunkPosition);
+    qint64 position = chunkPosition + LogFormat::chunkHeaderLength;
+    qint64 end = position + header.payloadLength;
+
+    if (header.flags & LogFormat::compressedChunkFlag) {
+        _block.buffer = qUncompress(_map + position, header.payloadLength);
+        _block.base = reinterpret_cast<const uchar*>(_block.buffer.constData());
+        position = 0;
+        end = _block.buffer.size();
+    }
+
+    // Index timestamps are monotonic, even for concatenated logs that restart their clock
+    const uchar* base = _block.base;
+    const qint64 timestampOffsetNs = position + LogFormat::recordHeaderLength <= end
+        ? _index.checkpoints()[checkpoint].timestampNs - qFromLittleEndian<quint64>(base + position + 4)
+        : 0;
+    for (int i = 0; i < numberOfRecords && position + LogFormat::recordHeaderLength <= end; i++) {
+        const quint32 dataLength = qFromLittleEndian<quint32>(base + position);
+        if (position + LogFormat::recordHeaderLength + dataLength > end) {
+            qCWarning(PING_LOGFILEREADER) << "Record goes beyond chunk limits at" << chunkPosition;
+            break;
+        }
+        _block.timestamps[i] = qFromLittleEndian<quint64>(base + position + 4) + timestampOffsetNs;
+        _block.dataOffsets[i] = position + LogFormat::recordHeaderLength;
+        _block.dataLengths[i] = dataLength;
+        position += LogFormat::recordHeaderLength + dataLength;
+    }
+}
+
+void LogFileReader::close()
+{
+    if (_map) {
+        _file.unmap(const_cast<uchar*>(_map));
+        _map = nullptr;
+    }
+    _mapSize = 0;
+    _dataOffset = 0;
+    _version = 0;
+    _index.clear();
+    _block = {};
+    _file.close();
+}
+
+quint32 LogFileReader::readUint32(qint64 position) const { return qFromBigEndian<quint32>(_map + position); }
+
+qint64 LogFileReader::rawTimestampNs(qint64 position) const
+{
+    const quint32 timeLength = readUint32(position);
+    // UTF-16 big endian string
+    const uchar* time = _map + position + 4;
+
+    int msecs = 0;
+    if (timeLength == static_cast<quint32>(AbstractLink::timeFormat().size() * 2)) {
+        // Fast path for hh:mm:ss.zzz, digits are in the low byte of each character
+        auto digit = [time](int character) { return time[2 * character + 1] - '0'; };
+        msecs = ((digit(0) * 10 + digit(1)) * 3600 + (digit(3) * 10 + digit(4)) * 60 + digit(6) * 10 + digit(7)) * 1000
+            + digit(9) * 100 + digit(10) * 10 + digit(11);
+    } else {
+        QString timeString(timeLength / 2, Qt::Uninitialized);
+        for (int i = 0; i < timeString.size(); i++) {
+            timeString[i] = QChar(qFromBigEndian<quint16>(time + 2 * i));
+        }
+        msecs = QTime::fromString(timeString, AbstractLink::timeFormat()).msecsSinceStartOfDay();
+    }
+
+    return static_cast<qint64>(msecs) * 1000000;
+}
+
+qint64 LogFileReader::timestampNs(int index) const
+{
+    if (index < 0 || index >= size()) {
+        return 0;
+    }
+
+    QMutexLocker locker(&_mutex);
+    const int checkpoint = _index.checkpointForPackage(index);
+    return block(checkpoint).timestamps[index - _index.checkpoints()[checkpoint].packageIndex];
+}
+
+QByteArray LogFileReader::data(int index) const
+{
+    if (index < 0 || index >= size()) {
+        return {};
+    }
+
+    QMutexLocker locker(&_mutex);
+    const int checkpoint = _index.checkpointForPackage(index);
+    const int blockIndex = index - _index.checkpoints()[checkpoint].packageIndex;
+    const auto& recordBlock = block(checkpoint);
+    return QByteArray(reinterpret_cast<const char*>(recordBlock.base + recordBlock.dataOffsets[blockIndex]),
+        recordBlock.dataLengths[blockIndex]);
+}
+
+qint64 LogFileReader::recordPosition(int index) const
+{
+    if (index < 0 || index >= size()) {
+        return 0;
+    }
+
+    QMutexLocker locker(&_mutex);
+    const int checkpoint = _index.checkpointForPackage(index);
+    return block(checkpoint).positions[index - _index.checkpoints()[checkpoint].packageIndex];
+}
+
+qint64 LogFileReader::dataEnd() const
+{
+    if (size() == 0) {
+        return 0;
+    }
+
+    if (_version < 2) {
+        return nextRecord(recordPosition(size() - 1));
+    }
+
+    const qint64 chunkPosition = _index.checkpoints().last().offset;
+    return chunkPosition + LogFormat::chunkHeaderLength
+        + LogFormat::readChunkHeader(_map + chunkPosition).payloadLength;
+}
+
+int LogFileReader::indexForTimestamp(qint64 timestampNs) const
+{
+    if (size() == 0) {
+        return 0;
+    }
+
+    QMutexLocker locker(&_mutex);
+    const int checkpoint = _index.checkpointForTimestamp(timestampNs);
+    const auto& timestamps = block(checkpoint).timestamps;
+    const auto it = std::upper_bound(timestamps.cbegin(), timestamps.cend(), timestampNs);
+    const int blockPosition = std::max(0, static_cast<int>(it - timestamps.cbegin()) - 1);
+    return _index.checkpoints()[checkpoint].packageIndex + blockPosition;
+}
+
+void LogFileReader::saveLastPackageIndex(int packageIndex)
+{
+    if (!isOpen() || _readOnly) {
+        return;
+    }
+
+    QMutexLocker locker(&_mutex);
+    _index.setLastPackageIndex(packageIndex);
+    _index.save(_file.fileName(), _mapSize);
+}
+
+LogFileReader::~LogFileReader() { close(); }
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QLoggingCategory>
+#include <QMutex>
+#include <QVector>
+
+#include "logindex.h"
+
+Q_DECLARE_LOGGING_CATEGORY(PING_LOGFILEREADER)
+
+/**
+ * @brief Random access to the records of a sensor log
+ *  The file is memory mapped and records are decoded on demand.
+ *  Only the checkpoints of the sidecar index and the block in use are kept in memory,
+ *  compressed chunks are only decompressed when accessed.
+ */
+class LogFileReader {
+public:
+    /**
+     * @brief Construct a new Log File Reader object
+     *
+     */
+    LogFileReader() = default;
+
+    /**
+     * @brief Destroy the Log File Reader object
+     *
+     */
+    ~LogFileReader();
+
+    /**
+     * @brief Map the log file and load or build its index
+     *
+     * @param fileName
+     * @param dataOffset position of the first record, after the log header
+     * @param version log format version from the header
+     * @return true
+     * @return false
+     */
+    bool open(const QString& fileName, qint64 dataOffset, uint version);
+
+    /**
+     * @brief Keep the sidecar index untouched
+     *  Batch tools read logs from directories they do not own, an existing index is still used
+     *  but a missing one is built in memory and the last position is not saved.
+     *
+     * @param readOnly
+     */
+    void setReadOnly(bool readOnly) { _readOnly = readOnly; };
+
+    /**
+     * @brief Unmap and close the log file
+     *
+     */
+    void close();
+
+    /**
+     * @brief Check if log is mapped
+     *
+     * @return true
+     * @return false
+     */
+    bool isOpen() const { return _map != nullptr; };
+
+    /**
+     * @brief Return the log file name
+     *
+     * @return QString
+     */
+    QString fileName() const { return _file.fileName(); };
+
+    /**
+     * @brief Return the position of the first record, after the log header
+     *
+     * @return qint64
+     */
+    qint64 dataOffset() const { return _dataOffset; };
+
+    /**
+     * @brief Return the log format version
+     *
+     * @return uint
+     */
+    uint version() const { return _version; };
+
+    /**
+     * @brief Return the number of records
+     *
+     * @return int
+     */
+    int size() const { return _index.size(); };
+
+    /**
+     * @brief Return the monotonic record timestamp
+     *
+     * @param index
+     * @return qint64 timestamp in nanoseconds
+     */
+    qint64 timestampNs(int index) const;
+
+    /**
+     * @brief Return a copy of the record data
+     *  The copy keeps the record valid after the file is closed
+     *
+     * @param index
+     * @return QByteArray
+     */
+    QByteArray data(int index) const;
+
+    /**
+     * @brief Return the last record at or before the timestamp
+     *
+     * @param timestampNs
+     * @return int
+     */
+    int indexForTimestamp(qint64 timestampNs) const;
+
+    /**
+     * @brief Return the log index
+     *
+     * @return const LogIndex&
+     */
+    const LogIndex& index() const { return _index; };
+
+    /**
+     * @brief Return the file position where a record is stored
+     *  v2 records share the position of their chunk
+     *
+     * @param index
+     * @return qint64
+     */
+    qint64 recordPosition(int index) const;
+
+    /**
+     * @brief Return the file position after the last record
+     *
+     * @return qint64
+     */
+    qint64 dataEnd() const;
+
+    /**
+     * @brief Return the last package played in a previous session
+     *
+     * @return int
+     */
+    int lastPackageIndex() const { return _index.lastPackageIndex(); };
+
+    /**
+     * @brief Save the last package played in the sidecar index
+     *
+     * @param packageIndex
+     */
+    void saveLastPackageIndex(int packageIndex);
+
+private:
+    Q_DISABLE_COPY(LogFileReader)
+
+    /**
+     * @brief Records between two checkpoints
+     *
+     */
+    struct Block {
+        int checkpoint = -1;
+        // Records are in the mapped file or in the decompressed chunk
+        const uchar* base = nullptr;
+        QByteArray buffer;
+        QVector<qint64> positions;
+        QVector<qint64> dataOffsets;
+        QVector<quint32> dataLengths;
+        QVector<qint64> timestamps;
+    };
+
+    const Block& block(int checkpoint) const;
+    void loadBlockV1(int checkpoint, int numberOfRecords) const;
+    void loadBlockV2(int checkpoint, int numberOfRecords) const;
+    qint64 nextRecord(qint64 position) const;
+    qint64 rawTimestampNs(qint64 position) const;
+    quint32 readUint32(qint64 position) const;
+    void scanV1(qint64 dataOffset);
+    void scanV2(qint64 dataOffset);
+
+    QFile _file;
+    const uchar* _map = nullptr;
+    qint64 _mapSize = 0;
+    qint64 _dataOffset = 0;
+    uint _version = 0;
+    bool _readOnly = false;
+    LogIndex _index;
+
+    // Playback and interface access the log from different threads
+    mutable QMutex _mutex;
+    mutable Block _block;
+};
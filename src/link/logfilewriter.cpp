@@ -0,0 +1,364 @@
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QTime>
+#include <QtEndian>
+
+#if defined(Q_OS_UNIX)
+#include <unistd.h>
+#elif defined(Q_OS_WIN)
+#include <io.h>
+#endif
+
+#include "abstractlink.h"
+#include "logfilewriter.h"
+#include "logformat.h"
+#include "logger.h"
+
+PING_LOGGING_CATEGORY(PING_LOGFILEWRITER, "ping.logfilewriter")
+
+namespace {
+// Chunks are accumulated to be written together
+const int writeBufferSize = 256 * 1024;
+// Maximum time that records can wait in memory when they are slow
+const int maxWriteIntervalMs = 1000;
+} // namespace
+
+bool LogFileWriter::open(const QString& fileName, const LogSensorStruct& logSensorStruct)
+{
+    close();
+
+    _logSensorStruct = logSensorStruct;
+    _fileName = fileName;
+    _part = 0;
+    _front.clear();
+    _frontBytes = 0;
+    _flushRequested = false;
+    _stop = false;
+    _statistics = {};
+
+    if (!openFile(fileName)) {
+        return false;
+    }
+
+    _open = true;
+    _thread.reset(QThread::create([this] { run(); }));
+    _thread->setObjectName(QStringLiteral("LogFileWriter"));
+    _thread->start();
+    return true;
+}
+
+bool LogFileWriter::openFile(const QString& fileName)
+{
+    _file.setFileName(fileName);
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(PING_LOGFILEWRITER) << "Failed to create log file:" << _file.errorString();
+        return false;
+    }
+
+    _stream.setDevice(&_file);
+    _stream << _logSensorStruct;
+    _index.startRecording(fileName);
+
+    _fileStartTimestampNs = -1;
+    _chunk.reserve(LogFormat::maxChunkBytes + LogFormat::chunkHeaderLength);
+    _writeBuffer.reserve(writeBufferSize + LogFormat::maxChunkBytes + LogFormat::chunkHeaderLength);
+    _lastWrite.start();
+    _lastSync.start();
+
+    QMutexLocker locker(&_mutex);
+    _statistics.files++;
+    return true;
+}
+
+void LogFileWriter::closeFile()
+{
+    if (!_file.isOpen()) {
+        return;
+    }
+
+    writeChunk();
+    writeBuffer();
+    if (_configuration.fsyncPolicy == FsyncPolicy::Never) {
+        _file.flush();
+    } else {
+        sync();
+    }
+
+    _index.finishRecording(_file.size());
+    _stream.setDevice(nullptr);
+    _file.close();
+}
+
+void LogFileWriter::append(qint64 timestampNs, const QByteArray& data)
+{
+    if (!_open) {
+        return;
+    }
+
+    QMutexLocker locker(&_mutex);
+    // The last swap of the writer thread happens after stop, later records would be lost
+    if (_stop) {
+        return;
+    }
+
+    if (_frontBytes + data.size() > _configuration.queueCapacity) {
+        _statistics.droppedRecords++;
+        return;
+    }
+
+    _front.append({timestampNs, data});
+    _frontBytes += data.size();
+    _statistics.maxQueueBytes = std::max(_statistics.maxQueueBytes, _frontBytes);
+    _recordsAvailable.wakeOne();
+}
+
+void LogFileWriter::run()
+{
+    bool stop = false;
+    while (!stop) {
+        bool flushRequested;
+        {
+            // Producers continue in the empty buffer while the other one is written
+            QMutexLocker locker(&_mutex);
+            if (_front.isEmpty() && !_flushRequested && !_stop) {
+                _recordsAvailable.wait(&_mutex, maxWriteIntervalMs);
+            }
+            _back.swap(_front);
+            _frontBytes = 0;
+            flushRequested = _flushRequested;
+            stop = _stop;
+        }
+
+        for (const auto& record : qAsConst(_back)) {
+            writeRecord(record);
+        }
+        const int numberOfRecords = _back.size();
+        _back.clear();
+
+        // Do not keep records in memory for too long when they are slow
+        if (flushRequested || _lastWrite.elapsed() > maxWriteIntervalMs) {
+            writeChunk();
+            writeBuffer();
+            _file.flush();
+        }
+
+        if (_configuration.fsyncPolicy == FsyncPolicy::Interval
+            && _lastSync.elapsed() > _configuration.fsyncIntervalMs) {
+            sync();
+        }
+
+        QMutexLocker locker(&_mutex);
+        _statistics.writtenRecords += numberOfRecords;
+        if (flushRequested) {
+            _flushRequested = false;
+            _flushed.wakeAll();
+        }
+    }
+
+    closeFile();
+}
+
+void LogFileWriter::writeRecord(const Record& record)
+{
+    if (_fileStartTimestampNs < 0) {
+        _fileStartTimestampNs = record.timestampNs;
+    }
+
+    const bool rotateBySize = _configuration.rotationSize
+        && _file.pos() + _writeBuffer.size() + _chunk.size() >= _configuration.rotationSize;
+    const bool rotateByDuration = _configuration.rotationDurationNs
+        && record.timestampNs - _fileStartTimestampNs >= _configuration.rotationDurationNs;
+    if (rotateBySize || rotateByDuration) {
+        closeFile();
+        const QString fileName = partFileName(_fileName, ++_part);
+        qCDebug(PING_LOGFILEWRITER) << "Rotating log to:" << fileName;
+        if (!openFile(fileName)) {
+            return;
+        }
+        _fileStartTimestampNs = record.timestampNs;
+    }
+
+    if (!_file.isOpen()) {
+        return;
+    }
+
+    if (_logSensorStruct.version < 2) {
+        static const qint64 dayMSecs = 24 * 60 * 60 * 1000;
+        const qint64 msecs = record.timestampNs / 1000000;
+        const QString time = QTime::fromMSecsSinceStartOfDay(msecs % dayMSecs).toString(AbstractLink::timeFormat());
+        _index.append(record.timestampNs, _file.pos());
+        _stream << time << record.data;
+        return;
+    }
+
+    if (_chunkRecords == 0) {
+        // Space for the chunk header, filled when the chunk is written
+        _chunk.resize(LogFormat::chunkHeaderLength);
+        _chunkTimestampNs = record.timestampNs;
+    }
+
+    uchar recordHeader[LogFormat::recordHeaderLength];
+    qToLittleEndian<quint32>(record.data.size(), recordHeader);
+    qToLittleEndian<quint64>(record.timestampNs, recordHeader + 4);
+    _chunk.append(reinterpret_cast<const char*>(recordHeader), sizeof(recordHeader));
+    _chunk.append(record.data);
+    _chunkRecords++;
+
+    if (_chunkRecords >= LogFormat::maxChunkRecords || _chunk.size() >= LogFormat::maxChunkBytes
+        || record.timestampNs - _chunkTimestampNs >= LogFormat::maxChunkDurationNs) {
+        writeChunk();
+    }
+}
+
+void LogFileWriter::writeChunk()
+{
+    if (_chunkRecords == 0) {
+        return;
+    }
+
+    quint32 flags = 0;
+    const int rawPayloadLength = _chunk.size() - LogFormat::chunkHeaderLength;
+    qint64 compressionNs = 0;
+
+    if (_configuration.compression) {
+        QElapsedTimer timer;
+        timer.start();
+        const QByteArray compressed = qCompress(
+            reinterpret_cast<const uchar*>(_chunk.constData()) + LogFormat::chunkHeaderLength, rawPayloadLength);
+        // Keep raw chunks that do not compress
+        if (compressed.size() < rawPayloadLength) {
+            _chunk.resize(LogFormat::chunkHeaderLength);
+            _chunk.append(compressed);
+            flags |= LogFormat::compressedChunkFlag;
+        }
+        compressionNs = timer.nsecsElapsed();
+    }
+
+    const char* payload = _chunk.constData() + LogFormat::chunkHeaderLength;
+    const int payloadLength = _chunk.size() - LogFormat::chunkHeaderLength;
+    const LogFormat::ChunkHeader header {LogFormat::chunkMagic, flags, static_cast<quint32>(_chunkRecords),
+        static_cast<quint32>(payloadLength), LogFormat::crc32(payload, payloadLength),
+        static_cast<quint64>(_chunkTimestampNs)};
+    LogFormat::writeChunkHeader(header, reinterpret_cast<uchar*>(_chunk.data()));
+
+    // Chunk offset in the file, after the data that is still in the write buffer
+    _index.appendChunk(_chunkTimestampNs, _file.pos() + _writeBuffer.size(), _chunkRecords);
+    _writeBuffer.append(_chunk);
+
+    {
+        QMutexLocker locker(&_mutex);
+        _statistics.rawBytes += rawPayloadLength;
+        _statistics.storedBytes += payloadLength;
+        _statistics.compressionNs += compressionNs;
+    }
+
+    // Keep the reserved capacity for the next chunk
+    _chunk.resize(0);
+    _chunkRecords = 0;
+
+    if (_writeBuffer.size() >= writeBufferSize) {
+        writeBuffer();
+    }
+}
+
+void LogFileWriter::writeBuffer()
+{
+    _lastWrite.restart();
+    if (_writeBuffer.isEmpty()) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    if (_file.write(_writeBuffer) != _writeBuffer.size()) {
+        qCWarning(PING_LOGFILEWRITER) << "Failed to write log:" << _file.errorString();
+    }
+    if (_configuration.fsyncPolicy == FsyncPolicy::EveryWrite) {
+        sync();
+    }
+    const qint64 latencyUs = timer.nsecsElapsed() / 1000;
+    _writeBuffer.resize(0);
+
+    QMutexLocker locker(&_mutex);
+    _statistics.writes++;
+    _statistics.totalWriteLatencyUs += latencyUs;
+    _statistics.maxWriteLatencyUs = std::max(_statistics.maxWriteLatencyUs, latencyUs);
+}
+
+void LogFileWriter::sync()
+{
+    _file.flush();
+#if defined(Q_OS_UNIX)
+    ::fsync(_file.handle());
+#elif defined(Q_OS_WIN)
+    ::_commit(_file.handle());
+#endif
+    _lastSync.restart();
+}
+
+void LogFileWriter::flush()
+{
+    if (!_open) {
+        return;
+    }
+
+    QMutexLocker locker(&_mutex);
+    _flushRequested = true;
+    _recordsAvailable.wakeOne();
+    while (_flushRequested) {
+        _flushed.wait(&_mutex);
+    }
+}
+
+void LogFileWriter::close()
+{
+    if (!_open) {
+        return;
+    }
+
+    {
+        // Records accepted before stop are in the buffer of the last swap
+        QMutexLocker locker(&_mutex);
+        _open = false;
+        _stop = true;
+        _recordsAvailable.wakeOne();
+    }
+    _thread->wait();
+    _thread.reset();
+
+    const Statistics counters = statistics();
+    qCDebug(PING_LOGFILEWRITER) << "Log closed with" << counters.writtenRecords << "records in" << counters.files
+                                << "files," << counters.writes << "writes and max write latency of"
+                                << counters.maxWriteLatencyUs << "us.";
+    if (counters.droppedRecords) {
+        qCWarning(PING_LOGFILEWRITER) << "Storage could not keep up," << counters.droppedRecords
+                                      << "records were dropped.";
+    }
+    if (_configuration.compression && counters.rawBytes) {
+        qCDebug(PING_LOGFILEWRITER) << "Records compressed from" << counters.rawBytes << "to" << counters.storedBytes
+                                    << "bytes in" << counters.compressionNs / 1000000 << "ms.";
+    }
+}
+
+LogFileWriter::Statistics LogFileWriter::statistics() const
+{
+    QMutexLocker locker(&_mutex);
+    return _statistics;
+}
+
+QString LogFileWriter::partFileName(const QString& fileName, int part)
+{
+    if (part == 0) {
+        return fileName;
+    }
+
+    const QFileInfo fileInfo(fileName);
+    QString partName = QStringLiteral("%1_%2").arg(fileInfo.completeBaseName()).arg(part, 3, 10, QChar('0'));
+    if (!fileInfo.suffix().isEmpty()) {
+        partName += QStringLiteral(".") + fileInfo.suffix();
+    }
+    return fileInfo.dir().filePath(partName);
+}
+
+LogFileWriter::~LogFileWriter() { close(); }
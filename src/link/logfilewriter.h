@@ -0,0 +1,198 @@
+#pragma once
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QLoggingCategory>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <memory>
+
+#include "logindex.h"
+#include "logsensorstruct.h"
+
+Q_DECLARE_LOGGING_CATEGORY(PING_LOGFILEWRITER)
+
+/**
+ * @brief Write sensor logs
+ *  Records are queued from any thread and written by the writer thread, in the format of the header version.
+ *  v2 records are grouped in chunks that are optionally compressed, chunks are accumulated in large writes.
+ *  The sidecar index is updated at every chunk and logs can be rotated by size or duration.
+ */
+class LogFileWriter {
+public:
+    /**
+     * @brief When data should be forced to the storage
+     *
+     */
+    enum class FsyncPolicy {
+        Never, // Let the operating system decide
+        EveryWrite, // After each write, safest and slowest
+        Interval, // At most once per fsyncIntervalMs
+    };
+
+    /**
+     * @brief Writer configuration
+     *
+     */
+    struct Configuration {
+        bool compression = false;
+        FsyncPolicy fsyncPolicy = FsyncPolicy::Never;
+        int fsyncIntervalMs = 5000;
+        // Start a new file when one of the limits is reached, disabled with 0
+        qint64 rotationSize = 0;
+        qint64 rotationDurationNs = 0;
+        // Records are dropped when the storage can't keep up
+        qint64 queueCapacity = 32 * 1024 * 1024;
+    };
+
+    /**
+     * @brief Writer counters
+     *
+     */
+    struct Statistics {
+        qint64 droppedRecords = 0;
+        qint64 writtenRecords = 0;
+        qint64 writes = 0;
+        qint64 maxWriteLatencyUs = 0;
+        qint64 totalWriteLatencyUs = 0;
+        qint64 maxQueueBytes = 0;
+        qint64 rawBytes = 0;
+        qint64 storedBytes = 0;
+        qint64 compressionNs = 0;
+        int files = 0;
+    };
+
+    /**
+     * @brief Construct a new Log File Writer object
+     *
+     */
+    LogFileWriter() = default;
+
+    /**
+     * @brief Destroy the Log File Writer object
+     *
+     */
+    ~LogFileWriter();
+
+    /**
+     * @brief Create the log file, write its header and start the writer thread
+     *
+     * @param fileName
+     * @param logSensorStruct
+     * @return true
+     * @return false
+     */
+    bool open(const QString& fileName, const LogSensorStruct& logSensorStruct);
+
+    /**
+     * @brief Check if log file is open
+     *
+     * @return true
+     * @return false
+     */
+    bool isOpen() const { return _open; };
+
+    /**
+     * @brief Set the writer configuration
+     *  It should be set before open
+     *
+     * @param configuration
+     */
+    void setConfiguration(const Configuration& configuration) { _configuration = configuration; };
+
+    /**
+     * @brief Enable chunk compression
+     *  Only available for v2 logs, it should be set before open
+     *
+     * @param enabled
+     */
+    void setCompression(bool enabled) { _configuration.compression = enabled; };
+
+    /**
+     * @brief Queue a new record, can be called from any thread
+     *
+     * @param timestampNs monotonic timestamp
+     * @param data
+     */
+    void append(qint64 timestampNs, const QByteArray& data);
+
+    /**
+     * @brief Wait until all queued records are in the file
+     *
+     */
+    void flush();
+
+    /**
+     * @brief Write everything, stop the writer thread and close the log and its index
+     *
+     */
+    void close();
+
+    /**
+     * @brief Return the writer counters
+     *
+     * @return Statistics
+     */
+    Statistics statistics() const;
+
+    /**
+     * @brief Return the name of a rotated log file
+     *
+     * @param fileName first log file name
+     * @param part rotation number, 0 for the first file
+     * @return QString
+     */
+    static QString partFileName(const QString& fileName, int part);
+
+private:
+    Q_DISABLE_COPY(LogFileWriter)
+
+    struct Record {
+        qint64 timestampNs;
+        QByteArray data;
+    };
+
+    bool openFile(const QString& fileName);
+    void closeFile();
+    void run();
+    void writeRecord(const Record& record);
+    void writeChunk();
+    void writeBuffer();
+    void sync();
+
+    Configuration _configuration;
+    LogSensorStruct _logSensorStruct;
+    QString _fileName;
+    std::atomic<bool> _open {false};
+
+    // Shared between producers and the writer thread
+    mutable QMutex _mutex;
+    QWaitCondition _recordsAvailable;
+    QWaitCondition _flushed;
+    QVector<Record> _front;
+    qint64 _frontBytes = 0;
+    bool _flushRequested = false;
+    bool _stop = false;
+    Statistics _statistics;
+
+    // Writer thread only
+    std::unique_ptr<QThread> _thread;
+    QVector<Record> _back;
+    QFile _file;
+    QDataStream _stream;
+    LogIndex _index;
+    int _part = 0;
+    qint64 _fileStartTimestampNs = -1;
+    QByteArray _chunk;
+    int _chunkRecords = 0;
+    qint64 _chunkTimestampNs = 0;
+    QByteArray _writeBuffer;
+    QElapsedTimer _lastWrite;
+    QElapsedTimer _lastSync;
+};
@@ -0,0 +1,48 @@
+#include <QtEndian>
+
+#include <array>
+
+#include "logformat.h"
+
+quint32 LogFormat::crc32(const char* data, qint64 size, quint32 crc)
+{
+    static const auto table = [] {
+        std::array<quint32, 256> table {};
+        for (quint32 i = 0; i < table.size(); i++) {
+            quint32 value = i;
+            for (int bit = 0; bit < 8; bit++) {
+                value = value & 1 ? 0xedb88320 ^ (value >> 1) : value >> 1;
+            }
+            table[i] = value;
+        }
+        return table;
+    }();
+
+    crc = ~crc;
+    for (qint64 i = 0; i < size; i++) {
+        crc = table[(crc ^ static_cast<uchar>(data[i])) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+LogFormat::ChunkHeader LogFormat::readChunkHeader(const uchar* data)
+{
+    return {
+        qFromLittleEndian<quint32>(data),
+        qFromLittleEndian<quint32>(data + 4),
+        qFromLittleEndian<quint32>(data + 8),
+        qFromLittleEndian<quint32>(data + 12),
+        qFromLittleEndian<quint32>(data + 16),
+        qFromLittleEndian<quint64>(data + 20),
+    };
+}
+
+void LogFormat::writeChunkHeader(const ChunkHeader& header, uchar* data)
+{
+    qToLittleEndian<quint32>(header.magic, data);
+    qToLittleEndian<quint32>(header.flags, data + 4);
+    qToLittleEndian<quint32>(header.numberOfRecords, data + 8);
+    qToLittleEndian<quint32>(header.payloadLength, data + 12);
+    qToLittleEndian<quint32>(header.crc, data + 16);
+    qToLittleEndian<quint64>(header.firstTimestampNs, data + 20);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QtGlobal>
+
+/**
+ * @brief On disk layout of sensor log records
+ *
+ *  v1: QDataStream (big endian) sequence of QString time ("hh:mm:ss.zzz") and QByteArray data.
+ *
+ *  v2: sequence of chunks, all values are little endian
+ *      chunk header:
+ *          magic u32 ("PVCK") | flags u32 | number of records u32 | payload length u32 | payload crc32 u32 |
+ *          timestamp of the first record in nanoseconds u64
+ *      payload: number of records times
+ *          data length u32 | monotonic timestamp in nanoseconds u64 | data
+ *      compressed chunks store the payload through qCompress, the crc32 covers the stored bytes.
+ *      The sidecar index holds the offset of each chunk, working as chunk table for random access.
+ */
+namespace LogFormat {
+/**
+ * @brief v2 chunk header
+ *
+ */
+struct ChunkHeader {
+    quint32 magic;
+    quint32 flags;
+    quint32 numberOfRecords;
+    quint32 payloadLength;
+    quint32 crc;
+    // Allows indexing compressed chunks without decompressing them
+    quint64 firstTimestampNs;
+};
+
+const quint32 chunkMagic = 0x4b435650; // "PVCK"
+const quint32 compressedChunkFlag = 1 << 0;
+const int chunkHeaderLength = 28;
+const int recordHeaderLength = 12;
+
+// Chunks are closed when one of the limits is reached
+const int maxChunkRecords = 256;
+const int maxChunkBytes = 64 * 1024;
+const qint64 maxChunkDurationNs = 1000 * 1000 * 1000;
+
+/**
+ * @brief Calculate CRC-32 (IEEE 802.3)
+ *
+ * @param data
+ * @param size
+ * @param crc previous value to continue a calculation
+ * @return quint32
+ */
+quint32 crc32(const char* data, qint64 size, quint32 crc = 0);
+
+/**
+ * @brief Decode a chunk header
+ *
+ * @param data at least chunkHeaderLength bytes
+ * @return ChunkHeader
+ */
+ChunkHeader readChunkHeader(const uchar* data);
+
+/**
+ * @brief Encode a chunk header
+ *
+ * @param header
+ * @param data at least chunkHeaderLength bytes
+ */
+void writeChunkHeader(const ChunkHeader& header, uchar* data);
+} // namespace LogFormat
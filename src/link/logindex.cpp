@@ -0,0 +1,171 @@
+#include <QDebug>
+
+#include <algorithm>
+
+#include "logformat.h"
+#include "logger.h"
+#include "logindex.h"
+
+PING_LOGGING_CATEGORY(PING_LOGINDEX, "ping.logindex")
+
+const QString LogIndex::_validHeader = QStringLiteral("PingViewer sensor log index");
+
+void LogIndex::append(qint64 timestampNs, qint64 offset)
+{
+    if (_size % checkpointInterval == 0) {
+        appendCheckpoint({timestampNs, offset, _size});
+    }
+    _size++;
+}
+
+void LogIndex::appendChunk(qint64 timestampNs, qint64 offset, int numberOfRecords)
+{
+    // Records of the previous chunk can be up to a chunk duration after its beginning
+    if (_size && timestampNs + _timestampOffsetNs < _lastChunkTimestampNs) {
+        _timestampOffsetNs = _lastChunkTimestampNs + 2 * LogFormat::maxChunkDurationNs - timestampNs;
+        qCWarning(PING_LOGINDEX) << "Chunk at" << offset << "goes back in time, records after it are moved"
+                                 << _timestampOffsetNs / 1000000 << "ms later.";
+    }
+    _lastChunkTimestampNs = timestampNs + _timestampOffsetNs;
+
+    appendCheckpoint({_lastChunkTimestampNs, offset, _size});
+    _size += numberOfRecords;
+}
+
+void LogIndex::appendCheckpoint(const Checkpoint& checkpoint)
+{
+    if (_recordingFile.isOpen()) {
+        // Recording does not need the checkpoints in memory
+        writeCheckpoint(_recordingStream, checkpoint);
+    } else {
+        _checkpoints.append(checkpoint);
+    }
+}
+
+int LogIndex::checkpointForPackage(int packageIndex) const
+{
+    auto it = std::upper_bound(_checkpoints.cbegin(), _checkpoints.cend(), packageIndex,
+        [](int index, const Checkpoint& checkpoint) { return index < checkpoint.packageIndex; });
+    return std::max(0, static_cast<int>(it - _checkpoints.cbegin()) - 1);
+}
+
+int LogIndex::checkpointForTimestamp(qint64 timestampNs) const
+{
+    auto it = std::upper_bound(_checkpoints.cbegin(), _checkpoints.cend(), timestampNs,
+        [](qint64 timestamp, const Checkpoint& checkpoint) { return timestamp < checkpoint.timestampNs; });
+    return std::max(0, static_cast<int>(it - _checkpoints.cbegin()) - 1);
+}
+
+void LogIndex::clear()
+{
+    _checkpoints.clear();
+    _lastChunkTimestampNs = 0;
+    _timestampOffsetNs = 0;
+    _lastPackageIndex = 0;
+    _size = 0;
+}
+
+bool LogIndex::load(const QString& logFileName, qint64 logSize)
+{
+    clear();
+
+    QFile file(sidecarFileName(logFileName));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    QString header;
+    qint32 version;
+    qint64 indexedLogSize;
+    qint32 size;
+    qint32 lastPackageIndex;
+    qint32 interval;
+    stream >> header >> version >> indexedLogSize >> size >> lastPackageIndex >> interval;
+
+    if (header != _validHeader || version != _version || interval != checkpointInterval) {
+        qCWarning(PING_LOGINDEX) << "Invalid sidecar index:" << file.fileName();
+        return false;
+    }
+
+    // Log was changed or recording did not finish
+    if (indexedLogSize != logSize) {
+        qCDebug(PING_LOGINDEX) << "Sidecar index is outdated:" << file.fileName();
+        return false;
+    }
+
+    while (!stream.atEnd()) {
+        Checkpoint checkpoint;
+        qint32 packageIndex;
+        stream >> checkpoint.timestampNs >> checkpoint.offset >> packageIndex;
+        checkpoint.packageIndex = packageIndex;
+        _checkpoints.append(checkpoint);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        qCWarning(PING_LOGINDEX) << "Sidecar index is corrupted:" << file.fileName();
+        clear();
+        return false;
+    }
+
+    _size = size;
+    _lastPackageIndex = lastPackageIndex;
+    qCDebug(PING_LOGINDEX) << "Loaded" << _checkpoints.size() << "checkpoints for" << _size << "records.";
+    return true;
+}
+
+bool LogIndex::save(const QString& logFileName, qint64 logSize) const
+{
+    QFile file(sidecarFileName(logFileName));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(PING_LOGINDEX) << "Failed to save sidecar index:" << file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    writeHeader(stream, logSize);
+    for (const auto& checkpoint : _checkpoints) {
+        writeCheckpoint(stream, checkpoint);
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+bool LogIndex::startRecording(const QString& logFileName)
+{
+    clear();
+
+    _recordingFile.setFileName(sidecarFileName(logFileName));
+    if (!_recordingFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(PING_LOGINDEX) << "Failed to create sidecar index:" << _recordingFile.errorString();
+        return false;
+    }
+
+    _recordingStream.setDevice(&_recordingFile);
+    // Invalid log size until the recording finishes
+    writeHeader(_recordingStream, -1);
+    return true;
+}
+
+void LogIndex::finishRecording(qint64 logSize)
+{
+    if (!_recordingFile.isOpen()) {
+        return;
+    }
+
+    // Header has a fixed size, it can be updated in place
+    _recordingFile.seek(0);
+    writeHeader(_recordingStream, logSize);
+    _recordingStream.setDevice(nullptr);
+    _recordingFile.close();
+}
+
+void LogIndex::writeHeader(QDataStream& stream, qint64 logSize) const
+{
+    stream << _validHeader << qint32(_version) << logSize << qint32(_size) << qint32(_lastPackageIndex)
+           << qint32(checkpointInterval);
+}
+
+void LogIndex::writeCheckpoint(QDataStream& stream, const Checkpoint& checkpoint) const
+{
+    stream << checkpoint.timestampNs << checkpoint.offset << qint32(checkpoint.packageIndex);
+}
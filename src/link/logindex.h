@@ -0,0 +1,175 @@
+#pragma once
+
+#include <QDataStream>
+#include <QFile>
+#include <QLoggingCategory>
+#include <QVector>
+
+Q_DECLARE_LOGGING_CATEGORY(PING_LOGINDEX)
+
+/**
+ * @brief Sidecar index of a sensor log
+ *  Maps monotonic timestamps to file offsets and package numbers with a checkpoint every N records,
+ *  or at every chunk for v2 logs.
+ *  The index is written next to the log while recording, or built once for older logs,
+ *  making seek operations O(log n) without scanning the log.
+ */
+class LogIndex {
+public:
+    /**
+     * @brief A position in the log
+     *
+     */
+    struct Checkpoint {
+        qint64 timestampNs;
+        qint64 offset;
+        int packageIndex;
+    };
+
+    /**
+     * @brief Number of records between checkpoints
+     *
+     */
+    static const int checkpointInterval = 256;
+
+    /**
+     * @brief Construct a new Log Index object
+     *
+     */
+    LogIndex() = default;
+
+    /**
+     * @brief Add a new record to the index
+     *  A checkpoint is created every checkpointInterval records
+     *
+     * @param timestampNs
+     * @param offset
+     */
+    void append(qint64 timestampNs, qint64 offset);
+
+    /**
+     * @brief Add a group of records stored together, like a v2 chunk
+     *  A checkpoint is created at the beginning of the group.
+     *  Logs concatenated by other tools restart their clock, groups that go back in time are moved
+     *  after the previous ones with a warning. LogEditor moves each log before indexing it.
+     *
+     * @param timestampNs timestamp of the first record
+     * @param offset
+     * @param numberOfRecords
+     */
+    void appendChunk(qint64 timestampNs, qint64 offset, int numberOfRecords);
+
+    /**
+     * @brief Return all checkpoints
+     *
+     * @return const QVector<Checkpoint>&
+     */
+    const QVector<Checkpoint>& checkpoints() const { return _checkpoints; };
+
+    /**
+     * @brief Return the checkpoint position that contains the package
+     *
+     * @param packageIndex
+     * @return int
+     */
+    int checkpointForPackage(int packageIndex) const;
+
+    /**
+     * @brief Return the last checkpoint position before or at the timestamp
+     *
+     * @param timestampNs
+     * @return int
+     */
+    int checkpointForTimestamp(qint64 timestampNs) const;
+
+    /**
+     * @brief Remove all checkpoints
+     *
+     */
+    void clear();
+
+    /**
+     * @brief Return the last package played
+     *
+     * @return int
+     */
+    int lastPackageIndex() const { return _lastPackageIndex; };
+
+    /**
+     * @brief Set the last package played
+     *
+     * @param packageIndex
+     */
+    void setLastPackageIndex(int packageIndex) { _lastPackageIndex = packageIndex; };
+
+    /**
+     * @brief Return the number of records in the log
+     *
+     * @return int
+     */
+    int size() const { return _size; };
+
+    /**
+     * @brief Load sidecar index of a log
+     *
+     * @param logFileName
+     * @param logSize size of the log file, to check if index is up to date
+     * @return true
+     * @return false
+     */
+    bool load(const QString& logFileName, qint64 logSize);
+
+    /**
+     * @brief Save sidecar index of a log
+     *
+     * @param logFileName
+     * @param logSize
+     * @return true
+     * @return false
+     */
+    bool save(const QString& logFileName, qint64 logSize) const;
+
+    /**
+     * @brief Start to write the sidecar index while the log is recorded
+     *  Checkpoints are written as soon as they are created
+     *
+     * @param logFileName
+     * @return true
+     * @return false
+     */
+    bool startRecording(const QString& logFileName);
+
+    /**
+     * @brief Finish the sidecar index of a recorded log
+     *
+     * @param logSize final size of the log file
+     */
+    void finishRecording(qint64 logSize);
+
+    /**
+     * @brief Return the sidecar file name of a log
+     *
+     * @param logFileName
+     * @return QString
+     */
+    static QString sidecarFileName(const QString& logFileName) { return logFileName + QStringLiteral(".idx"); };
+
+private:
+    Q_DISABLE_COPY(LogIndex)
+
+    void appendCheckpoint(const Checkpoint& checkpoint);
+    void writeHeader(QDataStream& stream, qint64 logSize) const;
+    void writeCheckpoint(QDataStream& stream, const Checkpoint& checkpoint) const;
+
+    QVector<Checkpoint> _checkpoints;
+    qint64 _lastChunkTimestampNs = 0;
+    qint64 _timestampOffsetNs = 0;
+    int _lastPackageIndex = 0;
+    int _size = 0;
+
+    QFile _recordingFile;
+    QDataStream _recordingStream;
+
+    static const QString _validHeader;
+    static const int _version = 1;
+};
@@ -0,0 +1,343 @@
+#include <QDataStream>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QHash>
+#include <QTemporaryFile>
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+
+#include "logger.h"
+#include "logkeyframes.h"
+
+#include "ping-message-common.h"
+#include "ping-message-ping1d.h"
+#include "ping-message-ping360.h"
+#include "ping-parser.h"
+
+PING_LOGGING_CATEGORY(PING_LOGKEYFRAMES, "ping.logkeyframes")
+
+const QString LogKeyframes::_validHeader = QStringLiteral("PingViewer sensor log keyframes");
+
+namespace {
+/**
+ * @brief Complete message and the package where it finished
+ *
+ */
+struct Message {
+    int package = -1;
+    QByteArray data;
+};
+} // namespace
+
+void LogKeyframes::build(const QString& logFileName, const LogFileReader* reader)
+{
+    cancel();
+
+    const int size = reader->size();
+    if (load(logFileName, size)) {
+        _built = size;
+        _ready = true;
+        return;
+    }
+
+    if (!size || !openSnapshots(logFileName)) {
+        return;
+    }
+
+    // Allocated before the pass, seeks read the keyframes already built while it runs
+    _profileKinds.fill(NoProfile, size);
+    _profileSpans.fill(0, size);
+    _snapshotOffsets.fill(-1, (size + keyframeInterval - 1) / keyframeInterval);
+
+    // The pass has its own reader, playback keeps the block cache of the shared one
+    const QString fileName = reader->fileName();
+    const qint64 dataOffset = reader->dataOffset();
+    const uint version = reader->version();
+    _thread.reset(QThread::create([this, logFileName, fileName, dataOffset, version] {
+        LogFileReader passReader;
+        passReader.setReadOnly(true);
+        if (!passReader.open(fileName, dataOffset, version)) {
+            qCWarning(PING_LOGKEYFRAMES) << "Failed to open log for keyframes:" << fileName;
+            return;
+        }
+        run(logFileName, &passReader);
+    }));
+    _thread->setObjectName(QStringLiteral("LogKeyframes"));
+    _thread->start(QThread::LowPriority);
+}
+
+void LogKeyframes::cancel()
+{
+    if (_thread) {
+        _cancel = true;
+        _thread->wait();
+        _thread.reset();
+    }
+
+    QMutexLocker locker(&_mutex);
+    // An interrupted pass leaves an incomplete sidecar
+    if (_snapshots && _persistent && !_ready) {
+        _snapshots->remove();
+    }
+    _snapshots.reset();
+    _persistent = false;
+
+    _cancel = false;
+    _ready = false;
+    _built = 0;
+    _profileKinds.clear();
+    _profileSpans.clear();
+    _snapshotOffsets.clear();
+}
+
+bool LogKeyframes::openSnapshots(const QString& logFileName)
+{
+    QMutexLocker locker(&_mutex);
+
+    _snapshots.reset(new QFile(sidecarFileName(logFileName)));
+    _persistent = _snapshots->open(QIODevice::ReadWrite | QIODevice::Truncate);
+    if (!_persistent) {
+        qCWarning(PING_LOGKEYFRAMES) << "Keyframes will not be cached:" << _snapshots->errorString();
+        _snapshots.reset(new QTemporaryFile);
+        if (!_snapshots->open(QIODevice::ReadWrite)) {
+            qCWarning(PING_LOGKEYFRAMES) << "Failed to create keyframes:" << _snapshots->errorString();
+            _snapshots.reset();
+            return false;
+        }
+    }
+
+    QDataStream stream(_snapshots.get());
+    stream << _validHeader << qint32(_version) << QFileInfo(logFileName).size() << qint32(keyframeInterval);
+    return stream.status() == QDataStream::Ok;
+}
+
+void LogKeyframes::run(const QString& logFileName, const LogFileReader* reader)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // State at the actual package
+    QVector<Message> angles(ping360Angles);
+    std::deque<Message> columns;
+    QHash<quint16, Message> others;
+
+    auto snapshot = [&]() {
+        QVector<const Message*> messages;
+        for (const auto& message : others) {
+            messages.append(&message);
+        }
+        for (const auto& message : angles) {
+            if (message.package >= 0) {
+                messages.append(&message);
+            }
+        }
+        for (const auto& message : columns) {
+            messages.append(&message);
+        }
+        std::stable_sort(messages.begin(), messages.end(),
+            [](const Message* left, const Message* right) { return left->package < right->package; });
+
+        QByteArray data;
+        for (const auto message : messages) {
+            data.append(message->data);
+        }
+        return data.isEmpty() ? data : qCompress(data);
+    };
+
+    const int size = std::min(reader->size(), _profileKinds.size());
+    PingParser parser(10240);
+    for (int index = 0; index < size && !_cancel; index++) {
+        if (index % keyframeInterval == 0) {
+            const QByteArray compressed = snapshot();
+            QMutexLocker locker(&_mutex);
+            const qint64 offset = _snapshots->size();
+            _snapshots->seek(offset);
+            QDataStream stream(_snapshots.get());
+            stream << compressed;
+            _snapshotOffsets[index / keyframeInterval] = offset;
+        }
+
+        const QByteArray data = reader->data(index);
+        for (int position = 0; position < data.size(); position++) {
+            if (parser.parseByte(data.at(position)) != PingParser::ParseState::NEW_MESSAGE) {
+                continue;
+            }
+
+            ping_message& message = parser.rxMessage;
+            const Message complete {
+                index, QByteArray(reinterpret_cast<const char*>(message.msgData), message.msgDataLength())};
+            switch (message.message_id()) {
+            case Ping1dId::PROFILE:
+                _profileKinds[index] = Ping1dProfile;
+                columns.push_back(complete);
+                if (columns.size() > waterfallColumns) {
+                    columns.pop_front();
+                }
+                break;
+            case Ping360Id::DEVICE_DATA:
+                _profileKinds[index] = static_cast<ping360_device_data*>(&message)->angle() % ping360Angles;
+                angles[_profileKinds[index]] = complete;
+                break;
+            case Ping360Id::AUTO_DEVICE_DATA:
+                _profileKinds[index] = static_cast<ping360_auto_device_data*>(&message)->angle() % ping360Angles;
+                angles[_profileKinds[index]] = complete;
+                break;
+            default:
+                // Configuration and measurements of the sensor, only the newest one describes it
+                others[message.message_id()] = complete;
+                continue;
+            }
+
+            // Profiles split between packages need the previous ones to be parsed again
+            int missingBytes = message.msgDataLength() - (position + 1);
+            int span = 0;
+            while (missingBytes > 0 && span < std::numeric_limits<quint8>::max() && index - span > 0) {
+                span++;
+                missingBytes -= reader->data(index - span).size();
+            }
+            _profileSpans[index] = span;
+        }
+
+        _built = index + 1;
+    }
+
+    if (_cancel) {
+        return;
+    }
+
+    if (_persistent) {
+        writeTable(logFileName);
+    }
+    _ready = true;
+    qCDebug(PING_LOGKEYFRAMES) << _snapshotOffsets.size() << "keyframes built in" << timer.elapsed() << "ms.";
+}
+
+bool LogKeyframes::writeTable(const QString& logFileName)
+{
+    QMutexLocker locker(&_mutex);
+
+    // The table goes after the snapshots, its position is the last field of the file
+    const qint64 tableOffset = _snapshots->size();
+    _snapshots->seek(tableOffset);
+    QDataStream stream(_snapshots.get());
+    stream << _profileKinds << _profileSpans << _snapshotOffsets << tableOffset;
+    if (stream.status() != QDataStream::Ok || !_snapshots->flush()) {
+        qCWarning(PING_LOGKEYFRAMES) << "Failed to save keyframes of" << logFileName << ":"
+                                     << _snapshots->errorString();
+        return false;
+    }
+    return true;
+}
+
+bool LogKeyframes::load(const QString& logFileName, int size)
+{
+    auto file = std::make_unique<QFile>(sidecarFileName(logFileName));
+    if (!file->open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(file.get());
+    QString header;
+    qint32 version;
+    qint64 logSize;
+    qint32 interval;
+    stream >> header >> version >> logSize >> interval;
+    if (header != _validHeader || version != _version || interval != keyframeInterval
+        || logSize != QFileInfo(logFileName).size()) {
+        qCDebug(PING_LOGKEYFRAMES) << "Keyframes are outdated:" << file->fileName();
+        return false;
+    }
+
+    const qint64 headerEnd = file->pos();
+    qint64 tableOffset = -1;
+    if (file->size() > headerEnd + 8 && file->seek(file->size() - 8)) {
+        stream >> tableOffset;
+    }
+    if (tableOffset < headerEnd || !file->seek(tableOffset)) {
+        qCWarning(PING_LOGKEYFRAMES) << "Invalid keyframes:" << file->fileName();
+        return false;
+    }
+
+    stream >> _profileKinds >> _profileSpans >> _snapshotOffsets;
+    const int numberOfKeyframes = (size + keyframeInterval - 1) / keyframeInterval;
+    if (stream.status() != QDataStream::Ok || _profileKinds.size() != size || _profileSpans.size() != size
+        || _snapshotOffsets.size() != numberOfKeyframes) {
+        qCWarning(PING_LOGKEYFRAMES) << "Invalid keyframes:" << file->fileName();
+        _profileKinds.clear();
+        _profileSpans.clear();
+        _snapshotOffsets.clear();
+        return false;
+    }
+
+    QMutexLocker locker(&_mutex);
+    _snapshots = std::move(file);
+    _persistent = true;
+    qCDebug(PING_LOGKEYFRAMES) << "Loaded" << numberOfKeyframes << "keyframes.";
+    return true;
+}
+
+bool LogKeyframes::isAvailable(int packageIndex) const
+{
+    return packageIndex > 0 && packageIndex < _built;
+}
+
+QByteArray LogKeyframes::snapshotForIndex(int packageIndex) const
+{
+    if (!isAvailable(packageIndex)) {
+        return {};
+    }
+
+    QMutexLocker locker(&_mutex);
+    const qint64 offset = _snapshotOffsets[packageIndex / keyframeInterval];
+    if (!_snapshots || offset < 0 || !_snapshots->seek(offset)) {
+        return {};
+    }
+
+    QDataStream stream(_snapshots.get());
+    QByteArray compressed;
+    stream >> compressed;
+    return compressed.isEmpty() ? compressed : qUncompress(compressed);
+}
+
+QVector<int> LogKeyframes::packagesForIndex(int packageIndex) const
+{
+    if (!isAvailable(packageIndex)) {
+        return {};
+    }
+
+    // The newest profiles of each angle and waterfall column after the snapshot are the ones in the view
+    QVector<bool> anglesInView(ping360Angles, false);
+    int columnsInView = 0;
+    QVector<int> profiles;
+    const int keyframeStart = packageIndex / keyframeInterval * keyframeInterval;
+    for (int index = packageIndex - 1; index >= keyframeStart; index--) {
+        const qint16 kind = _profileKinds[index];
+        if (kind == NoProfile) {
+            continue;
+        }
+        if (kind == Ping1dProfile) {
+            if (columnsInView++ < waterfallColumns) {
+                profiles.append(index);
+            }
+        } else if (!anglesInView[kind]) {
+            anglesInView[kind] = true;
+            profiles.append(index);
+        }
+    }
+    std::reverse(profiles.begin(), profiles.end());
+
+    QVector<int> packages;
+    packages.reserve(profiles.size());
+    for (const int profile : profiles) {
+        const int first = std::max(profile - _profileSpans[profile], packages.isEmpty() ? 0 : packages.last() + 1);
+        for (int index = first; index <= profile; index++) {
+            packages.append(index);
+        }
+    }
+    return packages;
+}
+
+LogKeyframes::~LogKeyframes() { cancel(); }
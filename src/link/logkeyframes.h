@@ -0,0 +1,125 @@
+#pragma once
+
+#include <QFile>
+#include <QLoggingCategory>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+
+#include <atomic>
+#include <memory>
+
+#include "logfilereader.h"
+
+Q_DECLARE_LOGGING_CATEGORY(PING_LOGKEYFRAMES)
+
+/**
+ * @brief State needed to rebuild the visualizers and sensor at any position of a log
+ *  Every keyframeInterval packages a snapshot of the state is kept: the complete messages that describe it,
+ *  the last profile of each Ping360 angle (a full sweep), the last waterfall width of Ping1D profiles
+ *  and the last message of any other kind.
+ *  A seek applies the snapshot of the previous keyframe and only the newest profiles after it.
+ *  Snapshots are built by a background pass and cached next to the log, keyframes are available as soon as
+ *  the pass reaches them.
+ */
+class LogKeyframes {
+public:
+    static const int keyframeInterval = 1024;
+    // Same as the waterfall display width
+    static const int waterfallColumns = 500;
+    static const int ping360Angles = 400;
+
+    /**
+     * @brief Construct a new Log Keyframes object
+     *
+     */
+    LogKeyframes() = default;
+
+    /**
+     * @brief Destroy the Log Keyframes object
+     *
+     */
+    ~LogKeyframes();
+
+    /**
+     * @brief Load the cached keyframes or start building them in background
+     *  The background pass opens the log again with the reader parameters, it does not share its block cache
+     *
+     * @param logFileName
+     * @param reader
+     */
+    void build(const QString& logFileName, const LogFileReader* reader);
+
+    /**
+     * @brief Stop the background build and remove all keyframes
+     *
+     */
+    void cancel();
+
+    /**
+     * @brief Check if all keyframes are available
+     *
+     * @return true
+     * @return false
+     */
+    bool isReady() const { return _ready; };
+
+    /**
+     * @brief Return the state before the keyframe of a package, as complete messages in log order
+     *
+     * @param packageIndex
+     * @return QByteArray empty if the keyframe is not available
+     */
+    QByteArray snapshotForIndex(int packageIndex) const;
+
+    /**
+     * @brief Return the packages, in log order, that update the snapshot until a package is played
+     *
+     * @param packageIndex
+     * @return QVector<int>
+     */
+    QVector<int> packagesForIndex(int packageIndex) const;
+
+    /**
+     * @brief Return the sidecar file name of a log
+     *
+     * @param logFileName
+     * @return QString
+     */
+    static QString sidecarFileName(const QString& logFileName) { return logFileName + QStringLiteral(".keyframes"); };
+
+private:
+    Q_DISABLE_COPY(LogKeyframes)
+
+    // Kind of profile of each package, or the Ping360 angle
+    enum : qint16 {
+        NoProfile = -2,
+        Ping1dProfile = -1,
+    };
+
+    bool isAvailable(int packageIndex) const;
+    bool load(const QString& logFileName, int size);
+    bool openSnapshots(const QString& logFileName);
+    void run(const QString& logFileName, const LogFileReader* reader);
+    bool writeTable(const QString& logFileName);
+
+    QVector<qint16> _profileKinds;
+    // Number of previous packages that hold the beginning of the profile message
+    QVector<quint8> _profileSpans;
+    // Position of the compressed snapshot of each keyframe in the snapshot file
+    QVector<qint64> _snapshotOffsets;
+
+    // Snapshots are kept on disk, the sidecar or a temporary file when the log directory is read only
+    mutable QMutex _mutex;
+    std::unique_ptr<QFile> _snapshots;
+    bool _persistent = false;
+
+    std::unique_ptr<QThread> _thread;
+    // Packages already classified by the background pass
+    std::atomic<int> _built {0};
+    std::atomic<bool> _cancel {false};
+    std::atomic<bool> _ready {false};
+
+    static const QString _validHeader;
+    static const int _version = 1;
+};
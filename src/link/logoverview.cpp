@@ -0,0 +1,289 @@
+#include <QDataStream>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+
+#include <algorithm>
+
+#include "logger.h"
+#include "logoverview.h"
+
+#include "ping-message-common.h"
+#include "ping-message-ping1d.h"
+#include "ping-message-ping360.h"
+#include "ping-parser.h"
+
+PING_LOGGING_CATEGORY(PING_LOGOVERVIEW, "ping.logoverview")
+
+const QString LogOverview::_validHeader = QStringLiteral("PingViewer sensor log overview");
+
+namespace {
+/**
+ * @brief Create the thumbnail from the columns of each second
+ *
+ * @param columns thumbnailHeight samples per second
+ * @return QImage
+ */
+QImage thumbnailFromColumns(const QByteArray& columns)
+{
+    const int width = columns.size() / LogOverview::thumbnailHeight;
+    QImage image(std::max(width, 1), LogOverview::thumbnailHeight, QImage::Format_Grayscale8);
+    image.fill(0);
+    for (int x = 0; x < width; x++) {
+        for (int y = 0; y < LogOverview::thumbnailHeight; y++) {
+            image.scanLine(y)[x] = columns.at(x * LogOverview::thumbnailHeight + y);
+        }
+    }
+    return image;
+}
+} // namespace
+
+void LogOverview::build(const QString& logFileName, const LogFileReader* reader, std::function<void()> ready)
+{
+    cancel();
+    _readyCallback = std::move(ready);
+
+    if (load(logFileName)) {
+        _ready = true;
+        if (_readyCallback) {
+            _readyCallback();
+        }
+        return;
+    }
+
+    if (!reader->size()) {
+        return;
+    }
+
+    // The pass has its own reader, playback keeps the block cache of the shared one
+    const QString fileName = reader->fileName();
+    const qint64 dataOffset = reader->dataOffset();
+    const uint version = reader->version();
+    _thread.reset(QThread::create([this, logFileName, fileName, dataOffset, version] {
+        LogFileReader passReader;
+        passReader.setReadOnly(true);
+        if (!passReader.open(fileName, dataOffset, version)) {
+            qCWarning(PING_LOGOVERVIEW) << "Failed to open log for overview:" << fileName;
+            return;
+        }
+        run(logFileName, &passReader);
+    }));
+    _thread->setObjectName(QStringLiteral("LogOverview"));
+    _thread->start(QThread::LowPriority);
+}
+
+void LogOverview::cancel()
+{
+    if (_thread) {
+        _cancel = true;
+        _thread->wait();
+        _thread.reset();
+    }
+
+    _cancel = false;
+    _ready = false;
+    _bins.clear();
+    _thumbnail = QImage();
+}
+
+void LogOverview::run(const QString& logFileName, const LogFileReader* reader)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // Accumulators of the actual second
+    Bin bin;
+    qint64 distanceSum = 0;
+    int distances = 0;
+    qint64 confidenceSum = 0;
+    QVector<quint32> samplesSum(thumbnailHeight, 0);
+
+    QByteArray columns;
+    auto finishBin = [&]() {
+        if (distances) {
+            bin.meanDistance = distanceSum / distances;
+            bin.meanConfidence = confidenceSum / distances;
+        }
+        for (int row = 0; row < thumbnailHeight; row++) {
+            columns.append(static_cast<char>(bin.profiles ? samplesSum[row] / bin.profiles : 0));
+        }
+        _bins.append(bin);
+
+        bin = Bin();
+        distanceSum = 0;
+        distances = 0;
+        confidenceSum = 0;
+        samplesSum.fill(0);
+    };
+
+    auto addDistance = [&](qint32 distance, qint16 confidence) {
+        bin.minDistance = distances ? std::min(bin.minDistance, distance) : distance;
+        bin.maxDistance = distances ? std::max(bin.maxDistance, distance) : distance;
+        bin.minConfidence = distances ? std::min(bin.minConfidence, confidence) : confidence;
+        bin.maxConfidence = distances ? std::max(bin.maxConfidence, confidence) : confidence;
+        distanceSum += distance;
+        confidenceSum += confidence;
+        distances++;
+    };
+
+    // Profiles are decimated keeping the peaks of each row
+    auto addProfile = [&](const uint8_t* samples, int numberOfSamples) {
+        if (numberOfSamples <= 0) {
+            return;
+        }
+        for (int row = 0; row < thumbnailHeight; row++) {
+            const int begin = row * numberOfSamples / thumbnailHeight;
+            const int end = std::max(begin + 1, (row + 1) * numberOfSamples / thumbnailHeight);
+            samplesSum[row] += *std::max_element(samples + std::min(begin, numberOfSamples - 1),
+                samples + std::min(end, numberOfSamples));
+        }
+        bin.profiles++;
+    };
+
+    const qint64 firstTimestampNs = reader->timestampNs(0);
+    PingParser parser(10240);
+    for (int index = 0; index < reader->size() && !_cancel; index++) {
+        const qint64 second = (reader->timestampNs(index) - firstTimestampNs) / 1000000000;
+        while (_bins.size() < second) {
+            finishBin();
+        }
+
+        const QByteArray data = reader->data(index);
+        for (const auto byte : data) {
+            if (parser.parseByte(byte) != PingParser::ParseState::NEW_MESSAGE) {
+                continue;
+            }
+
+            ping_message& message = parser.rxMessage;
+            switch (message.message_id()) {
+            case Ping1dId::DISTANCE_SIMPLE: {
+                auto distanceSimple = static_cast<ping1d_distance_simple*>(&message);
+                addDistance(distanceSimple->distance(), distanceSimple->confidence());
+                break;
+            }
+            case Ping1dId::DISTANCE: {
+                auto distance = static_cast<ping1d_distance*>(&message);
+                addDistance(distance->distance(), distance->confidence());
+                break;
+            }
+            case Ping1dId::PROFILE: {
+                auto profile = static_cast<ping1d_profile*>(&message);
+                addDistance(profile->distance(), profile->confidence());
+                addProfile(profile->profile_data(), profile->profile_data_length());
+                break;
+            }
+            case Ping360Id::DEVICE_DATA: {
+                auto deviceData = static_cast<ping360_device_data*>(&message);
+                addProfile(deviceData->data(), deviceData->data_length());
+                break;
+            }
+            case Ping360Id::AUTO_DEVICE_DATA: {
+                auto autoDeviceData = static_cast<ping360_auto_device_data*>(&message);
+                addProfile(autoDeviceData->data(), autoDeviceData->data_length());
+                break;
+            }
+            default:
+                break;
+            }
+        }
+    }
+
+    if (_cancel) {
+        return;
+    }
+
+    finishBin();
+    _thumbnail = thumbnailFromColumns(columns);
+    save(logFileName);
+    qCDebug(PING_LOGOVERVIEW) << "Overview with" << _bins.size() << "seconds built in" << timer.elapsed() << "ms.";
+
+    _ready = true;
+    if (_readyCallback) {
+        _readyCallback();
+    }
+}
+
+QVector<int> LogOverview::lowConfidenceSeconds(int minConfidence) const
+{
+    QVector<int> seconds;
+    if (!_ready) {
+        return seconds;
+    }
+
+    for (int second = 0; second < _bins.size(); second++) {
+        const qint16 confidence = _bins[second].meanConfidence;
+        if (confidence >= 0 && confidence < minConfidence) {
+            seconds.append(second);
+        }
+    }
+    return seconds;
+}
+
+bool LogOverview::load(const QString& logFileName)
+{
+    QFile file(sidecarFileName(logFileName));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    QString header;
+    qint32 version;
+    qint64 logSize;
+    stream >> header >> version >> logSize;
+    if (header != _validHeader || version != _version || logSize != QFileInfo(logFileName).size()) {
+        qCDebug(PING_LOGOVERVIEW) << "Overview is outdated:" << file.fileName();
+        return false;
+    }
+
+    qint32 size;
+    stream >> size;
+    if (size < 0) {
+        return false;
+    }
+    _bins.resize(size);
+    for (auto& bin : _bins) {
+        stream >> bin.minDistance >> bin.maxDistance >> bin.meanDistance >> bin.minConfidence >> bin.maxConfidence
+            >> bin.meanConfidence >> bin.profiles;
+    }
+
+    QByteArray columns;
+    stream >> columns;
+    if (stream.status() != QDataStream::Ok || columns.size() != size * thumbnailHeight) {
+        qCWarning(PING_LOGOVERVIEW) << "Invalid overview:" << file.fileName();
+        _bins.clear();
+        return false;
+    }
+
+    _thumbnail = thumbnailFromColumns(columns);
+    return true;
+}
+
+bool LogOverview::save(const QString& logFileName) const
+{
+    QFile file(sidecarFileName(logFileName));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(PING_LOGOVERVIEW) << "Failed to save overview:" << file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream << _validHeader << qint32(_version) << QFileInfo(logFileName).size() << qint32(_bins.size());
+    for (const auto& bin : _bins) {
+        stream << bin.minDistance << bin.maxDistance << bin.meanDistance << bin.minConfidence << bin.maxConfidence
+               << bin.meanConfidence << bin.profiles;
+    }
+
+    QByteArray columns;
+    columns.reserve(_bins.size() * thumbnailHeight);
+    for (int x = 0; x < _bins.size(); x++) {
+        for (int y = 0; y < thumbnailHeight; y++) {
+            columns.append(static_cast<char>(_thumbnail.constScanLine(y)[x]));
+        }
+    }
+    stream << columns;
+    return stream.status() == QDataStream::Ok;
+}
+
+LogOverview::~LogOverview() { cancel(); }
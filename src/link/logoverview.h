@@ -0,0 +1,124 @@
+#pragma once
+
+#include <QImage>
+#include <QLoggingCategory>
+#include <QThread>
+#include <QVector>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "logfilereader.h"
+
+Q_DECLARE_LOGGING_CATEGORY(PING_LOGOVERVIEW)
+
+/**
+ * @brief Compact summary of a whole sensor log
+ *  Each second of the log has the distance and confidence statistics of Ping1D
+ *  and a thumbnail column with the mean of the profiles, decimated to thumbnailHeight samples.
+ *  The summary is built in one background pass and cached next to the log.
+ */
+class LogOverview {
+public:
+    /**
+     * @brief Statistics of one second of log
+     *  Distances are in mm and confidence in %, -1 when there is no information
+     */
+    struct Bin {
+        qint32 minDistance = -1;
+        qint32 maxDistance = -1;
+        qint32 meanDistance = -1;
+        qint16 minConfidence = -1;
+        qint16 maxConfidence = -1;
+        qint16 meanConfidence = -1;
+        qint32 profiles = 0;
+    };
+
+    static const int thumbnailHeight = 64;
+
+    /**
+     * @brief Construct a new Log Overview object
+     *
+     */
+    LogOverview() = default;
+
+    /**
+     * @brief Destroy the Log Overview object
+     *
+     */
+    ~LogOverview();
+
+    /**
+     * @brief Load the cached overview or start building it in background
+     *  The background pass opens the log again with the reader parameters, it does not share its block cache
+     *
+     * @param logFileName
+     * @param reader
+     * @param ready called when the overview is available, from the building thread
+     */
+    void build(const QString& logFileName, const LogFileReader* reader, std::function<void()> ready = {});
+
+    /**
+     * @brief Stop the background build and remove the overview
+     *
+     */
+    void cancel();
+
+    /**
+     * @brief Check if overview is available
+     *
+     * @return true
+     * @return false
+     */
+    bool isReady() const { return _ready; };
+
+    /**
+     * @brief Return the statistics of each second
+     *
+     * @return const QVector<Bin>&
+     */
+    const QVector<Bin>& bins() const { return _bins; };
+
+    /**
+     * @brief Return the thumbnail, a column per second
+     *
+     * @return const QImage&
+     */
+    const QImage& thumbnail() const { return _thumbnail; };
+
+    /**
+     * @brief Return the seconds with mean confidence below a threshold
+     *  Useful to jump to the parts of a survey where the bottom was lost
+     *
+     * @param minConfidence in %
+     * @return QVector<int>
+     */
+    QVector<int> lowConfidenceSeconds(int minConfidence) const;
+
+    /**
+     * @brief Return the sidecar file name of a log
+     *
+     * @param logFileName
+     * @return QString
+     */
+    static QString sidecarFileName(const QString& logFileName) { return logFileName + QStringLiteral(".overview"); };
+
+private:
+    Q_DISABLE_COPY(LogOverview)
+
+    bool load(const QString& logFileName);
+    void run(const QString& logFileName, const LogFileReader* reader);
+    bool save(const QString& logFileName) const;
+
+    QVector<Bin> _bins;
+    QImage _thumbnail;
+    std::function<void()> _readyCallback;
+
+    std::unique_ptr<QThread> _thread;
+    std::atomic<bool> _cancel {false};
+    std::atomic<bool> _ready {false};
+
+    static const QString _validHeader;
+    static const int _version = 1;
+};
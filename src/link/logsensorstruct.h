@@ -80,7 +80,7 @@ struct LogSensorStruct {
         sensor = sensorInfo;
     }
 
-    uint _actualVersion = 1;
+    uint _actualVersion = 2;
     QString _validHeader = QStringLiteral("PingViewer sensor log file");
 };
 
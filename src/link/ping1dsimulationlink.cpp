@@ -6,14 +6,18 @@
 Ping1DSimulationLink::Ping1DSimulationLink(QObject* parent)
     : SimulationLink(parent)
 {
-    connect(&_randomUpdateTimer, &QTimer::timeout, this, &Ping1DSimulationLink::randomUpdate);
-    _randomUpdateTimer.start(50);
+    // A profile each 50ms, the templates cover a full period of the simulated depth
+    Options options;
+    options.rate = 20;
+    options.samples = 200;
+    options.templates = 252;
+    setDefaultOptions(options);
 }
 
-void Ping1DSimulationLink::randomUpdate()
+QByteArray Ping1DSimulationLink::createProfile(int index, int samples)
 {
-    static uint counter = 1;
-    static const float numPoints = 200;
+    const uint counter = index + 1;
+    const float numPoints = samples;
     static const float maxDepth = 70000;
     const float stop1 = numPoints / 2.0 - 10 * qSin(counter / 10.0);
     const float stop2 = 3 * numPoints / 5.0 + 6 * qCos(counter / 5.5);
@@ -21,7 +25,7 @@ void Ping1DSimulationLink::randomUpdate()
 
     uint8_t conf = 400 / (stop2 - stop1);
 
-    static ping1d_profile profile(numPoints);
+    ping1d_profile profile(samples);
 
     profile.set_distance(osc * (stop2 + stop1) / (numPoints * 2));
     profile.set_confidence(conf);
@@ -46,7 +50,5 @@ void Ping1DSimulationLink::randomUpdate()
     }
 
     profile.updateChecksum();
-    emit newData(QByteArray(reinterpret_cast<const char*>(profile.msgData), profile.msgDataLength()));
-
-    counter++;
+    return QByteArray(reinterpret_cast<const char*>(profile.msgData), profile.msgDataLength());
 }
@@ -1,7 +1,8 @@
 #pragma once
 
 #include "simulationlink.h"
-#include <QTimer>
+
+#include <ping-message-ping1d.h>
 
 /**
  * @brief Link that simulates Ping sensor behaviour
@@ -16,12 +17,13 @@ public:
      */
     Ping1DSimulationLink(QObject* parent = nullptr);
 
+protected:
     /**
      * @brief Generates random data
      *
+     * @param index
+     * @param samples
+     * @return QByteArray
      */
-    void randomUpdate();
-
-private:
-    QTimer _randomUpdateTimer;
+    QByteArray createProfile(int index, int samples) override final;
 };
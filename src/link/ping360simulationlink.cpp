@@ -11,6 +11,12 @@ Ping360SimulationLink::Ping360SimulationLink(QObject* parent)
     , _globalAverageTimeMs(0)
     , _spins(0)
 {
+    // Profiles are sent by request, one template for each angle
+    Options options;
+    options.samples = 1200;
+    options.templates = _angularResolution;
+    setDefaultOptions(options);
+
     _elapsedTimer.start();
     connect(this, &AbstractLink::sendData, this, &Ping360SimulationLink::handleData, Qt::QueuedConnection);
 }
@@ -26,7 +32,7 @@ void Ping360SimulationLink::handleData(const QByteArray& byteArray)
             emit newData(QByteArray(
                 reinterpret_cast<const char*>(deviceInformation.msgData), deviceInformation.msgDataLength()));
         }
-    } else if (message.message_id() == Ping360Id::TRANSDUCER) {
+    } else if (message.message_id() == Ping360Id::TRANSDUCER && !options().rate && !options().burst) {
         // We should update asap when running in speed test mode, to make sure that everything else is sharp
         // If we are not running the test, we should replicate the same periodic behaviour
 #if defined(PING360_SPEED_TEST)
@@ -38,18 +44,17 @@ void Ping360SimulationLink::handleData(const QByteArray& byteArray)
     }
 }
 
-void Ping360SimulationLink::randomUpdate()
+QByteArray Ping360SimulationLink::createProfile(int index, int samples)
 {
-    static const float numberOfSamples = 1200;
-    static const int angularResolution = 400;
+    const float numberOfSamples = samples;
 
-    const float stop1 = numberOfSamples / 2.0 - 10 * qSin(_counter / 10.0);
-    const float stop2 = 3 * numberOfSamples / 5.0 + 6 * qCos(_counter / 5.5);
+    const float stop1 = numberOfSamples / 2.0 - 10 * qSin(index / 10.0);
+    const float stop2 = 3 * numberOfSamples / 5.0 + 6 * qCos(index / 5.5);
 
-    static ping360_device_data deviceData(numberOfSamples);
+    ping360_device_data deviceData(samples);
     deviceData.set_mode(0);
     deviceData.set_gain_setting(1);
-    deviceData.set_angle(_counter % angularResolution);
+    deviceData.set_angle(index % _angularResolution);
     deviceData.set_transmit_duration(1000);
     deviceData.set_sample_period(80);
     deviceData.set_transmit_frequency(700);
@@ -70,7 +75,12 @@ void Ping360SimulationLink::randomUpdate()
     }
 
     deviceData.updateChecksum();
-    emit newData(QByteArray(reinterpret_cast<const char*>(deviceData.msgData), deviceData.msgDataLength()));
+    return QByteArray(reinterpret_cast<const char*>(deviceData.msgData), deviceData.msgDataLength());
+}
+
+void Ping360SimulationLink::randomUpdate()
+{
+    sendProfile();
 
     // Calculate the global average time between requests
     _counter++;
@@ -81,7 +91,7 @@ void Ping360SimulationLink::randomUpdate()
     _elapsedTimer.restart();
 
     // This should be done after _counter increase to not interate before a full first spin
-    if (_counter % angularResolution == 0) {
+    if (_counter % _angularResolution == 0) {
         _spins++;
     }
 
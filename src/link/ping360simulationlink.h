@@ -2,7 +2,8 @@
 
 #include "simulationlink.h"
 #include <QElapsedTimer>
-#include <QTimer>
+
+#include <ping-message-ping360.h>
 
 /**
  * @brief Link that simulates Ping sensor behaviour
@@ -18,7 +19,7 @@ public:
     Ping360SimulationLink(QObject* parent = nullptr);
 
     /**
-     * @brief Generates random data
+     * @brief Reply a profile request
      *
      */
     void randomUpdate();
@@ -38,7 +39,19 @@ public:
      */
     bool isWritable() override final { return true; };
 
+protected:
+    /**
+     * @brief Generates random data
+     *
+     * @param index
+     * @param samples
+     * @return QByteArray
+     */
+    QByteArray createProfile(int index, int samples) override final;
+
 private:
+    static constexpr int _angularResolution = 400;
+
     int _counter;
     QElapsedTimer _elapsedTimer;
     float _globalAverageTimeMs;
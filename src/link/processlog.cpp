@@ -1,87 +1,193 @@
 #include <QDebug>
 
 #include <algorithm>
+#include <thread>
 
 #include "logger.h"
 #include "processlog.h"
 
 PING_LOGGING_CATEGORY(PING_PROCESSLOG, "ping.ProcessLog");
 
+namespace {
+// Sleep slices are short to react fast to pause, seek and speed changes
+const auto sleepSlice = std::chrono::milliseconds(20);
+// A late schedule starts again from the actual package, avoiding a burst to catch up
+const auto maximumDelay = std::chrono::milliseconds(250);
+const auto achievedSpeedPeriod = std::chrono::seconds(1);
+} // namespace
+
 ProcessLog::ProcessLog(QObject* parent)
     : QObject(parent)
+    , _achievedSpeed(0)
     , _logIndex(0)
+    , _packagesInFlight(0)
     , _play(true)
-    , _replayTimeMs(0)
-    , _sleepTime(0)
+    , _restoreView(false)
+    , _resync(true)
+    , _speed(1)
     , _stop(false)
 {
 }
 
 void ProcessLog::run()
 {
-    int diffMSecs = 0;
-    int lastMSecs = 0;
+    // The schedule is anchored to a package, every other deadline is relative to it
+    Clock::time_point anchorTime;
+    qint64 anchorTimestampNs = 0;
+    Clock::time_point windowTime;
+    qint64 windowTimestampNs = 0;
 
     while (!_stop) {
         // Check for pause condition and valid log index
-        if (!_play) {
+        if (!_play || !_reader || _reader->size() == 0) {
             QThread::msleep(200);
             continue;
         }
 
-        const QByteArray& data = _log[_logIndex].data;
-        lastMSecs = _log[_logIndex].time.msecsSinceStartOfDay();
-        emit packageIndexChanged(_logIndex);
-        emit newPackage(data);
+        const int index = _logIndex;
+        const qint64 timestampNs = _reader->timestampNs(index);
+        const float speed = _speed;
+
+        if (_resync.exchange(false) || timestampNs < anchorTimestampNs) {
+            anchorTime = Clock::now();
+            anchorTimestampNs = timestampNs;
+            windowTime = anchorTime;
+            windowTimestampNs = timestampNs;
+        }
+
+        // Draw what the view had at this position, the schedule starts again after it
+        if (_restoreView.exchange(false)) {
+            restoreView(index);
+            _resync = true;
+            continue;
+        }
+
+        if (speed > 0) {
+            const auto deadline
+                = anchorTime + std::chrono::nanoseconds(static_cast<qint64>((timestampNs - anchorTimestampNs) / speed));
+            if (Clock::now() - deadline > maximumDelay) {
+                qCDebug(PING_PROCESSLOG) << "Replay is late, restarting schedule at:" << index;
+                anchorTime = Clock::now();
+                anchorTimestampNs = timestampNs;
+            } else if (!waitUntil(deadline)) {
+                continue;
+            }
+        }
+
+        if (!waitForConsumer()) {
+            continue;
+        }
+
+        _packagesInFlight++;
+        emit packageIndexChanged(index);
+        emit newPackage(_reader->data(index));
+
+        // A seek during the emission has priority over the next package
+        int expected = index;
+        _logIndex.compare_exchange_strong(expected, index + 1);
+
+        const auto now = Clock::now();
+        if (now - windowTime >= achievedSpeedPeriod) {
+            const std::chrono::duration<double, std::nano> windowDuration = now - windowTime;
+            _achievedSpeed = (timestampNs - windowTimestampNs) / windowDuration.count();
+            emit achievedSpeedChanged(_achievedSpeed);
+            windowTime = now;
+            windowTimestampNs = timestampNs;
+        }
 
-        _logIndex++;
         // Check if we have data before sending
-        if (_logIndex >= _log.size()) {
+        if (_logIndex >= _reader->size()) {
             qCDebug(PING_PROCESSLOG) << "End of the log.";
 
             // Restart thread and wait for user interaction
             _logIndex = 0;
             _play = false;
-            continue;
+            _achievedSpeed = 0;
+            emit achievedSpeedChanged(_achievedSpeed);
         }
+    }
+}
 
-        diffMSecs = _log[_logIndex].time.msecsSinceStartOfDay() - lastMSecs;
+void ProcessLog::restoreView(int index)
+{
+    if (!_keyframes) {
+        return;
+    }
 
-        // Something is wrong, we need to go 'back to the future'
-        if (diffMSecs < 0) {
-            qCWarning(PING_PROCESSLOG) << "Sample time is negative from previous sample! Trying to recover..";
-            qCDebug(PING_PROCESSLOG) << "First time:" << _log.constFirst().time;
-            qCDebug(PING_PROCESSLOG) << "Last time:" << _log.constLast().time;
-            qCDebug(PING_PROCESSLOG) << "Actual index:" << _logIndex << "Time[n-1, n]:" << _log[_logIndex - 1].time
-                                     << _log[_logIndex].time;
-            continue;
+    // The snapshot of the keyframe is sent at once, then the newest profiles after it
+    const QByteArray snapshot = _keyframes->snapshotForIndex(index);
+    const QVector<int> packages = _keyframes->packagesForIndex(index);
+    if (!snapshot.isEmpty()) {
+        if (!waitForConsumer()) {
+            _restoreView = true;
+            return;
         }
+        _packagesInFlight++;
+        emit newPackage(snapshot);
+    }
+
+    for (const int package : packages) {
+        if (!waitForConsumer()) {
+            // Interrupted, the view is restored at the next position
+            _restoreView = true;
+            return;
+        }
+        _packagesInFlight++;
+        emit newPackage(_reader->data(package));
+    }
+
+    if (!snapshot.isEmpty() || !packages.isEmpty()) {
+        qCDebug(PING_PROCESSLOG) << "View restored at" << index << "with a snapshot of" << snapshot.size()
+                                 << "bytes and" << packages.size() << "packages.";
+    }
+}
+
+bool ProcessLog::waitUntil(Clock::time_point deadline)
+{
+    // Sleep in slices to answer seeks, pauses and stops while waiting
+    do {
+        if (_stop || !_play || _resync) {
+            return false;
+        }
+        std::this_thread::sleep_until(std::min(deadline, Clock::now() + sleepSlice));
+    } while (Clock::now() < deadline);
+
+    return true;
+}
 
-        _sleepTime = _replayTimeMs ? _replayTimeMs.load() : diffMSecs;
-        _sleepTime = std::min(_sleepTime.load(), diffMSecs);
-        while (_sleepTime > 0) {
-            QThread::msleep(10);
-            _sleepTime -= 10;
+bool ProcessLog::waitForConsumer()
+{
+    while (_packagesInFlight >= maxPackagesInFlight) {
+        if (_stop || !_play || _resync) {
+            return false;
         }
+        QThread::usleep(500);
     }
+    return true;
+}
+
+int ProcessLog::msecsSinceStart(int index) const
+{
+    return (_reader->timestampNs(index) - _reader->timestampNs(0)) / 1000000;
 }
 
 QTime ProcessLog::totalTime()
 {
-    int totalMSecs = _log.constLast().time.msecsSinceStartOfDay() - _log.constFirst().time.msecsSinceStartOfDay();
-    return QTime::fromMSecsSinceStartOfDay(totalMSecs);
+    if (!_reader || _reader->size() == 0) {
+        return QTime::fromMSecsSinceStartOfDay(0);
+    }
+    return QTime::fromMSecsSinceStartOfDay(msecsSinceStart(_reader->size() - 1));
 }
 
 QTime ProcessLog::elapsedTime()
 {
-    if (_logIndex < 0) {
+    if (!_reader || _logIndex < 0) {
         return QTime::fromMSecsSinceStartOfDay(0);
-    } else if (_logIndex >= _log.size()) {
+    } else if (_logIndex >= _reader->size()) {
         return totalTime();
     }
 
-    int elapsedMSecs = _log[_logIndex].time.msecsSinceStartOfDay() - _log.constFirst().time.msecsSinceStartOfDay();
-    return QTime::fromMSecsSinceStartOfDay(elapsedMSecs);
+    return QTime::fromMSecsSinceStartOfDay(msecsSinceStart(_logIndex));
 }
 
 ProcessLog::~ProcessLog() = default;
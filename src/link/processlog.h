@@ -1,18 +1,23 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 
 #include <QByteArray>
 #include <QLoggingCategory>
 #include <QThread>
 #include <QTime>
-#include <QVector>
+
+#include "logfilereader.h"
+#include "logkeyframes.h"
 
 Q_DECLARE_LOGGING_CATEGORY(PING_PROCESSLOG)
 
 /**
  * @brief Play sensor logs
- *
+ *  Packages are scheduled at absolute deadlines of a steady clock, from the log monotonic timestamps
+ *  scaled by the replay speed, so sleep errors do not accumulate over the log.
  */
 class ProcessLog : public QObject {
     Q_OBJECT
@@ -31,12 +36,20 @@ public:
     ~ProcessLog();
 
     /**
-     * @brief Append new log message
+     * @brief Set the log that will be played
+     *  The reader is owned by the caller and should outlive the run() call
+     *
+     * @param reader
+     */
+    void setReader(const LogFileReader* reader) { _reader = reader; };
+
+    /**
+     * @brief Set the keyframes used to rebuild the view after a seek
+     *  The keyframes are owned by the caller and should outlive the run() call
      *
-     * @param time
-     * @param data
+     * @param keyframes
      */
-    void append(QTime time, QByteArray data) { _log.append(Pack {time, data}); };
+    void setKeyframes(const LogKeyframes* keyframes) { _keyframes = keyframes; };
 
     /**
      * @brief Return log elapsed time
@@ -57,7 +70,7 @@ public:
      *
      * @return int
      */
-    int packageSize() { return _log.size() - 1; };
+    int packageSize() { return _reader ? _reader->size() - 1 : 0; };
 
     /**
      * @brief Pause log
@@ -78,9 +91,10 @@ public:
      */
     void setPackageIndex(int index)
     {
-        if (_logIndex < _log.size()) {
+        if (_reader && index >= 0 && index < _reader->size()) {
             _logIndex = index;
-            _sleepTime = 0;
+            _resync = true;
+            _restoreView = true;
         }
     }
 
@@ -92,7 +106,7 @@ public:
     {
         _play = true;
         _stop = false;
-        _sleepTime = 0;
+        _resync = true;
     };
 
     /**
@@ -112,33 +126,66 @@ public:
     QTime totalTime();
 
     /**
-     * @brief Set the time between each message
-     *  Set time to 0 for real-time
+     * @brief Set the replay speed
+     *  Speeds are limited between minimumSpeed and maximumSpeed,
+     *  0 plays as fast as the packages are consumed
      *
-     * @param replayTimeMs
+     * @param speed multiplier of the log time
      */
-    void setReplayTimeMs(int replayTimeMs)
+    void setSpeed(float speed)
     {
-        _replayTimeMs = replayTimeMs;
-        _sleepTime = 0;
+        _speed = speed > 0 ? std::clamp(speed, minimumSpeed, maximumSpeed) : 0.0f;
+        _resync = true;
     }
 
+    /**
+     * @brief Return the requested replay speed
+     *
+     * @return float
+     */
+    float speed() const { return _speed; };
+
+    /**
+     * @brief Return the replay speed achieved in the last second
+     *
+     * @return float
+     */
+    float achievedSpeed() const { return _achievedSpeed; };
+
+    /**
+     * @brief Notify that a package emitted by newPackage was processed
+     *  Limits the number of packages waiting in the event queues
+     *
+     */
+    void packageConsumed() { _packagesInFlight--; };
+
+    // Packages emitted by newPackage that can wait to be consumed
+    static constexpr int maxPackagesInFlight = 16;
+
+    static constexpr float minimumSpeed = 0.25f;
+    static constexpr float maximumSpeed = 32.0f;
+
 signals:
     void newPackage(const QByteArray& data);
     void packageIndexChanged(int index);
+    void achievedSpeedChanged(float speed);
 
 private:
-    void processJob();
+    using Clock = std::chrono::steady_clock;
 
-    struct Pack {
-        QTime time;
-        QByteArray data;
-    };
+    int msecsSinceStart(int index) const;
+    void restoreView(int index);
+    bool waitForConsumer();
+    bool waitUntil(Clock::time_point deadline);
 
-    QVector<Pack> _log;
+    const LogKeyframes* _keyframes = nullptr;
+    const LogFileReader* _reader = nullptr;
+    std::atomic<float> _achievedSpeed;
     std::atomic<int> _logIndex;
+    std::atomic<int> _packagesInFlight;
     std::atomic<bool> _play;
-    std::atomic<int> _replayTimeMs;
-    std::atomic<int> _sleepTime;
+    std::atomic<bool> _restoreView;
+    std::atomic<bool> _resync;
+    std::atomic<float> _speed;
     std::atomic<bool> _stop;
 };
@@ -0,0 +1,376 @@
+#include <algorithm>
+#include <limits>
+
+#include <QIODevice>
+#include <QtEndian>
+
+#include "logger.h"
+#include "profilecodec.h"
+
+#include "ping-message-common.h"
+#include "ping-message-ping1d.h"
+#include "ping-message-ping360.h"
+
+PING_LOGGING_CATEGORY(PING_PROFILECODEC, "ping.profilecodec")
+
+const char ProfileCodec::_magic[2] = {'B', 'Z'};
+
+namespace {
+// Ping protocol framing: start(2) + payload length(2) + message id(2) + src(1) + dst(1) and checksum(2)
+const int pingHeaderLength = 8;
+const int pingChecksumLength = 2;
+
+void appendUint16(QByteArray& output, uint16_t value)
+{
+    output.append(static_cast<char>(value & 0xff));
+    output.append(static_cast<char>(value >> 8));
+}
+
+/**
+ * @brief Find the profile samples inside a ping message
+ *
+ * @param message
+ * @param offset samples offset from the beginning of the message
+ * @param numberOfSamples
+ * @return true if message has samples
+ */
+bool findSamples(const QByteArray& message, int& offset, int& numberOfSamples)
+{
+    ping_message pingMessage(reinterpret_cast<const uint8_t*>(message.constData()), message.size());
+    if (pingMessage.msgDataLength() != static_cast<uint>(message.size())) {
+        return false;
+    }
+
+    const uint8_t* samples = nullptr;
+    switch (pingMessage.message_id()) {
+    case Ping1dId::PROFILE: {
+        auto profile = static_cast<ping1d_profile*>(&pingMessage);
+        samples = profile->profile_data();
+        numberOfSamples = profile->profile_data_length();
+        break;
+    }
+    case Ping360Id::DEVICE_DATA: {
+        auto deviceData = static_cast<ping360_device_data*>(&pingMessage);
+        samples = deviceData->data();
+        numberOfSamples = deviceData->data_length();
+        break;
+    }
+    case Ping360Id::AUTO_DEVICE_DATA: {
+        auto autoDeviceData = static_cast<ping360_auto_device_data*>(&pingMessage);
+        samples = autoDeviceData->data();
+        numberOfSamples = autoDeviceData->data_length();
+        break;
+    }
+    default:
+        return false;
+    }
+
+    offset = samples - pingMessage.msgData;
+    // Samples are always the last field of the payload
+    return numberOfSamples > 0 && offset + numberOfSamples + pingChecksumLength == message.size();
+}
+} // namespace
+
+QByteArray ProfileCodec::encode(const QByteArray& message, Level level)
+{
+    if (level == Level::Raw || message.size() < pingHeaderLength + pingChecksumLength) {
+        return message;
+    }
+
+    int offset = 0;
+    int numberOfSamples = 0;
+    if (!findSamples(message, offset, numberOfSamples)) {
+        return message;
+    }
+
+    QByteArray encodedSamples;
+    encodedSamples.reserve(numberOfSamples);
+    packSamples(reinterpret_cast<const uint8_t*>(message.constData()) + offset, numberOfSamples, level, encodedSamples);
+
+    // Nothing to gain, forward the original message
+    if (_frameHeaderLength + offset + encodedSamples.size() >= message.size()
+        || encodedSamples.size() > std::numeric_limits<uint16_t>::max()) {
+        return message;
+    }
+
+    QByteArray frame;
+    frame.reserve(_frameHeaderLength + offset + encodedSamples.size());
+    frame.append(_magic, sizeof(_magic));
+    frame.append(static_cast<char>(level));
+    appendUint16(frame, numberOfSamples);
+    appendUint16(frame, offset);
+    appendUint16(frame, encodedSamples.size());
+    frame.append(message.constData(), offset);
+    frame.append(encodedSamples);
+    return frame;
+}
+
+QByteArray ProfileCodec::decode(const QByteArray& data)
+{
+    if (!isEncoded(data)) {
+        return data;
+    }
+
+    QByteArray output;
+    int position = 0;
+    while (position < data.size()) {
+        const auto frame = reinterpret_cast<const uint8_t*>(data.constData()) + position;
+        const int available = data.size() - position;
+        if (available < _frameHeaderLength || frame[0] != _magic[0] || frame[1] != _magic[1]) {
+            // Not a frame, let the parser deal with it
+            output.append(data.constData() + position, available);
+            break;
+        }
+
+        const auto level = static_cast<Level>(frame[2]);
+        const int numberOfSamples = qFromLittleEndian<uint16_t>(frame + 3);
+        const int prefixLength = qFromLittleEndian<uint16_t>(frame + 5);
+        const int encodedLength = qFromLittleEndian<uint16_t>(frame + 7);
+        const int frameLength = _frameHeaderLength + prefixLength + encodedLength;
+        if (frameLength > available || prefixLength < pingHeaderLength || level > Level::Decimated) {
+            qCWarning(PING_PROFILECODEC) << "Invalid encoded frame, dropping" << available << "bytes.";
+            break;
+        }
+
+        const int messageStart = output.size();
+        const int messageLength = prefixLength + numberOfSamples + pingChecksumLength;
+        output.resize(messageStart + messageLength);
+        auto message = reinterpret_cast<uint8_t*>(output.data()) + messageStart;
+        memcpy(message, frame + _frameHeaderLength, prefixLength);
+
+        if (!unpackSamples(frame + _frameHeaderLength + prefixLength, encodedLength, level, message + prefixLength,
+                numberOfSamples)) {
+            qCWarning(PING_PROFILECODEC) << "Corrupted encoded samples, dropping frame.";
+            output.resize(messageStart);
+            position += frameLength;
+            continue;
+        }
+
+        uint16_t checksum = 0;
+        for (int i = 0; i < messageLength - pingChecksumLength; i++) {
+            checksum += message[i];
+        }
+        qToLittleEndian<uint16_t>(checksum, message + messageLength - pingChecksumLength);
+
+        position += frameLength;
+    }
+
+    return output;
+}
+
+bool ProfileCodec::isEncoded(const QByteArray& data)
+{
+    return data.size() >= _frameHeaderLength && data[0] == _magic[0] && data[1] == _magic[1];
+}
+
+ProfileCodec::Level ProfileCodec::levelForThroughput(
+    float availableBytesPerSecond, float rawBytesPerSecond, const std::array<float, 4>& ratios)
+{
+    // Keep some room for other messages and throughput fluctuations
+    static const float headroom = 1.25f;
+
+    if (availableBytesPerSecond <= 0 || rawBytesPerSecond <= 0) {
+        return Level::Lossless;
+    }
+
+    const float requiredRatio = rawBytesPerSecond * headroom / availableBytesPerSecond;
+    for (auto level : {Level::Lossless, Level::Quantized}) {
+        if (ratios[static_cast<int>(level)] >= requiredRatio) {
+            return level;
+        }
+    }
+    return Level::Decimated;
+}
+
+void ProfileCodec::packSamples(const uint8_t* samples, int size, Level level, QByteArray& output)
+{
+    // Reduce and delta encode the samples
+    const int numberOfValues = level == Level::Decimated ? (size + 1) / 2 : size;
+    QByteArray deltas(numberOfValues, Qt::Uninitialized);
+    uint8_t lastValue = 0;
+    for (int i = 0; i < numberOfValues; i++) {
+        uint8_t value;
+        switch (level) {
+        case Level::Decimated:
+            // Keep the peak to not lose small targets
+            value = qMax(samples[2 * i], samples[qMin(2 * i + 1, size - 1)]) >> 2;
+            break;
+        case Level::Quantized:
+            value = samples[i] >> 2;
+            break;
+        default:
+            value = samples[i];
+            break;
+        }
+        deltas[i] = static_cast<char>(value - lastValue);
+        lastValue = value;
+    }
+
+    // Run-length, control byte:
+    //  [0, 127]: next control + 1 bytes are literals
+    //  [128, 255]: next byte is repeated control - 125 times
+    const auto values = reinterpret_cast<const uint8_t*>(deltas.constData());
+    int i = 0;
+    while (i < numberOfValues) {
+        int run = 1;
+        while (i + run < numberOfValues && run < 130 && values[i + run] == values[i]) {
+            run++;
+        }
+        if (run >= 3) {
+            output.append(static_cast<char>(125 + run));
+            output.append(static_cast<char>(values[i]));
+            i += run;
+            continue;
+        }
+
+        const int start = i;
+        while (i < numberOfValues && i - start < 128) {
+            if (i + 2 < numberOfValues && values[i] == values[i + 1] && values[i] == values[i + 2]) {
+                break;
+            }
+            i++;
+        }
+        output.append(static_cast<char>(i - start - 1));
+        output.append(deltas.constData() + start, i - start);
+    }
+}
+
+bool ProfileCodec::unpackSamples(const uint8_t* data, int size, Level level, uint8_t* samples, int numberOfSamples)
+{
+    const int numberOfValues = level == Level::Decimated ? (numberOfSamples + 1) / 2 : numberOfSamples;
+
+    // Decoded values are written in the samples buffer and expanded later
+    int position = 0;
+    int valueIndex = 0;
+    uint8_t lastValue = 0;
+    auto appendDelta = [&](uint8_t delta) {
+        lastValue += delta;
+        samples[valueIndex++] = lastValue;
+    };
+
+    while (position < size && valueIndex < numberOfValues) {
+        const uint8_t control = data[position++];
+        if (control < 128) {
+            const int count = control + 1;
+            if (position + count > size || valueIndex + count > numberOfValues) {
+                return false;
+            }
+            for (int i = 0; i < count; i++) {
+                appendDelta(data[position++]);
+            }
+        } else {
+            const int count = control - 125;
+            if (position >= size || valueIndex + count > numberOfValues) {
+                return false;
+            }
+            const uint8_t delta = data[position++];
+            for (int i = 0; i < count; i++) {
+                appendDelta(delta);
+            }
+        }
+    }
+
+    if (valueIndex != numberOfValues || position != size) {
+        return false;
+    }
+
+    switch (level) {
+    case Level::Decimated:
+        // Expand from the end to not overwrite values that were not used yet
+        for (int i = numberOfSamples - 1; i >= 0; i--) {
+            samples[i] = samples[i / 2] << 2;
+        }
+        break;
+    case Level::Quantized:
+        for (int i = 0; i < numberOfSamples; i++) {
+            samples[i] = samples[i] << 2;
+        }
+        break;
+    default:
+        break;
+    }
+
+    return true;
+}
+
+ProfileEncoder::~ProfileEncoder() { QObject::disconnect(_deviceConnection); }
+
+void ProfileEncoder::setDevice(QIODevice* device)
+{
+    QObject::disconnect(_deviceConnection);
+    _device = device;
+    _deviceWrittenBytes = 0;
+    _deviceBacklog = 0;
+    _deviceFailedWrites = 0;
+    if (_device) {
+        _deviceConnection = QObject::connect(
+            _device, &QIODevice::bytesWritten, [this](qint64 bytes) { _deviceWrittenBytes += bytes; });
+    }
+}
+
+QByteArray ProfileEncoder::encode(const QByteArray& message)
+{
+    if (!_window.isValid()) {
+        _window.start();
+    }
+    _rawBytes += message.size();
+    updateThroughput();
+
+    // Measure every level, the ratios change with the content of the profiles
+    if (_messagesToProbe-- <= 0) {
+        _messagesToProbe = probeInterval;
+        for (auto level :
+            {ProfileCodec::Level::Lossless, ProfileCodec::Level::Quantized, ProfileCodec::Level::Decimated}) {
+            const float ratio = static_cast<float>(message.size()) / ProfileCodec::encode(message, level).size();
+            float& average = _ratios[static_cast<int>(level)];
+            average = average > 0 ? average * 0.75f + ratio * 0.25f : ratio;
+        }
+    }
+
+    _level = ProfileCodec::levelForThroughput(_linkBytesPerSecond, _rawBytesPerSecond, _ratios);
+    return ProfileCodec::encode(message, _level);
+}
+
+bool ProfileEncoder::write(const QByteArray& message)
+{
+    if (!_device) {
+        return false;
+    }
+
+    const QByteArray frame = encode(message);
+    if (_device->write(frame) != frame.size()) {
+        // Datagram devices do not keep a backlog, a saturated link makes the writes fail
+        _deviceFailedWrites++;
+        return false;
+    }
+    return true;
+}
+
+void ProfileEncoder::updateThroughput()
+{
+    static const qint64 windowMs = 1000;
+    const qint64 elapsedMs = _window.elapsed();
+    if (elapsedMs < windowMs) {
+        return;
+    }
+
+    _window.restart();
+    _rawBytesPerSecond = _rawBytes * 1000.0f / elapsedMs;
+    _rawBytes = 0;
+
+    if (!_device) {
+        return;
+    }
+
+    // The device only shows its throughput when data is waiting to be written
+    const float writtenBytesPerSecond = _deviceWrittenBytes * 1000.0f / elapsedMs;
+    const qint64 backlog = _device->bytesToWrite();
+    if ((backlog > 0 && backlog >= _deviceBacklog) || _deviceFailedWrites > 0) {
+        _linkBytesPerSecond = writtenBytesPerSecond;
+    } else if (_linkBytesPerSecond > 0) {
+        _linkBytesPerSecond = std::max(_linkBytesPerSecond * 1.1f, writtenBytesPerSecond);
+    }
+    _deviceBacklog = backlog;
+    _deviceFailedWrites = 0;
+    _deviceWrittenBytes = 0;
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <array>
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPointer>
+
+class QIODevice;
+
+/**
+ * @brief Compact encoding of profile messages for constrained links
+ *  Profile messages (ping1d profile, ping360 device_data and auto_device_data) are mostly made of
+ *  slowly changing intensity samples. The samples are delta encoded and run-length packed,
+ *  optionally after a lossy quantization or decimation step, while the message fields are kept intact.
+ *  The receiving side gets back a valid ping message with a recalculated checksum.
+ *
+ *  Encoded frame (little endian):
+ *      magic "BZ" | level u8 | number of samples u16 | prefix length u16 | encoded length u16 |
+ *      prefix (message bytes before the samples) | encoded samples
+ */
+class ProfileCodec {
+public:
+    /**
+     * @brief Compression levels, from the most accurate to the most compact
+     *
+     */
+    enum class Level : uint8_t {
+        Raw = 0, // Message is not encoded
+        Lossless, // Delta + run-length over the samples
+        Quantized, // Samples reduced to 6 bits before delta + run-length
+        Decimated, // Quantized and max-decimated by 2
+    };
+
+    /**
+     * @brief Encode a single ping message
+     *  Messages without profile samples or the Raw level return the message unchanged
+     *
+     * @param message raw ping message
+     * @param level compression level
+     * @return QByteArray encoded frame
+     */
+    static QByteArray encode(const QByteArray& message, Level level);
+
+    /**
+     * @brief Decode a buffer that may contain encoded frames
+     *  Encoded frames are expanded back to ping messages, anything else is returned as is
+     *
+     * @param data received buffer
+     * @return QByteArray raw ping data
+     */
+    static QByteArray decode(const QByteArray& data);
+
+    /**
+     * @brief Check if buffer starts with an encoded frame
+     *
+     * @param data
+     * @return true
+     * @return false
+     */
+    static bool isEncoded(const QByteArray& data);
+
+    /**
+     * @brief Select the most accurate level that fits in the available throughput
+     *
+     * @param availableBytesPerSecond measured link throughput, unknown if zero or negative
+     * @param rawBytesPerSecond profile data rate before compression
+     * @param ratios measured compression ratio of each level, unknown if zero or negative
+     * @return Level
+     */
+    static Level levelForThroughput(
+        float availableBytesPerSecond, float rawBytesPerSecond, const std::array<float, 4>& ratios);
+
+private:
+    static void packSamples(const uint8_t* samples, int size, Level level, QByteArray& output);
+    static bool unpackSamples(const uint8_t* data, int size, Level level, uint8_t* samples, int numberOfSamples);
+
+    static const char _magic[2];
+    static const int _frameHeaderLength = 9;
+};
+
+/**
+ * @brief Encode profiles with the level that fits in the measured throughput of the output link
+ *  The compression ratio of each level is measured from the encoded profiles, all levels are
+ *  tried periodically to follow the content. The raw data rate is measured from the encoded messages.
+ *
+ *  When an output device is set, the link throughput is measured from the bytes written by the device:
+ *  it is only known while the device has a backlog of data to write or fails to write a datagram,
+ *  otherwise it is increased slowly to move back to a more accurate level.
+ */
+class ProfileEncoder {
+public:
+    ProfileEncoder() = default;
+    ~ProfileEncoder();
+
+    /**
+     * @brief Set the device used to write the encoded profiles, its throughput is measured
+     *
+     * @param device
+     */
+    void setDevice(QIODevice* device);
+
+    /**
+     * @brief Set the link throughput when it is measured outside of the encoder
+     *
+     * @param bytesPerSecond unknown if zero or negative
+     */
+    void setLinkThroughput(float bytesPerSecond) { _linkBytesPerSecond = bytesPerSecond; };
+
+    /**
+     * @brief Return the link throughput used to select the level
+     *
+     * @return float
+     */
+    float linkThroughput() const { return _linkBytesPerSecond; };
+
+    /**
+     * @brief Encode a single ping message with the selected level
+     *
+     * @param message raw ping message
+     * @return QByteArray encoded frame
+     */
+    QByteArray encode(const QByteArray& message);
+
+    /**
+     * @brief Encode a single ping message and write it to the device
+     *
+     * @param message raw ping message
+     * @return true
+     * @return false if there is no device or it failed to write the frame
+     */
+    bool write(const QByteArray& message);
+
+    /**
+     * @brief Return the level used for the last message
+     *
+     * @return ProfileCodec::Level
+     */
+    ProfileCodec::Level level() const { return _level; };
+
+    /**
+     * @brief Return the measured compression ratio of a level
+     *
+     * @param level
+     * @return float zero if it was not measured
+     */
+    float ratio(ProfileCodec::Level level) const { return _ratios[static_cast<int>(level)]; };
+
+    // Number of messages between measurements of all levels
+    static const int probeInterval = 32;
+
+private:
+    void updateThroughput();
+
+    qint64 _deviceBacklog = 0;
+    QMetaObject::Connection _deviceConnection;
+    qint64 _deviceFailedWrites = 0;
+    qint64 _deviceWrittenBytes = 0;
+    QPointer<QIODevice> _device;
+    ProfileCodec::Level _level = ProfileCodec::Level::Lossless;
+    float _linkBytesPerSecond = 0;
+    int _messagesToProbe = 0;
+    std::array<float, 4> _ratios {1, 0, 0, 0};
+    qint64 _rawBytes = 0;
+    float _rawBytesPerSecond = 0;
+    QElapsedTimer _window;
+
+    Q_DISABLE_COPY(ProfileEncoder)
+};
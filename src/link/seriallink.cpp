@@ -43,6 +43,7 @@ SerialLink::SerialLink(QObject* parent)
             qCWarning(PING_PROTOCOL_SERIALLINK) << "Error is critical ! Port need to be closed.";
             qCWarning(PING_PROTOCOL_SERIALLINK) << "Error:" << error;
             finishConnection();
+            emit connectionLost();
             break;
         }
     });
@@ -95,14 +96,13 @@ bool SerialLink::finishConnection()
 
 QStringList SerialLink::listAvailableConnections()
 {
-    static QStringList list;
-    auto oldList = list;
-    list.clear();
+    QStringList list;
     auto ports = QSerialPortInfo::availablePorts();
     for (const auto& port : ports) {
         list.append(port.portName());
     }
-    if (oldList != list) {
+    if (_availableConnections != list) {
+        _availableConnections = list;
         emit availableConnectionsChanged();
     }
     return list;
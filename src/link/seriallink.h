@@ -107,5 +107,6 @@ public:
     bool setLowLatency();
 
 private:
+    QStringList _availableConnections;
     QSerialPort _port;
 };
@@ -1,6 +1,169 @@
 #include "simulationlink.h"
+#include "logger.h"
+
+PING_LOGGING_CATEGORY(PING_SIMULATIONLINK, "ping.simulationlink")
 
 SimulationLink::SimulationLink(QObject* parent)
     : AbstractLink("SimulationLink", parent)
 {
-}
\ No newline at end of file
+    // Default timers can not follow thousands of profiles per second
+    _generatorTimer.setTimerType(Qt::PreciseTimer);
+    connect(&_generatorTimer, &QTimer::timeout, this, &SimulationLink::generate);
+}
+
+bool SimulationLink::setConfiguration(const LinkConfiguration& linkConfiguration)
+{
+    AbstractLink::setConfiguration(linkConfiguration);
+
+    Options options = _defaultOptions;
+    if (!parseOptions(*linkConfiguration.args(), options)) {
+        return false;
+    }
+
+    applyOptions(options);
+    return true;
+}
+
+bool SimulationLink::parseOptions(const QStringList& args, Options& options)
+{
+    for (const auto& arg : args) {
+        const QString key = arg.section('=', 0, 0);
+        const QString value = arg.section('=', 1);
+        bool ok = false;
+
+        if (key == QLatin1String("rate")) {
+            options.rate = value.toInt(&ok);
+            ok = ok && options.rate >= 0;
+        } else if (key == QLatin1String("samples")) {
+            options.samples = value.toInt(&ok);
+            ok = ok && options.samples > 0;
+        } else if (key == QLatin1String("templates")) {
+            options.templates = value.toInt(&ok);
+            ok = ok && options.templates > 0;
+        } else if (key == QLatin1String("burst")) {
+            options.burst = value.toInt(&ok);
+            ok = ok && options.burst >= 0;
+        } else if (key == QLatin1String("period")) {
+            options.burstPeriodMs = value.toInt(&ok);
+            ok = ok && options.burstPeriodMs > 0;
+        } else if (key == QLatin1String("fragment")) {
+            options.fragmentSize = value.toInt(&ok);
+            ok = ok && options.fragmentSize >= 0;
+        } else if (key == QLatin1String("corruption")) {
+            options.corruption = value.toFloat(&ok);
+            ok = ok && options.corruption >= 0 && options.corruption <= 1;
+        }
+
+        if (!ok) {
+            qCWarning(PING_SIMULATIONLINK) << "Invalid simulation argument:" << arg;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void SimulationLink::setDefaultOptions(const Options& options)
+{
+    _defaultOptions = options;
+    applyOptions(options);
+}
+
+void SimulationLink::applyOptions(const Options& options)
+{
+    _generatorTimer.stop();
+
+    // Profiles are generated before sending anything, so the generator is never the bottleneck
+    if (_templates.isEmpty() || options.samples != _options.samples || options.templates != _options.templates) {
+        _templates.clear();
+        _templates.reserve(options.templates);
+        for (int i {0}; i < options.templates; i++) {
+            _templates.append(createProfile(i, options.samples));
+        }
+    }
+
+    _options = options;
+    _templateIndex = 0;
+    _pendingData.clear();
+    _generatedProfiles = 0;
+
+    qCDebug(PING_SIMULATIONLINK) << "Load generator:" << _options.rate << "profiles/s with" << _options.samples
+                                 << "samples, bursts of" << _options.burst << "profiles, fragments of"
+                                 << _options.fragmentSize << "bytes and corruption of" << _options.corruption;
+
+    if (_options.burst) {
+        _generatorTimer.start(_options.burstPeriodMs);
+    } else if (_options.rate) {
+        _generatorTimer.start(qMax(1, 1000 / _options.rate));
+    }
+    _generatorElapsed.start();
+}
+
+void SimulationLink::generate()
+{
+    if (_options.burst) {
+        for (int i {0}; i < _options.burst; i++) {
+            sendProfile();
+        }
+        return;
+    }
+
+    // Timers do not run faster than 1 ms, profiles that are due are sent together
+    const qint64 dueProfiles = _generatorElapsed.nsecsElapsed() * _options.rate / 1000000000;
+    // Do not try to catch up after the event loop was blocked
+    const qint64 numberOfProfiles = qMin(dueProfiles - _generatedProfiles, static_cast<qint64>(_options.rate));
+    for (qint64 i {0}; i < numberOfProfiles; i++) {
+        sendProfile();
+    }
+    _generatedProfiles = dueProfiles;
+}
+
+void SimulationLink::sendProfile()
+{
+    if (_templates.isEmpty()) {
+        return;
+    }
+
+    QByteArray profile = _templates[_templateIndex];
+    _templateIndex = (_templateIndex + 1) % _templates.size();
+
+    auto random = QRandomGenerator::global();
+    if (_options.corruption > 0 && random->generateDouble() < _options.corruption) {
+        const int position = random->bounded(profile.size());
+        profile[position] = static_cast<char>(profile.at(position) ^ (1 + random->bounded(255)));
+        _statistics.corruptedProfiles++;
+    }
+    _statistics.profiles++;
+    _statistics.bytes += profile.size();
+
+    if (!_options.fragmentSize) {
+        emit newData(profile);
+        return;
+    }
+
+    _pendingData.append(profile);
+    int position = 0;
+    while (_pendingData.size() - position >= _options.fragmentSize) {
+        emit newData(_pendingData.mid(position, _options.fragmentSize));
+        position += _options.fragmentSize;
+    }
+    _pendingData.remove(0, position);
+
+    // Profiles sent by request are not followed by others, the end of the profile can not wait for them
+    if (!_options.rate && !_pendingData.isEmpty()) {
+        emit newData(_pendingData);
+        _pendingData.clear();
+    }
+}
+
+bool SimulationLink::finishConnection()
+{
+    _generatorTimer.stop();
+    return true;
+}
+
+SimulationLink::~SimulationLink()
+{
+    qCDebug(PING_SIMULATIONLINK) << "Simulation sent" << _statistics.profiles << "profiles with"
+                                 << _statistics.bytes << "bytes," << _statistics.corruptedProfiles << "corrupted.";
+}
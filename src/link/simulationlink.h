@@ -3,11 +3,27 @@
 #include "abstractlink.h"
 #include "pingparserext.h"
 
+#include <QElapsedTimer>
+#include <QLoggingCategory>
 #include <QRandomGenerator>
+#include <QTimer>
+#include <QVector>
+
+Q_DECLARE_LOGGING_CATEGORY(PING_SIMULATIONLINK)
 
 /**
  * @brief Simulation connection class
- *
+ *  Profiles are generated once as templates and sent by a load generator.
+ *  The load can be configured with link arguments in the key=value format:
+ *   rate: profiles per second, zero to only send profiles by request
+ *   samples: number of samples in each profile
+ *   templates: number of different profiles generated
+ *   burst: number of profiles sent together each period, zero for a constant rate
+ *   period: burst period in milliseconds
+ *   fragment: size of the data chunks sent by the link, zero for complete messages,
+ *    with rate zero each profile ends with its last chunk
+ *   corruption: probability of a profile with a corrupted byte
+ *  E.g: Ping1D:5:rate=2000:samples=1000:fragment=7:corruption=0.01
  */
 class SimulationLink : public AbstractLink {
 public:
@@ -18,6 +34,12 @@ public:
      */
     SimulationLink(QObject* parent = nullptr);
 
+    /**
+     * @brief Destroy the Simulation Link object
+     *
+     */
+    ~SimulationLink();
+
     /**
      * @brief Check if connection is writable
      *
@@ -26,6 +48,60 @@ public:
      */
     bool isWritable() override { return false; };
 
+    /**
+     * @brief Configure the load generator with the link arguments
+     *
+     * @param linkConfiguration
+     * @return true
+     * @return false when an argument is invalid
+     */
+    bool setConfiguration(const LinkConfiguration& linkConfiguration) override;
+
+    /**
+     * @brief Stop the load generator
+     *
+     * @return true
+     */
+    bool finishConnection() override;
+
+    /**
+     * @brief Load generator configuration
+     *
+     */
+    struct Options {
+        int rate = 0;
+        int samples = 200;
+        int templates = 1;
+        int burst = 0;
+        int burstPeriodMs = 1000;
+        int fragmentSize = 0;
+        float corruption = 0;
+    };
+
+    /**
+     * @brief Counters of the generated data
+     *
+     */
+    struct Statistics {
+        quint64 profiles = 0;
+        quint64 corruptedProfiles = 0;
+        quint64 bytes = 0;
+    };
+
+    /**
+     * @brief Return the load generator configuration
+     *
+     * @return const Options&
+     */
+    const Options& options() const { return _options; };
+
+    /**
+     * @brief Return the counters of the generated data
+     *
+     * @return const Statistics&
+     */
+    const Statistics& statistics() const { return _statistics; };
+
 protected:
     /**
      * @brief Limit the random generation to the interval of max and min possible values of T
@@ -36,4 +112,65 @@ protected:
     {
         return QRandomGenerator::global()->bounded(std::numeric_limits<T>::max() + 1);
     };
+
+    /**
+     * @brief Create a complete message with a profile, used to fill the templates
+     *
+     * @param index of the template
+     * @param samples
+     * @return QByteArray
+     */
+    virtual QByteArray createProfile(int index, int samples) = 0;
+
+    /**
+     * @brief Set the options used when the link arguments do not change them
+     *  Should be called by the constructor of the final class
+     *
+     * @param options
+     */
+    void setDefaultOptions(const Options& options);
+
+    /**
+     * @brief Send the next profile template
+     *
+     */
+    void sendProfile();
+
+private:
+    /**
+     * @brief Parse the link arguments
+     *
+     * @param args
+     * @param options
+     * @return true
+     * @return false
+     */
+    static bool parseOptions(const QStringList& args, Options& options);
+
+    /**
+     * @brief Generate the profile templates and start the load generator
+     *
+     * @param options
+     */
+    void applyOptions(const Options& options);
+
+    /**
+     * @brief Send the profiles that are due
+     *
+     */
+    void generate();
+
+    Options _defaultOptions;
+    Options _options;
+    Statistics _statistics;
+
+    QVector<QByteArray> _templates;
+    int _templateIndex = 0;
+    // Fragments do not follow message boundaries while profiles are generated,
+    // profiles sent by request end with a shorter fragment
+    QByteArray _pendingData;
+
+    QTimer _generatorTimer;
+    QElapsedTimer _generatorElapsed;
+    qint64 _generatedProfiles = 0;
 };
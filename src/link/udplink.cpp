@@ -3,6 +3,7 @@
 #include <QNetworkDatagram>
 
 #include "logger.h"
+#include "profilecodec.h"
 #include "udplink.h"
 
 PING_LOGGING_CATEGORY(PING_PROTOCOL_UDPLINK, "ping.protocol.udplink")
@@ -13,7 +14,9 @@ UDPLink::UDPLink(QObject* parent)
 {
     setType(LinkType::Udp);
 
-    connect(_udpSocket, &QIODevice::readyRead, this, [this] { emit newData(_udpSocket->readAll()); });
+    // Forwarded profiles may arrive compressed, the rest of the application only deals with ping messages
+    connect(_udpSocket, &QIODevice::readyRead, this,
+        [this] { emit newData(ProfileCodec::decode(_udpSocket->readAll())); });
     connect(_udpSocket, &QAbstractSocket::errorOccurred, this,
         [this](QAbstractSocket::SocketError /*socketError*/) { printErrorMessage(); });
 
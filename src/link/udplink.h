@@ -23,6 +23,13 @@ public:
      */
     ~UDPLink();
 
+    /**
+     * @brief Return the socket that writes the link data
+     *
+     * @return QIODevice*
+     */
+    QIODevice* device() final { return _udpSocket; };
+
     /**
      * @brief Return a human friendly error message
      *
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QDataStream>
+#include <QFile>
+#include <QString>
+#include <QTemporaryDir>
+
+#include "logfilereader.h"
+#include "logfilewriter.h"
+#include "logsensorstruct.h"
+
+/**
+ * @brief Open a sensor log, read its header and index its records
+ *
+ * @param fileName
+ * @param file kept open while the reader is used
+ * @param reader
+ * @param header optional, filled with the log header
+ * @return true
+ * @return false
+ */
+inline bool openLog(const QString& fileName, QFile& file, LogFileReader& reader, LogSensorStruct* header = nullptr)
+{
+    file.close();
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    LogSensorStruct logSensorStruct;
+    stream >> logSensorStruct;
+    if (header) {
+        *header = logSensorStruct;
+    }
+    return logSensorStruct.isValid() && reader.open(fileName, file.pos(), logSensorStruct.version);
+}
+
+/**
+ * @brief Sensor log in a temporary directory, written and read back by the keyframes test
+ *  The writer and header can be configured before create().
+ */
+struct LogFixture {
+    LogFixture() { header.init(); }
+
+    /**
+     * @brief Start writing a new log in the temporary directory
+     *
+     * @param name
+     * @return true
+     * @return false
+     */
+    bool create(const QString& name)
+    {
+        fileName = dir.filePath(name);
+        return dir.isValid() && writer.open(fileName, header);
+    }
+
+    /**
+     * @brief Finish the log and open it with the reader
+     *
+     * @return true
+     * @return false
+     */
+    bool open()
+    {
+        writer.close();
+        return openLog(fileName, file, reader, &readHeader);
+    }
+
+    QTemporaryDir dir;
+    QString fileName;
+    LogSensorStruct header;
+    LogSensorStruct readHeader;
+    LogFileWriter writer;
+    QFile file;
+    LogFileReader reader;
+};
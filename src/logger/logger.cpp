@@ -10,10 +10,16 @@
 #include <QString>
 #include <QTime>
 #include <QtConcurrent>
+#include <cstring>
 #include <iostream>
 
 PING_LOGGING_CATEGORY(logger, "ping.logger")
 
+namespace {
+// Maximum time that a message waits in the queue when nobody wakes the output thread
+const int outputIntervalMs = 50;
+} // namespace
+
 Logger::Logger()
     : _file(FileManager::self()->createFileName(FileManager::Folder::GuiLogs))
     , _fileStream(&_file)
@@ -30,7 +36,15 @@ Logger::Logger()
 
 void Logger::installHandler()
 {
-    self()->logModel()->start();
+    Logger* instance = self();
+    instance->logModel()->start();
+
+    if (!instance->_thread) {
+        instance->_running = true;
+        instance->_thread.reset(QThread::create([instance] { instance->run(); }));
+        instance->_thread->setObjectName(QStringLiteral("Logger"));
+        instance->_thread->start(QThread::LowPriority);
+    }
     qInstallMessageHandler(handleMessage);
 
     if (qEnvironmentVariableIsEmpty("QT_MESSAGE_PATTERN")) {
@@ -46,34 +60,75 @@ QObject* Logger::qmlSingletonRegister(QQmlEngine* engine, QJSEngine* scriptEngin
     return self();
 }
 
-void Logger::logMessage(const QString& msg, const QtMsgType& type, const QMessageLogContext& context)
+Logger::Category Logger::category(const char* name)
 {
-    const QString time = QTime::currentTime().toString(QStringLiteral("[hh:mm:ss:zzz]"));
+    if (!name) {
+        name = "default";
+    }
 
-    // Save the message into the file
-    _fileStream << QString("%1 %2\n").arg(time, msg);
+    // Avoid locks and allocations for categories that were already used by this thread
+    thread_local QHash<QByteArray, Category> cache;
+    const auto iterator = cache.constFind(QByteArray::fromRawData(name, static_cast<int>(qstrlen(name))));
+    if (iterator != cache.constEnd()) {
+        return *iterator;
+    }
 
-    _logModel.append(time, msg, _colors[type], _categoryIndexer[context.category]);
+    registerCategory(name);
+    const Category category {QByteArray(name), getCategoryIndex(name)};
+    cache.insert(category.name, category);
+    return category;
 }
 
-void Logger::handleMessage(QtMsgType type, const QMessageLogContext& context, const QString& msg)
+Logger::Record Logger::createRecord(const QString& msg, QtMsgType type, const QMessageLogContext& context)
+{
+    const Category messageCategory = category(context.category);
+
+    Record record;
+    record.message = msg;
+    record.category = messageCategory.name;
+    record.categoryIndex = messageCategory.index;
+    record.msecsSinceStartOfDay = QTime::currentTime().msecsSinceStartOfDay();
+    record.type = type;
+    record.line = context.line;
+    if (context.file) {
+        const char* file = std::strrchr(context.file, '/');
+        qstrncpy(record.file, file ? file + 1 : context.file, sizeof(record.file));
+    }
+    return record;
+}
+
+void Logger::logMessage(const QString& msg, const QtMsgType& type, const QMessageLogContext& context)
 {
-    // Check if category is not registered and add it in Logger
-    Logger::self()->registerCategory(context.category);
+    if (!_queue.push(createRecord(msg, type, context))) {
+        _droppedMessages.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
 
+    if (_outputWaiting.load(std::memory_order_relaxed)) {
+        _messagesAvailable.wakeOne();
+    }
+}
+
+void Logger::output(const Record& record)
+{
     static const QString msgTypes[] = {"Debug", "Warning", "Critical", "Fatal", "Info"};
-    const QString file = QString(context.file).split('/').last();
+    const QString time = QTime::fromMSecsSinceStartOfDay(record.msecsSinceStartOfDay)
+                             .toString(QStringLiteral("[hh:mm:ss:zzz]"));
     QString fileInfo;
-    if (!file.isEmpty()) {
-        fileInfo = QString("%1(%2) ").arg(file).arg(context.line);
+    if (record.file[0]) {
+        fileInfo = QString("%1(%2) ").arg(QLatin1String(record.file)).arg(record.line);
     }
 
-    const QString logMsg = QString("%1[%2]: %3%4").arg(context.category, msgTypes[type], fileInfo, msg);
+    const QString logMsg
+        = QString("%1[%2]: %3%4").arg(QLatin1String(record.category), msgTypes[record.type], fileInfo, record.message);
+
+    // Save the message into the file
+    _fileStream << time << ' ' << logMsg << '\n';
 
-    Logger::self()->logMessage(logMsg, type, context);
+    _logModel.append(time, logMsg, _colors[record.type], record.categoryIndex);
 
     fmt::text_style style;
-    switch (type) {
+    switch (record.type) {
     case QtDebugMsg:
         style = fg(fmt::terminal_color::bright_green);
         break;
@@ -90,23 +145,104 @@ void Logger::handleMessage(QtMsgType type, const QMessageLogContext& context, co
         style = fmt::emphasis::bold | fg(fmt::color::yellow) | bg(fmt::color::red);
         break;
     }
-    fmt::print(style, "{}\n", qFormatLogMessage(type, context, logMsg).toStdString());
+    const QMessageLogContext context(record.file, record.line, nullptr, record.category.constData());
+    fmt::print(style, "{}\n", qFormatLogMessage(record.type, context, logMsg).toStdString());
 }
 
-void Logger::registerCategory(const char* category)
+void Logger::outputQueued()
 {
-    if (_registeredCategories.contains(category)) {
+    QMutexLocker locker(&_outputMutex);
+
+    Record record;
+    bool written = false;
+    while (_queue.pop(record)) {
+        output(record);
+        written = true;
+    }
+
+    const quint64 droppedMessages = _droppedMessages.load(std::memory_order_relaxed);
+    if (droppedMessages != _reportedDroppedMessages) {
+        const QMessageLogContext context(nullptr, 0, nullptr, "ping.logger");
+        output(createRecord(QStringLiteral("%1 messages were dropped, the log output could not keep up.")
+                                .arg(droppedMessages - _reportedDroppedMessages),
+            QtWarningMsg, context));
+        _reportedDroppedMessages = droppedMessages;
+        written = true;
+    }
+
+    // A single write for all the messages of the batch
+    if (written) {
+        _fileStream.flush();
+    }
+}
+
+void Logger::run()
+{
+    while (_running) {
+        {
+            QMutexLocker locker(&_waitMutex);
+            if (_queue.isEmpty() && _running) {
+                _outputWaiting = true;
+                _messagesAvailable.wait(&_waitMutex, outputIntervalMs);
+                _outputWaiting = false;
+            }
+        }
+        outputQueued();
+    }
+    outputQueued();
+}
+
+void Logger::flush()
+{
+    outputQueued();
+    QMutexLocker locker(&_outputMutex);
+    _fileStream.flush();
+}
+
+void Logger::handleMessage(QtMsgType type, const QMessageLogContext& context, const QString& msg)
+{
+    Logger* instance = Logger::self();
+
+    // The application aborts right after a fatal message, everything should be written before that
+    if (type == QtFatalMsg) {
+        QMutexLocker locker(&instance->_outputMutex);
+        instance->outputQueued();
+        instance->output(instance->createRecord(msg, type, context));
+        instance->_fileStream.flush();
         return;
     }
-    // Register each category in a bit, this will help the qml element to be faster when searching between categories
-    _categoryIndexer[category] = 1 << _categoryIndexer.size();
+
+    instance->logMessage(msg, type, context);
+}
+
+void Logger::registerCategory(const char* category)
+{
+    {
+        QMutexLocker locker(&_categoryMutex);
+        if (_registeredCategories.contains(category)) {
+            return;
+        }
+        // Register each category in a bit, this will help the qml element to be faster when searching between
+        // categories
+        _categoryIndexer[category] = 1 << _categoryIndexer.size();
+        _registeredCategories << category;
+    }
 
     qCDebug(logger) << "New category registered: " << category;
-    _registeredCategories << category;
     emit registeredCategoryChanged();
 }
 
-uint Logger::getCategoryIndex(const QString& category) { return _categoryIndexer[category]; }
+QStringList Logger::registeredCategory()
+{
+    QMutexLocker locker(&_categoryMutex);
+    return _registeredCategories;
+}
+
+uint Logger::getCategoryIndex(const QString& category)
+{
+    QMutexLocker locker(&_categoryMutex);
+    return _categoryIndexer.value(category);
+}
 
 Logger* Logger::self()
 {
@@ -122,4 +258,13 @@ void Logger::test()
     qCritical() << "This is a critical message";
 }
 
-Logger::~Logger() = default;
+Logger::~Logger()
+{
+    qInstallMessageHandler(nullptr);
+    if (_thread) {
+        _running = false;
+        _messagesAvailable.wakeOne();
+        _thread->wait();
+    }
+    outputQueued();
+}
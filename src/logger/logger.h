@@ -2,9 +2,16 @@
 
 #include <QFile>
 #include <QLoggingCategory>
+#include <QMutex>
 #include <QStringListModel>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <memory>
 
 #include "loglistmodel.h"
+#include "logqueue.h"
 
 enum QtMsgType;
 class QJSEngine;
@@ -24,7 +31,9 @@ Q_DECLARE_LOGGING_CATEGORY(logger)
 
 /**
  * @brief Manage the project logger
- *
+ *  Messages are queued without formatting or locks by the thread that creates them,
+ *  the output thread formats them and writes to the file, console and model.
+ *  Messages are dropped and counted when the queue is full, fatal messages are written immediately.
  */
 class Logger : public QObject {
     Q_OBJECT
@@ -58,7 +67,7 @@ public:
      *
      * @return QStringList
      */
-    QStringList registeredCategory() { return _registeredCategories; };
+    QStringList registeredCategory();
     Q_PROPERTY(QStringList registeredCategory READ registeredCategory NOTIFY registeredCategoryChanged)
 
     /**
@@ -109,7 +118,14 @@ public:
      * @brief Force stream to flush all data to the log file
      *
      */
-    void flush() { _fileStream.flush(); };
+    void flush();
+
+    /**
+     * @brief Return the number of messages dropped because the queue was full
+     *
+     * @return quint64
+     */
+    quint64 droppedMessages() const { return _droppedMessages; };
 
 signals:
     void registeredCategoryChanged();
@@ -123,20 +139,95 @@ private:
     Logger();
 
     /**
-     * @brief Log message in the model
+     * @brief Message waiting for the output thread
+     *
+     */
+    struct Record {
+        QString message;
+        QByteArray category;
+        uint categoryIndex = 0;
+        int msecsSinceStartOfDay = 0;
+        QtMsgType type = QtDebugMsg;
+        int line = 0;
+        // Some file names do not live after the message handler, like the ones from qml
+        char file[64] = {};
+    };
+
+    /**
+     * @brief Category name and its bit, cached by each thread
+     *
+     */
+    struct Category {
+        QByteArray name;
+        uint index;
+    };
+
+    /**
+     * @brief Queue message to the outputs
      *
      * @param msg
      * @param type
+     * @param context
      */
     void logMessage(const QString& msg, const QtMsgType& type, const QMessageLogContext& context);
 
+    /**
+     * @brief Return the category, registering it if necessary
+     *
+     * @param category
+     * @return Category
+     */
+    Category category(const char* category);
+
+    /**
+     * @brief Create the record of a message, it should be as fast as possible
+     *
+     * @param msg
+     * @param type
+     * @param context
+     * @return Record
+     */
+    Record createRecord(const QString& msg, QtMsgType type, const QMessageLogContext& context);
+
+    /**
+     * @brief Format and write a message to the file, console and model
+     *
+     * @param record
+     */
+    void output(const Record& record);
+
+    /**
+     * @brief Write all queued messages and report the dropped ones
+     *
+     */
+    void outputQueued();
+
+    /**
+     * @brief Output thread loop
+     *
+     */
+    void run();
+
     QMap<QString, uint> _categoryIndexer;
+    mutable QMutex _categoryMutex;
     // Debug, Warning, Critical, Fatal, Info
     QVector<QColor> _colors {QColor("gray"), QColor("orange"), QColor("red"), QColor("red"), QColor("LimeGreen")};
     QFile _file;
     QTextStream _fileStream;
     QStringList _registeredCategories;
     LogListModel _logModel;
+
+    LogQueue<Record> _queue {8192};
+    std::atomic<quint64> _droppedMessages {0};
+    quint64 _reportedDroppedMessages = 0;
+
+    // Protects the outputs, used by the output thread, flush and fatal messages
+    QRecursiveMutex _outputMutex;
+    QMutex _waitMutex;
+    QWaitCondition _messagesAvailable;
+    std::atomic<bool> _outputWaiting {false};
+    std::atomic<bool> _running {false};
+    std::unique_ptr<QThread> _thread;
 };
 
 /**
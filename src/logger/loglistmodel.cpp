@@ -3,20 +3,16 @@
 LogListModel::LogListModel(QObject* parent)
     : QAbstractListModel(parent)
 {
-    for (const auto& key : _roleNames.keys()) {
-        _roles.append(key);
-        _vectors.insert(key, {});
-    }
+    _messageCategories.resize(capacity);
+    _messageColors.resize(capacity);
+    _messageTexts.resize(capacity);
+    _messageTimes.resize(capacity);
 }
 
 void LogListModel::start()
 {
     // This crashs with msvc if moved to constructor, no workaround was found until now.
 
-    _filter.setSourceModel(this);
-    _filter.setFilterRole(Roles::Visibility);
-    _filter.setFilterWildcard("true");
-
     /**
      * @brief New logs should use append function, and this model will use the main eventloop to handle
      * the multithread problem via signal/emit
@@ -27,28 +23,53 @@ void LogListModel::start()
 QVariant LogListModel::data(const QModelIndex& index, int role) const
 {
     const int indexRow = index.row();
-    QVector<QVariant> vectorRole = _vectors[role];
-    if (indexRow < 0 || vectorRole.size() <= indexRow) {
+    if (indexRow < 0 || indexRow >= rowCount()) {
+        return {"No valid data"};
+    }
+
+    const int position = slot(_rows[indexRow]);
+    switch (role) {
+    case LogListModel::Category:
+        return _messageCategories[position];
+    case LogListModel::Display:
+        return _messageTexts[position];
+    case LogListModel::Foreground:
+        return QColor(_messageColors[position]);
+    case LogListModel::Time:
+        return _messageTimes[position];
+    default:
         return {"No valid data"};
     }
-    return _vectors[role][indexRow];
 }
 
 void LogListModel::doAppend(const QString& time, const QString& text, const QColor& color, int category)
 {
-    bool visible = category & _categories;
-    const int line = rowCount();
-    beginInsertRows(QModelIndex(), line, line);
-    _vectors[LogListModel::Time].append(time);
-    _vectors[LogListModel::Display].append(text);
-    _vectors[LogListModel::Foreground].append(color);
-    _vectors[LogListModel::Category].append(category);
-    _vectors[LogListModel::Visibility].append(visible);
-    _size++;
-    const auto& indexRow = index(line);
-    endInsertRows();
-    emit dataChanged(indexRow, indexRow, _roles);
-    emit countChanged();
+    // Remove the oldest message when the ring is full
+    if (_numberOfMessages == capacity) {
+        const quint64 oldestMessage = _nextMessage - capacity;
+        if (!_rows.empty() && _rows.front() == oldestMessage) {
+            beginRemoveRows(QModelIndex(), 0, 0);
+            _rows.pop_front();
+            endRemoveRows();
+        }
+        _numberOfMessages--;
+    }
+
+    const int position = slot(_nextMessage);
+    _messageCategories[position] = category;
+    _messageColors[position] = color.rgba();
+    _messageTexts[position] = text;
+    _messageTimes[position] = time;
+    _numberOfMessages++;
+
+    if (category & _categories) {
+        const int line = rowCount();
+        beginInsertRows(QModelIndex(), line, line);
+        _rows.push_back(_nextMessage);
+        endInsertRows();
+        emit countChanged();
+    }
+    _nextMessage++;
 }
 
 Q_INVOKABLE void LogListModel::filter(int categories)
@@ -57,17 +78,16 @@ Q_INVOKABLE void LogListModel::filter(int categories)
         return;
     }
 
+    beginResetModel();
     _categories = categories;
-    int i = 0;
-    for (auto& rowCategory : _vectors[LogListModel::Category]) {
-        bool visibility = rowCategory.toInt() & categories;
-        if (visibility != _vectors[LogListModel::Visibility][i]) {
-            _vectors[LogListModel::Visibility][i] = visibility;
-            auto thisIndex = index(i);
-            emit dataChanged(thisIndex, thisIndex, _roles);
+    _rows.clear();
+    for (quint64 message = _nextMessage - _numberOfMessages; message < _nextMessage; message++) {
+        if (_messageCategories[slot(message)] & categories) {
+            _rows.push_back(message);
         }
-        i++;
     }
+    endResetModel();
+    emit countChanged();
 }
 
 QHash<int, QByteArray> LogListModel::roleNames() const { return _roleNames; }
@@ -1,15 +1,15 @@
 #pragma once
 
-#include <math.h>
+#include <deque>
 
 #include <QAbstractListModel>
 #include <QColor>
-
-#include <QSortFilterProxyModel>
+#include <QVector>
 
 /**
  * @brief Model for qml log interface
- *
+ *  The last messages are kept in a ring with an array per role,
+ *  only the messages of the enabled categories are rows of the model.
  */
 class LogListModel : public QAbstractListModel {
     Q_OBJECT
@@ -30,9 +30,14 @@ public:
         Display,
         Foreground,
         Time,
-        Visibility,
     };
 
+    /**
+     * @brief Maximum number of messages, older ones are removed
+     *
+     */
+    static const int capacity = 10000;
+
     /**
      * @brief Return data
      *
@@ -51,8 +56,9 @@ public:
 
     /**
      * @brief Apply filter in model
+     *  The model is reset once with the rows of the enabled categories
      *
-     * @param categories
+     * @param categories bitmask of the enabled categories
      */
     Q_INVOKABLE void filter(int categories);
 
@@ -65,17 +71,9 @@ public:
     Q_INVOKABLE int rowCount(const QModelIndex& parent = QModelIndex()) const override
     {
         Q_UNUSED(parent);
-        return _size;
+        return static_cast<int>(_rows.size());
     };
 
-    /**
-     * @brief Model of visible items
-     *
-     * @return QSortFilterProxyModel*
-     */
-    QSortFilterProxyModel* filteredModel() { return &_filter; };
-    Q_PROPERTY(QSortFilterProxyModel* filteredModel READ filteredModel CONSTANT)
-
     /**
      * @brief Do the necessary connections of the object
      *
@@ -128,20 +126,33 @@ private:
      */
     void doAppend(const QString& time, const QString& text, const QColor& color, int category);
 
+    /**
+     * @brief Return the ring position of a message
+     *
+     * @param message sequence number of the message
+     * @return int
+     */
+    static int slot(quint64 message) { return static_cast<int>(message % capacity); };
+
     int _categories = 0;
-    QVector<int> _roles;
     QHash<int, QByteArray> _roleNames {
         {{LogListModel::Category}, {"category"}},
         {{LogListModel::Display}, {"display"}},
         {{LogListModel::Foreground}, {"foreground"}},
         {{LogListModel::Time}, {"time"}},
-        {{LogListModel::Visibility}, {"visibity"}},
     };
-    int _size = 0;
-    QHash<int, QVector<QVariant>> _vectors;
 
-    QSortFilterProxyModel _filter;
+    // Ring of messages, an array per role
+    QVector<uint> _messageCategories;
+    QVector<QRgb> _messageColors;
+    QVector<QString> _messageTexts;
+    QVector<QString> _messageTimes;
+    // Sequence number of the next message and number of messages in the ring
+    quint64 _nextMessage = 0;
+    int _numberOfMessages = 0;
+
+    // Sequence numbers of the messages of the enabled categories
+    std::deque<quint64> _rows;
 };
 
 Q_DECLARE_METATYPE(LogListModel*)
-Q_DECLARE_METATYPE(QSortFilterProxyModel*)
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/**
+ * @brief Bounded lock free queue with multiple producers and consumers
+ *  Each slot has a sequence number that tells if it is free for the producer of a position
+ *  or ready for its consumer, so producers only compete on an atomic increment.
+ *  Push fails when the queue is full, nothing is allocated after construction.
+ *
+ * @tparam T
+ */
+template <typename T> class LogQueue {
+public:
+    /**
+     * @brief Construct a new Log Queue object
+     *
+     * @param capacity rounded up to a power of two
+     */
+    explicit LogQueue(std::size_t capacity)
+    {
+        _capacity = 1;
+        while (_capacity < capacity) {
+            _capacity <<= 1;
+        }
+        _slots.reset(new Slot[_capacity]);
+        for (std::size_t i = 0; i < _capacity; i++) {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Add a value, can be called from any thread
+     *
+     * @param value moved to the queue only when it is accepted
+     * @return true
+     * @return false when the queue is full
+     */
+    bool push(T&& value)
+    {
+        std::size_t position = _pushPosition.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = _slots[position & (_capacity - 1)];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence - position);
+            if (difference == 0) {
+                if (_pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.value = std::move(value);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = _pushPosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Remove the oldest value, can be called from any thread
+     *
+     * @param value
+     * @return true
+     * @return false when the queue is empty
+     */
+    bool pop(T& value)
+    {
+        std::size_t position = _popPosition.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = _slots[position & (_capacity - 1)];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+            if (difference == 0) {
+                if (_popPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    value = std::move(slot.value);
+                    // Release what the value holds before the slot is reused
+                    slot.value = T();
+                    slot.sequence.store(position + _capacity, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = _popPosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Check if there is nothing to pop, it can change right after the call
+     *
+     * @return true
+     * @return false
+     */
+    bool isEmpty() const
+    {
+        return _popPosition.load(std::memory_order_acquire) == _pushPosition.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Return the maximum number of values
+     *
+     * @return std::size_t
+     */
+    std::size_t capacity() const { return _capacity; }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    std::size_t _capacity;
+    std::unique_ptr<Slot[]> _slots;
+    // Producers and consumers do not share cache lines
+    alignas(64) std::atomic<std::size_t> _pushPosition {0};
+    alignas(64) std::atomic<std::size_t> _popPosition {0};
+};
@@ -0,0 +1,96 @@
+#include <algorithm>
+
+#include <QtMath>
+
+#include "renderstatistics.h"
+
+RenderStatistics::RenderStatistics(int expectedIntervalMs)
+    : _expectedIntervalNs(qint64(expectedIntervalMs) * 1000000)
+{
+    _clock.start();
+    _window.startNs = _clock.nsecsElapsed();
+}
+
+void RenderStatistics::profileIngested()
+{
+    if (_pendingProfiles == 0) {
+        _firstPendingProfileNs = _clock.nsecsElapsed();
+    }
+    _pendingProfiles++;
+    _window.profiles++;
+}
+
+void RenderStatistics::frameStarted() { _frameStartNs = _clock.nsecsElapsed(); }
+
+void RenderStatistics::frameFinished(qint64 uploadBytes)
+{
+    const qint64 nowNs = _clock.nsecsElapsed();
+    const qint64 paintNs = nowNs - _frameStartNs;
+
+    _window.frames++;
+    _window.paintNs += paintNs;
+    _window.paintMaxNs = std::max(_window.paintMaxNs, paintNs);
+    _window.uploadBytes += uploadBytes;
+
+    // Frames without new profiles are repaints from the scene graph, like resizes
+    if (_pendingProfiles == 0) {
+        return;
+    }
+
+    _window.maxProfilesPerFrame = std::max(_window.maxProfilesPerFrame, _pendingProfiles);
+    _window.mergedProfiles += _pendingProfiles - 1;
+
+    // Pauses of the sensor are not part of the frame pacing
+    const bool continuous = _lastFrameNs >= 0
+        && (!_expectedIntervalNs || _firstPendingProfileNs - _lastFrameNs <= _expectedIntervalNs);
+    if (continuous) {
+        const qint64 intervalNs = _frameStartNs - _lastFrameNs;
+        const double intervalMs = intervalNs / 1e6;
+        _window.intervals++;
+        _window.intervalNs += intervalNs;
+        _window.intervalSquaresMs += intervalMs * intervalMs;
+        _window.intervalMaxNs = std::max(_window.intervalMaxNs, intervalNs);
+    }
+
+    // Time that the oldest profile of the frame waited to be painted
+    const qint64 delayNs = nowNs - _firstPendingProfileNs;
+    _window.delayMaxNs = std::max(_window.delayMaxNs, delayNs);
+    if (_expectedIntervalNs && delayNs > _expectedIntervalNs * 3 / 2) {
+        _window.lateFrames++;
+        _window.skippedFrames += std::max<qint64>(delayNs / _expectedIntervalNs - 1, 1);
+    }
+
+    _lastFrameNs = _frameStartNs;
+    _pendingProfiles = 0;
+}
+
+QVariantMap RenderStatistics::takeSummary()
+{
+    const qint64 nowNs = _clock.nsecsElapsed();
+    const double windowSeconds = std::max<qint64>(nowNs - _window.startNs, 1) / 1e9;
+    const int frames = std::max(_window.frames, 1);
+    const int intervals = std::max(_window.intervals, 1);
+    const double intervalMeanMs = _window.intervalNs / 1e6 / intervals;
+    const double intervalVariance = _window.intervalSquaresMs / intervals - intervalMeanMs * intervalMeanMs;
+
+    const QVariantMap summary {
+        {QStringLiteral("fps"), _window.frames / windowSeconds},
+        {QStringLiteral("paintMeanMs"), _window.paintNs / 1e6 / frames},
+        {QStringLiteral("paintMaxMs"), _window.paintMaxNs / 1e6},
+        {QStringLiteral("intervalMeanMs"), intervalMeanMs},
+        {QStringLiteral("intervalMaxMs"), _window.intervalMaxNs / 1e6},
+        {QStringLiteral("jitterMs"), qSqrt(std::max(intervalVariance, 0.0))},
+        {QStringLiteral("delayMaxMs"), _window.delayMaxNs / 1e6},
+        {QStringLiteral("lateFrames"), _window.lateFrames},
+        {QStringLiteral("skippedFrames"), _window.skippedFrames},
+        {QStringLiteral("profiles"), _window.profiles},
+        {QStringLiteral("profilesPerFrame"), double(_window.profiles) / frames},
+        {QStringLiteral("maxProfilesPerFrame"), _window.maxProfilesPerFrame},
+        {QStringLiteral("mergedProfiles"), _window.mergedProfiles},
+        {QStringLiteral("uploadKiBps"), _window.uploadBytes / 1024.0 / windowSeconds},
+    };
+
+    _window = {};
+    _window.startNs = nowNs;
+    return summary;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QVariant>
+
+/**
+ * @brief Frame counters of a visualizer item
+ *  Counts profiles ingested between frames, paint durations, texture uploads and frame pacing.
+ *  Updates are a few integer operations, so it can stay enabled in the field.
+ *  It is not thread safe, items update it from the GUI thread or while the GUI thread is blocked
+ *  by the scene graph synchronization.
+ */
+class RenderStatistics {
+public:
+    /**
+     * @brief Construct a new Render Statistics object
+     *
+     * @param expectedIntervalMs maximum time that a profile should wait to be painted, 0 to disable the pacing check
+     */
+    explicit RenderStatistics(int expectedIntervalMs = 0);
+
+    /**
+     * @brief Count a profile that will be shown in the next frame
+     *
+     */
+    void profileIngested();
+
+    /**
+     * @brief Start the time measurement of a frame
+     *
+     */
+    void frameStarted();
+
+    /**
+     * @brief Finish the frame started with frameStarted
+     *
+     * @param uploadBytes bytes copied to the graphics memory by the frame
+     */
+    void frameFinished(qint64 uploadBytes);
+
+    /**
+     * @brief Return the statistics since the last call and start a new window
+     *  fps, paintMeanMs, paintMaxMs, intervalMeanMs, intervalMaxMs, jitterMs, delayMaxMs, lateFrames,
+     *  skippedFrames, profiles, profilesPerFrame, maxProfilesPerFrame, mergedProfiles and uploadKiBps.
+     *
+     * @return QVariantMap
+     */
+    QVariantMap takeSummary();
+
+private:
+    struct Window {
+        qint64 startNs = 0;
+        int frames = 0;
+        qint64 paintNs = 0;
+        qint64 paintMaxNs = 0;
+        int intervals = 0;
+        qint64 intervalNs = 0;
+        double intervalSquaresMs = 0;
+        qint64 intervalMaxNs = 0;
+        qint64 delayMaxNs = 0;
+        int lateFrames = 0;
+        int skippedFrames = 0;
+        int profiles = 0;
+        int maxProfilesPerFrame = 0;
+        int mergedProfiles = 0;
+        qint64 uploadBytes = 0;
+    };
+
+    QElapsedTimer _clock;
+    qint64 _expectedIntervalNs;
+    qint64 _firstPendingProfileNs = -1;
+    qint64 _frameStartNs = 0;
+    qint64 _lastFrameNs = -1;
+    int _pendingProfiles = 0;
+    Window _window;
+};
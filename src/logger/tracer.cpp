@@ -0,0 +1,201 @@
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaEnum>
+#include <QQmlEngine>
+#include <QThread>
+
+#include "logger.h"
+#include "tracer.h"
+
+PING_LOGGING_CATEGORY(PING_TRACER, "ping.tracer")
+
+namespace {
+// Common time reference for all threads
+const QElapsedTimer& referenceTimer()
+{
+    static const QElapsedTimer timer = [] {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    return timer;
+}
+
+thread_local Tracer::Context currentContext;
+thread_local int currentThreadId = -1;
+} // namespace
+
+Tracer::Tracer()
+{
+    QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
+    referenceTimer();
+
+    _traceFileName = qEnvironmentVariable("PING_VIEWER_TRACE_FILE");
+    if (!_traceFileName.isEmpty()) {
+        qCInfo(PING_TRACER) << "Trace events will be saved in:" << _traceFileName;
+        _recordEvents = true;
+        _enabled = true;
+    }
+}
+
+qint64 Tracer::timestampNs() { return referenceTimer().nsecsElapsed(); }
+
+void Tracer::setEnabled(bool enabled)
+{
+    qCDebug(PING_TRACER) << "Tracing enabled:" << enabled;
+    _enabled = enabled;
+}
+
+Tracer::Context Tracer::begin(qint64 receivedNs)
+{
+    if (!isEnabled() || !receivedNs) {
+        return {};
+    }
+
+    return {_nextId.fetch_add(1, std::memory_order_relaxed), receivedNs, receivedNs};
+}
+
+void Tracer::mark(Context& context, Stage stage)
+{
+    if (!context.isValid()) {
+        return;
+    }
+
+    const qint64 now = timestampNs();
+    const qint64 durationNs = now - context.lastNs;
+    auto addToHistogram = [this](Stage stage, qint64 durationNs) {
+        Histogram& histogram = _histograms[stage];
+        histogram.count.fetch_add(1, std::memory_order_relaxed);
+        histogram.sumNs.fetch_add(durationNs, std::memory_order_relaxed);
+        qint64 maxNs = histogram.maxNs.load(std::memory_order_relaxed);
+        while (durationNs > maxNs && !histogram.maxNs.compare_exchange_weak(maxNs, durationNs)) { }
+
+        // Bucket n has durations below 2^n microseconds
+        int bucket = 0;
+        for (quint64 durationUs = durationNs / 1000; durationUs && bucket < _numberOfBuckets - 1; durationUs >>= 1) {
+            bucket++;
+        }
+        histogram.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    };
+
+    addToHistogram(stage, durationNs);
+    if (stage == Paint) {
+        addToHistogram(Total, now - context.startNs);
+    }
+
+    if (_recordEvents) {
+        const int thread = threadId();
+        QMutexLocker locker(&_eventsMutex);
+        if (_events.size() < _maxNumberOfEvents) {
+            _events.append({context.id, context.lastNs, durationNs, thread, stage});
+        }
+    }
+
+    context.lastNs = now;
+}
+
+void Tracer::setCurrent(const Context& context) { currentContext = context; }
+
+Tracer::Context Tracer::current() { return currentContext; }
+
+int Tracer::threadId()
+{
+    if (currentThreadId < 0) {
+        QMutexLocker locker(&_eventsMutex);
+        currentThreadId = _threadNames.size();
+        const QString name = QThread::currentThread()->objectName();
+        _threadNames.append(name.isEmpty() ? QStringLiteral("Thread %1").arg(currentThreadId) : name);
+    }
+    return currentThreadId;
+}
+
+QVariantMap Tracer::statistics() const
+{
+    QVariantMap statistics;
+    const QMetaEnum stages = QMetaEnum::fromType<Stage>();
+    for (int stage = 0; stage < NumberOfStages; stage++) {
+        const Histogram& histogram = _histograms[stage];
+        const quint64 count = histogram.count.load(std::memory_order_relaxed);
+
+        QVariantList buckets;
+        quint64 accumulated = 0;
+        int percentile50 = -1;
+        int percentile99 = -1;
+        for (int bucket = 0; bucket < _numberOfBuckets; bucket++) {
+            const quint64 bucketCount = histogram.buckets[bucket].load(std::memory_order_relaxed);
+            buckets.append(bucketCount);
+            accumulated += bucketCount;
+            if (percentile50 < 0 && accumulated * 2 >= count) {
+                percentile50 = bucket;
+            }
+            if (percentile99 < 0 && accumulated * 100 >= count * 99) {
+                percentile99 = bucket;
+            }
+        }
+
+        // Percentiles are the upper limit of their buckets
+        statistics[stages.valueToKey(stage)] = QVariantMap {
+            {"count", count},
+            {"meanUs", count ? histogram.sumNs.load(std::memory_order_relaxed) / count / 1000.0 : 0},
+            {"maxUs", histogram.maxNs.load(std::memory_order_relaxed) / 1000.0},
+            {"p50Us", count ? 1ull << percentile50 : 0},
+            {"p99Us", count ? 1ull << percentile99 : 0},
+            {"buckets", buckets},
+        };
+    }
+    return statistics;
+}
+
+bool Tracer::writeTrace(const QString& fileName) const
+{
+    QJsonArray events;
+    const QMetaEnum stages = QMetaEnum::fromType<Stage>();
+    {
+        QMutexLocker locker(&_eventsMutex);
+        for (int thread = 0; thread < _threadNames.size(); thread++) {
+            events.append(QJsonObject {{"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", thread},
+                {"args", QJsonObject {{"name", _threadNames[thread]}}}});
+        }
+
+        for (const auto& event : _events) {
+            events.append(QJsonObject {{"name", stages.valueToKey(event.stage)}, {"cat", "sensor"}, {"ph", "X"},
+                {"pid", 1}, {"tid", event.threadId}, {"ts", event.startNs / 1000.0},
+                {"dur", event.durationNs / 1000.0}, {"args", QJsonObject {{"id", QString::number(event.id)}}}});
+        }
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(PING_TRACER) << "Failed to write trace:" << file.errorString();
+        return false;
+    }
+
+    file.write(QJsonDocument(QJsonObject {{"traceEvents", events}, {"displayTimeUnit", "ms"}}).toJson(
+        QJsonDocument::Compact));
+    qCDebug(PING_TRACER) << "Trace saved with" << events.size() << "events:" << fileName;
+    return true;
+}
+
+QObject* Tracer::qmlSingletonRegister(QQmlEngine* engine, QJSEngine* scriptEngine)
+{
+    Q_UNUSED(engine)
+    Q_UNUSED(scriptEngine)
+
+    return self();
+}
+
+Tracer* Tracer::self()
+{
+    static Tracer self;
+    return &self;
+}
+
+Tracer::~Tracer()
+{
+    if (!_traceFileName.isEmpty()) {
+        writeTrace(_traceFileName);
+    }
+}
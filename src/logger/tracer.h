@@ -0,0 +1,198 @@
+#pragma once
+
+#include <QLoggingCategory>
+#include <QMutex>
+#include <QObject>
+#include <QVariant>
+#include <QVector>
+
+#include <array>
+#include <atomic>
+
+class QJSEngine;
+class QQmlEngine;
+
+Q_DECLARE_LOGGING_CATEGORY(PING_TRACER)
+
+/**
+ * @brief Latency tracing of sensor data from the link to the screen
+ *  Each parsed message gets a context with the time that its last bytes arrived.
+ *  The context follows the message through the pipeline and each stage records the time since the
+ *  previous one in a histogram. With PING_VIEWER_TRACE_FILE set, every stage is also saved as an
+ *  event and written in the Chrome trace event format when the application closes.
+ */
+class Tracer : public QObject {
+    Q_OBJECT
+public:
+    /**
+     * @brief Pipeline stages, each one ends when it is marked
+     *
+     */
+    enum Stage {
+        // From link data to parsed message, including the queue to the parser thread
+        Parse,
+        // Queue from the parser thread to the sensor
+        Dispatch,
+        // Processing of common messages in PingSensor::handleMessagePrivate
+        HandleMessagePrivate,
+        // Sensor specific processing until the visualizer draws it
+        HandleMessage,
+        // Visualizer draw
+        Draw,
+        // Until the visualizer is painted
+        Paint,
+        // From link data to painted pixels
+        Total,
+        NumberOfStages,
+    };
+    Q_ENUM(Stage)
+
+    /**
+     * @brief State of a traced message, copied by the stages
+     *
+     */
+    struct Context {
+        quint64 id = 0;
+        qint64 startNs = 0;
+        qint64 lastNs = 0;
+
+        bool isValid() const { return id; };
+    };
+
+    /**
+     * @brief Return the monotonic time used by the tracer
+     *
+     * @return qint64 timestamp in nanoseconds
+     */
+    static qint64 timestampNs();
+
+    /**
+     * @brief Check if tracing is enabled
+     *
+     * @return true
+     * @return false
+     */
+    bool isEnabled() const { return _enabled.load(std::memory_order_relaxed); };
+
+    /**
+     * @brief Enable or disable tracing
+     *
+     * @param enabled
+     */
+    Q_INVOKABLE void setEnabled(bool enabled);
+
+    /**
+     * @brief Create a context for a message, can be called from any thread
+     *
+     * @param receivedNs when the message data was received by the link
+     * @return Context invalid when tracing is disabled
+     */
+    Context begin(qint64 receivedNs);
+
+    /**
+     * @brief Finish a stage of a context, can be called from any thread
+     *
+     * @param context
+     * @param stage
+     */
+    void mark(Context& context, Stage stage);
+
+    /**
+     * @brief Set the context of the message handled by this thread
+     *  Visualizers draw in the same call stack that handles the message
+     *
+     * @param context
+     */
+    static void setCurrent(const Context& context);
+
+    /**
+     * @brief Return the context of the message handled by this thread
+     *
+     * @return Context
+     */
+    static Context current();
+
+    /**
+     * @brief Return the latency statistics of each stage
+     *  Each stage has the count, mean, max, 50 and 99 percentiles in microseconds
+     *  and the histogram with power of two microsecond buckets.
+     *
+     * @return QVariantMap
+     */
+    Q_INVOKABLE QVariantMap statistics() const;
+
+    /**
+     * @brief Write the recorded events in the Chrome trace event format
+     *
+     * @param fileName
+     * @return true
+     * @return false
+     */
+    Q_INVOKABLE bool writeTrace(const QString& fileName) const;
+
+    /**
+     * @brief Return Tracer pointer
+     *
+     * @return Tracer*
+     */
+    static Tracer* self();
+
+    /**
+     * @brief Return a pointer of this singleton to the qml register function
+     *
+     * @param engine
+     * @param scriptEngine
+     * @return QObject*
+     */
+    static QObject* qmlSingletonRegister(QQmlEngine* engine, QJSEngine* scriptEngine);
+
+private:
+    Q_DISABLE_COPY(Tracer)
+    /**
+     * @brief Construct a new Tracer object
+     *
+     */
+    Tracer();
+
+    /**
+     * @brief Destroy the Tracer object, writing the trace file when requested
+     *
+     */
+    ~Tracer();
+
+    /**
+     * @brief Return the small identifier of the calling thread used in trace events
+     *
+     * @return int
+     */
+    int threadId();
+
+    static constexpr int _numberOfBuckets = 32;
+    struct Histogram {
+        std::atomic<quint64> count {0};
+        std::atomic<quint64> sumNs {0};
+        std::atomic<qint64> maxNs {0};
+        std::array<std::atomic<quint64>, _numberOfBuckets> buckets {};
+    };
+    std::array<Histogram, NumberOfStages> _histograms;
+
+    struct Event {
+        quint64 id;
+        qint64 startNs;
+        qint64 durationNs;
+        int threadId;
+        Stage stage;
+    };
+    // Limit the memory used by long sessions, around 40 MB
+    static constexpr int _maxNumberOfEvents = 1000000;
+    mutable QMutex _eventsMutex;
+    QVector<Event> _events;
+    QVector<QString> _threadNames;
+    bool _recordEvents = false;
+    QString _traceFileName;
+
+    std::atomic<bool> _enabled {false};
+    std::atomic<quint64> _nextId {1};
+};
+
+Q_DECLARE_METATYPE(Tracer::Context)
@@ -0,0 +1,301 @@
+#include <QDataStream>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QtEndian>
+
+#include <array>
+#include <limits>
+
+#include "logexporter.h"
+#include "logfilereader.h"
+#include "logger.h"
+#include "logsensorstruct.h"
+
+#include "ping-message-common.h"
+#include "ping-message-ping1d.h"
+#include "ping-message-ping360.h"
+#include "ping-parser.h"
+
+PING_LOGGING_CATEGORY(PING_LOGEXPORTER, "ping.logexporter")
+
+namespace {
+// Output is accumulated to be written in large blocks
+const int outputBufferSize = 1024 * 1024;
+
+const std::array<const char*, 14> columns {"timestamp_ns", "message_id", "device_id", "sample_offset",
+    "number_of_samples", "angle", "gain_setting", "transmit_duration", "sample_period", "transmit_frequency",
+    "distance", "confidence", "scan_start", "scan_length"};
+using Row = std::array<qint64, columns.size()>;
+
+/**
+ * @brief Buffered output file
+ *
+ */
+class OutputFile {
+public:
+    bool open(const QString& fileName)
+    {
+        _file.setFileName(fileName);
+        if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qCWarning(PING_LOGEXPORTER) << "Failed to create" << fileName << ":" << _file.errorString();
+            return false;
+        }
+        _buffer.reserve(outputBufferSize + 64 * 1024);
+        return true;
+    }
+
+    void append(const char* data, int size)
+    {
+        _buffer.append(data, size);
+        if (_buffer.size() >= outputBufferSize) {
+            flush();
+        }
+    }
+
+    void appendNumber(qint64 value)
+    {
+        char text[24];
+        char* end = text + sizeof(text);
+        char* begin = end;
+        const bool negative = value < 0;
+        quint64 absolute = negative ? -static_cast<quint64>(value) : value;
+        do {
+            *--begin = '0' + absolute % 10;
+            absolute /= 10;
+        } while (absolute);
+        if (negative) {
+            *--begin = '-';
+        }
+        append(begin, end - begin);
+    }
+
+    bool flush()
+    {
+        const bool ok = _file.write(_buffer) == _buffer.size();
+        _buffer.resize(0);
+        return ok;
+    }
+
+    QFile& file() { return _file; }
+
+private:
+    QFile _file;
+    QByteArray _buffer;
+};
+
+/**
+ * @brief NPY (version 1.0) file with a single dimension of unknown size
+ *  The header has a fixed size and is rewritten with the final shape when the file is closed
+ *
+ */
+class NpyFile : public OutputFile {
+public:
+    bool open(const QString& fileName, const QByteArray& descr)
+    {
+        _descr = descr;
+        if (!OutputFile::open(fileName)) {
+            return false;
+        }
+        // Maximum shape to reserve the header size
+        const QByteArray header = npyHeader(std::numeric_limits<qint64>::max(), 0);
+        _headerSize = header.size();
+        append(header.constData(), header.size());
+        return true;
+    }
+
+    bool close(qint64 numberOfElements)
+    {
+        bool ok = flush();
+        const QByteArray header = npyHeader(numberOfElements, _headerSize);
+        ok &= file().seek(0) && file().write(header) == header.size();
+        file().close();
+        return ok;
+    }
+
+private:
+    QByteArray npyHeader(qint64 numberOfElements, int headerSize) const
+    {
+        QByteArray dictionary = QByteArrayLiteral("{'descr': ") + _descr
+            + QByteArrayLiteral(", 'fortran_order': False, 'shape': (") + QByteArray::number(numberOfElements)
+            + QByteArrayLiteral(",), }");
+        // Magic, version and length take 10 bytes, total header is aligned to 64 and ends with a new line
+        const int size = headerSize ? headerSize : (10 + dictionary.size() + 1 + 63) / 64 * 64;
+        dictionary = dictionary.leftJustified(size - 10 - 1, ' ') + '\n';
+
+        QByteArray header = QByteArrayLiteral("\x93NUMPY\x01\x00");
+        uchar length[2];
+        qToLittleEndian<quint16>(dictionary.size(), length);
+        header.append(reinterpret_cast<const char*>(length), sizeof(length));
+        return header + dictionary;
+    }
+
+    QByteArray _descr;
+    int _headerSize = 0;
+};
+
+/**
+ * @brief Fill metadata row and samples from a profile message
+ *
+ * @return true if message is a profile
+ */
+bool decodeProfile(ping_message& message, Row& row, const uint8_t*& samples, int& numberOfSamples)
+{
+    row.fill(-1);
+    row[1] = message.message_id();
+    row[2] = message.source_device_id();
+
+    switch (message.message_id()) {
+    case Ping1dId::PROFILE: {
+        auto profile = static_cast<ping1d_profile*>(&message);
+        samples = profile->profile_data();
+        numberOfSamples = profile->profile_data_length();
+        row[6] = profile->gain_setting();
+        row[7] = profile->transmit_duration();
+        row[10] = profile->distance();
+        row[11] = profile->confidence();
+        row[12] = profile->scan_start();
+        row[13] = profile->scan_length();
+        return true;
+    }
+    case Ping360Id::DEVICE_DATA: {
+        auto deviceData = static_cast<ping360_device_data*>(&message);
+        samples = deviceData->data();
+        numberOfSamples = deviceData->data_length();
+        row[5] = deviceData->angle();
+        row[6] = deviceData->gain_setting();
+        row[7] = deviceData->transmit_duration();
+        row[8] = deviceData->sample_period();
+        row[9] = deviceData->transmit_frequency();
+        return true;
+    }
+    case Ping360Id::AUTO_DEVICE_DATA: {
+        auto autoDeviceData = static_cast<ping360_auto_device_data*>(&message);
+        samples = autoDeviceData->data();
+        numberOfSamples = autoDeviceData->data_length();
+        row[5] = autoDeviceData->angle();
+        row[6] = autoDeviceData->gain_setting();
+        row[7] = autoDeviceData->transmit_duration();
+        row[8] = autoDeviceData->sample_period();
+        row[9] = autoDeviceData->transmit_frequency();
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+} // namespace
+
+LogExporter::Result LogExporter::exportLog(const QString& fileName, const QString& outputDirectory, Format format)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    Result result;
+    result.fileName = fileName;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(PING_LOGEXPORTER) << "Failed to open" << fileName << ":" << file.errorString();
+        return result;
+    }
+    result.bytes = file.size();
+
+    QDataStream stream(&file);
+    LogSensorStruct logSensorStruct;
+    stream >> logSensorStruct;
+    if (!logSensorStruct.isValid()) {
+        qCWarning(PING_LOGEXPORTER) << "Invalid log header:" << fileName;
+        return result;
+    }
+
+    // Input directories are not ours, the index is only kept in memory
+    LogFileReader reader;
+    reader.setReadOnly(true);
+    if (!reader.open(fileName, file.pos(), logSensorStruct.version)) {
+        qCWarning(PING_LOGEXPORTER) << "Failed to read" << fileName;
+        return result;
+    }
+
+    const QString baseName = QDir(outputDirectory).filePath(QFileInfo(fileName).completeBaseName());
+    OutputFile metadataCsv;
+    OutputFile samplesCsv;
+    NpyFile metadataNpy;
+    NpyFile samplesNpy;
+    if (format == Format::Csv) {
+        if (!metadataCsv.open(baseName + QStringLiteral("_metadata.csv"))
+            || !samplesCsv.open(baseName + QStringLiteral("_samples.csv"))) {
+            return result;
+        }
+        for (size_t i = 0; i < columns.size(); i++) {
+            metadataCsv.append(",", i ? 1 : 0);
+            metadataCsv.append(columns[i], qstrlen(columns[i]));
+        }
+        metadataCsv.append("\n", 1);
+    } else {
+        QByteArray descr("[");
+        for (const char* column : columns) {
+            descr += QByteArrayLiteral("('") + column + QByteArrayLiteral("', '<i8'), ");
+        }
+        descr += ']';
+        if (!metadataNpy.open(baseName + QStringLiteral("_metadata.npy"), descr)
+            || !samplesNpy.open(baseName + QStringLiteral("_samples.npy"), QByteArrayLiteral("'|u1'"))) {
+            return result;
+        }
+    }
+
+    PingParser parser(10240);
+    Row row;
+    qint64 sampleOffset = 0;
+    result.records = reader.size();
+    for (int index = 0; index < reader.size(); index++) {
+        const qint64 timestampNs = reader.timestampNs(index);
+        const QByteArray data = reader.data(index);
+        for (const char byte : data) {
+            if (parser.parseByte(byte) != PingParser::ParseState::NEW_MESSAGE) {
+                continue;
+            }
+            result.messages++;
+
+            const uint8_t* samples = nullptr;
+            int numberOfSamples = 0;
+            if (!decodeProfile(parser.rxMessage, row, samples, numberOfSamples)) {
+                continue;
+            }
+            result.profiles++;
+            row[0] = timestampNs;
+            row[3] = sampleOffset;
+            row[4] = numberOfSamples;
+            sampleOffset += numberOfSamples;
+
+            if (format == Format::Csv) {
+                for (size_t i = 0; i < row.size(); i++) {
+                    metadataCsv.append(",", i ? 1 : 0);
+                    metadataCsv.appendNumber(row[i]);
+                }
+                metadataCsv.append("\n", 1);
+                for (int i = 0; i < numberOfSamples; i++) {
+                    samplesCsv.append(",", i ? 1 : 0);
+                    samplesCsv.appendNumber(samples[i]);
+                }
+                samplesCsv.append("\n", 1);
+            } else {
+                uchar littleEndianRow[sizeof(Row)];
+                for (size_t i = 0; i < row.size(); i++) {
+                    qToLittleEndian<qint64>(row[i], littleEndianRow + i * sizeof(qint64));
+                }
+                metadataNpy.append(reinterpret_cast<const char*>(littleEndianRow), sizeof(littleEndianRow));
+                samplesNpy.append(reinterpret_cast<const char*>(samples), numberOfSamples);
+            }
+        }
+    }
+
+    if (format == Format::Csv) {
+        result.ok = metadataCsv.flush() && samplesCsv.flush();
+    } else {
+        result.ok = metadataNpy.close(result.profiles) && samplesNpy.close(sampleOffset);
+    }
+    result.elapsedNs = timer.nsecsElapsed();
+    return result;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QLoggingCategory>
+#include <QString>
+
+Q_DECLARE_LOGGING_CATEGORY(PING_LOGEXPORTER)
+
+/**
+ * @brief Decode sensor logs and export their profiles
+ *  Each log generates a metadata table, with a row per profile message, and the samples of all profiles.
+ *
+ *  NPY: <log>_metadata.npy, structured array with a int64 field per column,
+ *       <log>_samples.npy, flat uint8 array with the samples of all profiles,
+ *       a profile is in [sample_offset, sample_offset + number_of_samples).
+ *  CSV: <log>_metadata.csv with a header line, <log>_samples.csv with the samples of a profile per line.
+ *
+ *  Fields that do not exist in a message are exported as -1.
+ */
+class LogExporter {
+public:
+    /**
+     * @brief Output formats
+     *
+     */
+    enum class Format {
+        Csv,
+        Npy,
+    };
+
+    /**
+     * @brief Summary of an exported log
+     *
+     */
+    struct Result {
+        QString fileName;
+        bool ok = false;
+        qint64 bytes = 0;
+        int records = 0;
+        int messages = 0;
+        int profiles = 0;
+        qint64 elapsedNs = 0;
+    };
+
+    /**
+     * @brief Decode a log and export its profiles, can run in parallel for different logs
+     *
+     * @param fileName sensor log
+     * @param outputDirectory where the exported files are created
+     * @param format
+     * @return Result
+     */
+    static Result exportLog(const QString& fileName, const QString& outputDirectory, Format format);
+};
@@ -0,0 +1,147 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QFuture>
+#include <QThreadPool>
+#include <QVector>
+#include <QtConcurrent>
+
+#include <fmt/core.h>
+
+#include "logeditor.h"
+#include "logexporter.h"
+
+namespace {
+/**
+ * @brief Cut, split or concatenate logs, records are copied without decoding
+ *
+ * @return int process exit code
+ */
+int editLogs(const QStringList& fileNames, const QString& extract, double splitSizeMB, double splitSeconds,
+    const QString& concatenate)
+{
+    if (!concatenate.isEmpty()) {
+        return LogEditor::concatenate(fileNames, concatenate) ? 0 : 1;
+    }
+
+    const QString fileName = fileNames.first();
+    const QFileInfo fileInfo(fileName);
+    if (!extract.isEmpty()) {
+        const QStringList range = extract.split(QLatin1Char(','));
+        if (range.size() != 2) {
+            fmt::print(stderr, "Invalid range: {}\n", extract.toStdString());
+            return 1;
+        }
+        const QString output = fileInfo.dir().filePath(fileInfo.completeBaseName() + QStringLiteral("_extract.")
+            + fileInfo.suffix());
+        return LogEditor::extract(fileName, output, range[0].toDouble() * 1e9, range[1].toDouble() * 1e9) ? 0 : 1;
+    }
+
+    const QStringList parts = LogEditor::split(fileName,
+        fileInfo.dir().filePath(fileInfo.completeBaseName() + QStringLiteral("_part.") + fileInfo.suffix()),
+        splitSizeMB * 1024 * 1024, splitSeconds * 1e9);
+    for (const auto& part : parts) {
+        fmt::print("{}\n", part.toStdString());
+    }
+    return parts.isEmpty() ? 1 : 0;
+}
+} // namespace
+
+/**
+ * @brief Export sensor logs without the interface
+ *  Logs are processed in parallel, one per thread, and the throughput of each log is printed.
+ *
+ *  pingviewer-logtool [--format npy|csv] [--output directory] [--jobs N] logs...
+ *  Logs can also be edited without decoding their records:
+ *  pingviewer-logtool --extract start,end log
+ *  pingviewer-logtool [--split-size MB] [--split-duration seconds] log
+ *  pingviewer-logtool --concatenate output logs...
+ */
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setOrganizationName("Blue Robotics Inc.");
+    QCoreApplication::setOrganizationDomain("bluerobotics.com");
+    QCoreApplication::setApplicationName("pingviewer-logtool");
+    QCoreApplication::setApplicationVersion(GIT_TAG "-" GIT_VERSION "-" GIT_VERSION_DATE);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Decode Ping Viewer sensor logs and export profiles and metadata.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    const QCommandLineOption formatOption({"f", "format"}, "Output format: npy or csv.", "format", "npy");
+    const QCommandLineOption outputOption({"o", "output"}, "Output directory.", "directory", QDir::currentPath());
+    const QCommandLineOption jobsOption({"j", "jobs"}, "Number of logs processed in parallel.", "jobs",
+        QString::number(QThread::idealThreadCount()));
+    const QCommandLineOption extractOption(
+        "extract", "Save the records between start and end seconds in <log>_extract.", "start,end");
+    const QCommandLineOption splitSizeOption("split-size", "Split the log in parts of at most size MB.", "size");
+    const QCommandLineOption splitDurationOption(
+        "split-duration", "Split the log in parts of at most duration seconds.", "duration");
+    const QCommandLineOption concatenateOption("concatenate", "Concatenate the logs in a new log.", "output");
+    parser.addOptions({formatOption, outputOption, jobsOption, extractOption, splitSizeOption, splitDurationOption,
+        concatenateOption});
+    parser.addPositionalArgument("logs", "Sensor log files.", "logs...");
+    parser.process(app);
+
+    const QStringList fileNames = parser.positionalArguments();
+    if (fileNames.isEmpty()) {
+        parser.showHelp(1);
+    }
+
+    if (parser.isSet(extractOption) || parser.isSet(splitSizeOption) || parser.isSet(splitDurationOption)
+        || parser.isSet(concatenateOption)) {
+        return editLogs(fileNames, parser.value(extractOption), parser.value(splitSizeOption).toDouble(),
+            parser.value(splitDurationOption).toDouble(), parser.value(concatenateOption));
+    }
+
+    const QString formatName = parser.value(formatOption).toLower();
+    if (formatName != QLatin1String("npy") && formatName != QLatin1String("csv")) {
+        fmt::print(stderr, "Unknown format: {}\n", formatName.toStdString());
+        return 1;
+    }
+    const auto format = formatName == QLatin1String("csv") ? LogExporter::Format::Csv : LogExporter::Format::Npy;
+
+    const QString outputDirectory = parser.value(outputOption);
+    if (!QDir().mkpath(outputDirectory)) {
+        fmt::print(stderr, "Failed to create output directory: {}\n", outputDirectory.toStdString());
+        return 1;
+    }
+
+    QThreadPool::globalInstance()->setMaxThreadCount(qMax(1, parser.value(jobsOption).toInt()));
+
+    QElapsedTimer timer;
+    timer.start();
+    QVector<QFuture<LogExporter::Result>> futures;
+    for (const auto& fileName : fileNames) {
+        futures.append(QtConcurrent::run(LogExporter::exportLog, fileName, outputDirectory, format));
+    }
+
+    int failures = 0;
+    qint64 totalBytes = 0;
+    int totalProfiles = 0;
+    for (auto& future : futures) {
+        const LogExporter::Result result = future.result();
+        if (!result.ok) {
+            fmt::print(stderr, "{}: failed\n", result.fileName.toStdString());
+            failures++;
+            continue;
+        }
+
+        totalBytes += result.bytes;
+        totalProfiles += result.profiles;
+        const double seconds = result.elapsedNs * 1e-9;
+        fmt::print("{}: {} records, {} messages, {} profiles in {:.2f} s ({:.1f} MB/s)\n",
+            result.fileName.toStdString(), result.records, result.messages, result.profiles, seconds,
+            result.bytes / (1024.0 * 1024.0) / qMax(seconds, 1e-9));
+    }
+
+    const double seconds = timer.nsecsElapsed() * 1e-9;
+    fmt::print("Total: {} logs, {} profiles, {:.1f} MB in {:.2f} s ({:.1f} MB/s) with {} jobs\n",
+        futures.size() - failures, totalProfiles, totalBytes / (1024.0 * 1024.0), seconds,
+        totalBytes / (1024.0 * 1024.0) / qMax(seconds, 1e-9), QThreadPool::globalInstance()->maxThreadCount());
+
+    return failures ? 1 : 0;
+}
@@ -1,15 +1,23 @@
 #include <QApplication>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
 #include <QQmlEngine>
 #include <QQuickStyle>
 #include <QRegularExpression>
+#include <QTimer>
+
+#include <csignal>
 
 #if defined(QT_DEBUG) && defined(Q_OS_WIN)
 #include <KCrash>
 #endif
 
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
 #include "abstractlink.h"
 #include "commandlineparser.h"
 #include "devicemanager.h"
@@ -23,8 +31,10 @@
 #include "ping360.h"
 #include "ping360helperservice.h"
 #include "polarplot.h"
+#include "profilechart.h"
 #include "settingsmanager.h"
 #include "stylemanager.h"
+#include "tracer.h"
 #include "util.h"
 #include "waterfallplot.h"
 
@@ -32,23 +42,136 @@ Q_DECLARE_LOGGING_CATEGORY(mainCategory)
 
 PING_LOGGING_CATEGORY(mainCategory, "ping.main")
 
+namespace {
+// Set by the signal handler and checked by the event loop
+volatile std::sig_atomic_t quitRequested = 0;
+
+/**
+ * @brief Describe the CPU and memory used by the process
+ *
+ * @param cpuSeconds CPU time used until the start of the period, updated to the current one
+ * @param elapsedMs duration of the period
+ * @return QString
+ */
+QString footprint(double& cpuSeconds, qint64 elapsedMs)
+{
+#ifdef Q_OS_UNIX
+    rusage usage {};
+    if (getrusage(RUSAGE_SELF, &usage)) {
+        return QStringLiteral("Not possible to get the process footprint.");
+    }
+
+    const double currentCpuSeconds = usage.ru_utime.tv_sec + usage.ru_stime.tv_sec
+        + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    const double cpuPercentage = elapsedMs ? 100 * (currentCpuSeconds - cpuSeconds) / (elapsedMs / 1e3) : 0;
+    cpuSeconds = currentCpuSeconds;
+#ifdef Q_OS_OSX
+    // Bytes in macOS and kilobytes in Linux
+    const double peakMemoryMiB = usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+    const double peakMemoryMiB = usage.ru_maxrss / 1024.0;
+#endif
+
+    return QStringLiteral("CPU: %1% of a core, peak memory: %2 MiB")
+        .arg(cpuPercentage, 0, 'f', 1)
+        .arg(peakMemoryMiB, 0, 'f', 1);
+#else
+    Q_UNUSED(cpuSeconds)
+    Q_UNUSED(elapsedMs)
+    return QStringLiteral("Process footprint is not available in this platform.");
+#endif
+}
+
+/**
+ * @brief Acquire and log sensor data without interface until the process is interrupted
+ *  The sensor given by --connect is used, otherwise the first one found by the detectors.
+ *  Logs are created and sensors are configured in the same way as with the interface.
+ *
+ * @param app
+ * @return int process exit code
+ */
+int runHeadless(QCoreApplication& app)
+{
+    // Lost sensors are searched again, including the one given by --connect
+    auto deviceManager = DeviceManager::self();
+    deviceManager->setAutoConnect(true);
+    if (deviceManager->sensors().isEmpty()) {
+        qCInfo(mainCategory) << "Searching for sensors.";
+        deviceManager->startDetecting();
+    }
+
+    // Logs are closed when the sensors are destroyed, interruptions finish the event loop first
+    std::signal(SIGINT, [](int) { quitRequested = 1; });
+    std::signal(SIGTERM, [](int) { quitRequested = 1; });
+    QTimer quitTimer;
+    QObject::connect(&quitTimer, &QTimer::timeout, &app, [&app] {
+        if (quitRequested) {
+            app.quit();
+        }
+    });
+    quitTimer.start(250);
+
+    // Reports cover the CPU time since the last one
+    double cpuSeconds = 0;
+    footprint(cpuSeconds, 0);
+    QElapsedTimer statusElapsed;
+    statusElapsed.start();
+    QTimer statusTimer;
+    QObject::connect(&statusTimer, &QTimer::timeout, &app, [deviceManager, &cpuSeconds, &statusElapsed] {
+        for (const auto& sensorVariant : deviceManager->sensors()) {
+            const auto sensor = sensorVariant.value<Sensor*>();
+            const QString logFile = sensor->linkLog() ? sensor->linkLog()->configuration()->argsAsConst().value(0)
+                                                      : QStringLiteral("none");
+            qCInfo(mainCategory).noquote() << QStringLiteral("%1 %2, log: %3")
+                                                  .arg(sensor->name(),
+                                                      sensor->connected() ? QStringLiteral("connected")
+                                                                          : QStringLiteral("disconnected"),
+                                                      logFile);
+        }
+        qCInfo(mainCategory).noquote() << footprint(cpuSeconds, statusElapsed.restart());
+    });
+    statusTimer.start(10000);
+
+    const int result = app.exec();
+
+    deviceManager->stopDetecting();
+    while (!deviceManager->sensors().isEmpty()) {
+        deviceManager->disconnectSensor(0);
+    }
+    qCInfo(mainCategory) << "Finished.";
+    return result;
+}
+} // namespace
+
 int main(int argc, char* argv[])
 {
     // Start logger ASAP
     Logger::installHandler();
 
+    QElapsedTimer uptime;
+    uptime.start();
+
     QCoreApplication::setOrganizationName("Blue Robotics Inc.");
     QCoreApplication::setOrganizationDomain("bluerobotics.com");
     QCoreApplication::setApplicationName("Ping Viewer");
     QCoreApplication::setApplicationVersion(GIT_TAG "-" GIT_VERSION "-" GIT_VERSION_DATE);
 
-    QQuickStyle::setStyle("Material");
-
-    // Singleton register
     qRegisterMetaType<AbstractLinkNamespace::LinkType>();
     qRegisterMetaType<PingEnumNamespace::PingDeviceType>();
     qRegisterMetaType<PingEnumNamespace::PingMessageId>();
 
+    // No QML engine, visualizers or styles are created without interface
+    if (CommandLineParser::isHeadless(argc, argv)) {
+        QCoreApplication app(argc, argv);
+        CommandLineParser parser(app);
+        qCInfo(mainCategory) << "Running without interface, git version:" << GIT_VERSION;
+        return runHeadless(app);
+    }
+
+    QQuickStyle::setStyle("Material");
+
+    // Singleton register
+
     qmlRegisterSingletonType<DeviceManager>(
         "DeviceManager", 1, 0, "DeviceManager", DeviceManager::qmlSingletonRegister);
     qmlRegisterSingletonType<FileManager>("FileManager", 1, 0, "FileManager", FileManager::qmlSingletonRegister);
@@ -60,6 +183,7 @@ int main(int argc, char* argv[])
     qmlRegisterSingletonType<SettingsManager>(
         "SettingsManager", 1, 0, "SettingsManager", SettingsManager::qmlSingletonRegister);
     qmlRegisterSingletonType<StyleManager>("StyleManager", 1, 0, "StyleManager", StyleManager::qmlSingletonRegister);
+    qmlRegisterSingletonType<Tracer>("Tracer", 1, 0, "Tracer", Tracer::qmlSingletonRegister);
     qmlRegisterSingletonType<Util>("Util", 1, 0, "Util", Util::qmlSingletonRegister);
 
     // Normal register
@@ -71,6 +195,7 @@ int main(int argc, char* argv[])
     qmlRegisterType<Ping>("Ping", 1, 0, "Ping");
     qmlRegisterType<Ping360>("Ping360", 1, 0, "Ping360");
     qmlRegisterType<PolarPlot>("PolarPlot", 1, 0, "PolarPlot");
+    qmlRegisterType<ProfileChart>("ProfileChart", 1, 0, "ProfileChart");
     qmlRegisterType<WaterfallPlot>("WaterfallPlot", 1, 0, "WaterfallPlot");
 
     qmlRegisterUncreatableMetaObject(AbstractLinkNamespace::staticMetaObject, "AbstractLinkNamespace", 1, 0,
@@ -132,5 +257,9 @@ int main(int argc, char* argv[])
     KCrash::initialize();
 #endif
 
-    return app.exec();
+    const int result = app.exec();
+
+    double cpuSeconds = 0;
+    qCInfo(mainCategory).noquote() << "Process footprint, average" << footprint(cpuSeconds, uptime.elapsed());
+    return result;
 }
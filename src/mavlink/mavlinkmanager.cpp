@@ -4,6 +4,8 @@
 
 #include <mavlink_msg_attitude.h>
 
+#include <algorithm>
+
 #include <QDebug>
 #include <QQmlEngine>
 
@@ -19,6 +21,10 @@ MavlinkManager::MavlinkManager()
 
     QObject::connect(&_heartbeatTimer, &QTimer::timeout, this, &MavlinkManager::sendHeartbeatMessage);
     _heartbeatTimer.start(4000);
+
+    QObject::connect(&_messageRatesTimer, &QTimer::timeout, this, &MavlinkManager::updateMessageRates);
+    _messageRatesElapsed.start();
+    _messageRatesTimer.start(1000);
 }
 
 void MavlinkManager::connect(const LinkConfiguration& conf)
@@ -46,15 +52,85 @@ void MavlinkManager::connect(const LinkConfiguration& conf)
 
 void MavlinkManager::parseData(const QByteArray data)
 {
-    static mavlink_message_t message;
     mavlink_status_t status;
     for (const auto& byte : data) {
-        if (mavlink_parse_char(0, byte, &message, &status)) {
-            emit mavlinkMessage(message);
+        // Framing also reports messages without CRC information, they are only counted
+        const uint8_t framing = mavlink_frame_char(0, byte, &_message, &status);
+        if (framing == MAVLINK_FRAMING_INCOMPLETE) {
+            continue;
+        }
+
+        _messageCounters[_message.msgid]++;
+        if (framing != MAVLINK_FRAMING_OK) {
+            continue;
+        }
+
+        // Vehicles stream dozens of messages, most of them without any use here
+        const auto subscribers = _subscribers.constFind(_message.msgid);
+        if (subscribers == _subscribers.constEnd()) {
+            continue;
+        }
+
+        // Handlers can change the subscriptions
+        const QVector<Subscriber> handlers = subscribers.value();
+        bool destroyedContext = false;
+        for (const auto& subscriber : handlers) {
+            if (subscriber.context) {
+                subscriber.handler(_message);
+            } else {
+                destroyedContext = true;
+            }
+        }
+
+        if (destroyedContext) {
+            unsubscribe(_message.msgid, nullptr);
         }
     }
 }
 
+void MavlinkManager::subscribe(uint32_t messageId, QObject* context, MessageHandler handler)
+{
+    qCDebug(MAVLINKMANAGER) << "New subscription for message ID:" << messageId;
+    unsubscribe(messageId, context);
+    _subscribers[messageId].append({context, std::move(handler)});
+}
+
+void MavlinkManager::unsubscribe(uint32_t messageId, QObject* context)
+{
+    auto subscribers = _subscribers.find(messageId);
+    if (subscribers == _subscribers.end()) {
+        return;
+    }
+
+    // Subscriptions of destroyed contexts are removed together
+    auto& handlers = subscribers.value();
+    handlers.erase(std::remove_if(handlers.begin(), handlers.end(),
+                       [context](const Subscriber& subscriber) {
+                           return !subscriber.context || subscriber.context == context;
+                       }),
+        handlers.end());
+
+    if (handlers.isEmpty()) {
+        qCDebug(MAVLINKMANAGER) << "No subscribers left for message ID:" << messageId;
+        _subscribers.erase(subscribers);
+    }
+}
+
+void MavlinkManager::updateMessageRates()
+{
+    const float elapsedSeconds = _messageRatesElapsed.restart() / 1000.0f;
+    if (_messageCounters.isEmpty() && _messageRates.isEmpty()) {
+        return;
+    }
+
+    _messageRates.clear();
+    for (auto counter = _messageCounters.cbegin(); counter != _messageCounters.cend(); ++counter) {
+        _messageRates[QString::number(counter.key())] = counter.value() / elapsedSeconds;
+    }
+    _messageCounters.clear();
+    emit messageRatesChanged();
+}
+
 void MavlinkManager::sendHeartbeatMessage()
 {
     if (_linkIn) {
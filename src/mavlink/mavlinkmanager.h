@@ -1,5 +1,11 @@
 #pragma once
+#include <functional>
+
+#include <QElapsedTimer>
+#include <QHash>
 #include <QLoggingCategory>
+#include <QPointer>
+#include <QVector>
 
 #define MAVLINK_MESSAGE_CRCS                                                                                           \
     {                                                                                                                  \
@@ -48,11 +54,45 @@ public:
 
     /**
      * @brief Parse data for the mavlink message
+     *  Messages without subscribers are only counted
      *
      * @param data
      */
     void parseData(const QByteArray data);
 
+    /**
+     * @brief Function called with each received message of a subscribed ID
+     *
+     */
+    using MessageHandler = std::function<void(const mavlink_message_t& message)>;
+
+    /**
+     * @brief Deliver messages with a specific ID to handler
+     *  Replaces a previous subscription of context for the same ID,
+     *  handler is not called after context is destroyed
+     *
+     * @param messageId
+     * @param context
+     * @param handler
+     */
+    void subscribe(uint32_t messageId, QObject* context, MessageHandler handler);
+
+    /**
+     * @brief Remove all subscriptions of context for a message ID
+     *
+     * @param messageId
+     * @param context
+     */
+    void unsubscribe(uint32_t messageId, QObject* context);
+
+    /**
+     * @brief Return the received messages per second of each message ID in the last second
+     *
+     * @return QVariantMap
+     */
+    QVariantMap messageRates() const { return _messageRates; };
+    Q_PROPERTY(QVariantMap messageRates READ messageRates NOTIFY messageRatesChanged)
+
     /**
      * @brief Return MavlinkManager pointer
      *
@@ -70,7 +110,7 @@ public:
     static QObject* qmlSingletonRegister(QQmlEngine* engine, QJSEngine* scriptEngine);
 
 signals:
-    void mavlinkMessage(const mavlink_message_t& message) const;
+    void messageRatesChanged();
 
 private:
     Q_DISABLE_COPY(MavlinkManager)
@@ -86,7 +126,25 @@ private:
      */
     void sendHeartbeatMessage();
 
+    /**
+     * @brief Update the message rates with the messages received since the last update
+     *
+     */
+    void updateMessageRates();
+
+    struct Subscriber {
+        QPointer<QObject> context;
+        MessageHandler handler;
+    };
+
     QByteArray _heartbeatMessage = createHeartbeatMessage();
     QSharedPointer<Link> _linkIn;
     QTimer _heartbeatTimer;
+    mavlink_message_t _message;
+    QHash<uint32_t, QVector<Subscriber>> _subscribers;
+
+    QHash<uint32_t, int> _messageCounters;
+    QVariantMap _messageRates;
+    QElapsedTimer _messageRatesElapsed;
+    QTimer _messageRatesTimer;
 };
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <cmath>
+
+#include <QtMath>
+
+#include "attitudebuffer.h"
+#include "tracer.h"
+
+qint64 AttitudeBuffer::timestampNs() { return Tracer::timestampNs(); }
+
+void AttitudeBuffer::append(qint64 timestampNs, float yaw)
+{
+    const quint64 index = _size.load(std::memory_order_relaxed);
+    Slot& slot = _slots[index % capacity];
+
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.timestampNs.store(timestampNs, std::memory_order_relaxed);
+    slot.yaw.store(yaw, std::memory_order_relaxed);
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+
+    _size.store(index + 1, std::memory_order_release);
+}
+
+bool AttitudeBuffer::readSample(quint64 index, Sample& sample) const
+{
+    const Slot& slot = _slots[index % capacity];
+    const quint64 sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence != 2 * index + 2) {
+        return false;
+    }
+
+    sample.timestampNs = slot.timestampNs.load(std::memory_order_relaxed);
+    sample.yaw = slot.yaw.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+bool AttitudeBuffer::yawAt(qint64 timestampNs, float& yaw) const
+{
+    const quint64 size = _size.load(std::memory_order_acquire);
+    const quint64 cleared = _clearedSize.load(std::memory_order_acquire);
+    const quint64 first = std::max(cleared, size > capacity ? size - capacity : 0);
+
+    // Search from the newest sample, lookups are normally for recent times
+    Sample after {};
+    bool hasAfter = false;
+    for (quint64 index = size; index > first; index--) {
+        Sample sample;
+        if (!readSample(index - 1, sample)) {
+            // Overwritten by the producer, older samples are gone as well
+            break;
+        }
+
+        if (sample.timestampNs <= timestampNs) {
+            if (!hasAfter || after.timestampNs == sample.timestampNs) {
+                yaw = sample.yaw;
+                return true;
+            }
+
+            // Interpolate through the shortest way around the circle
+            const float fraction
+                = static_cast<float>(timestampNs - sample.timestampNs) / (after.timestampNs - sample.timestampNs);
+            const float difference = std::remainder(after.yaw - sample.yaw, static_cast<float>(2 * M_PI));
+            yaw = std::remainder(sample.yaw + difference * fraction, static_cast<float>(2 * M_PI));
+            return true;
+        }
+
+        after = sample;
+        hasAfter = true;
+    }
+
+    // Time is older than the history
+    if (hasAfter) {
+        yaw = after.yaw;
+    }
+    return hasAfter;
+}
+
+void AttitudeBuffer::clear() { _clearedSize.store(_size.load(std::memory_order_acquire), std::memory_order_release); }
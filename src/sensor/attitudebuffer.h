@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include <QtGlobal>
+
+/**
+ * @brief Timestamped vehicle attitude history
+ *  A single producer appends samples when they arrive and consumers look up the heading at any
+ *  recent time without locks. Each slot is protected by a sequence number, readers retry or
+ *  skip a slot when it is overwritten while being read.
+ */
+class AttitudeBuffer {
+public:
+    /**
+     * @brief Return the monotonic time used by samples and lookups
+     *  Same clock as the link receive times, Tracer::timestampNs
+     *
+     * @return qint64 timestamp in nanoseconds
+     */
+    static qint64 timestampNs();
+
+    /**
+     * @brief Add a sample, must be called from a single thread
+     *
+     * @param timestampNs
+     * @param yaw in radians
+     */
+    void append(qint64 timestampNs, float yaw);
+
+    /**
+     * @brief Return the yaw interpolated at a time
+     *  Times outside the history use the closest sample
+     *
+     * @param timestampNs
+     * @param yaw in radians
+     * @return true
+     * @return false when there is no sample
+     */
+    bool yawAt(qint64 timestampNs, float& yaw) const;
+
+    /**
+     * @brief Ignore all samples appended before this call, can be called from any thread
+     *
+     */
+    void clear();
+
+    // Enough for some seconds of ATTITUDE messages
+    static constexpr int capacity = 256;
+
+private:
+    struct Sample {
+        qint64 timestampNs;
+        float yaw;
+    };
+
+    struct Slot {
+        // Odd while the slot is written
+        std::atomic<quint64> sequence {0};
+        std::atomic<qint64> timestampNs {0};
+        std::atomic<float> yaw {0};
+    };
+
+    bool readSample(quint64 index, Sample& sample) const;
+
+    std::array<Slot, capacity> _slots;
+    std::atomic<quint64> _size {0};
+    std::atomic<quint64> _clearedSize {0};
+};
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "ping-message.h"
+#include "tracer.h"
 #include <QObject>
 
+#include <atomic>
+
 /**
  * This class digests data and notifies owner when something interesting happens
  */
@@ -21,8 +24,9 @@ public:
         NEW_MESSAGE // got a new packet
     };
 
-    uint32_t parsed = 0; // number of messages/packets successfully parsed
-    uint32_t errors = 0; // number of parse errors
+    // Counters are updated by the parser thread and read by the sensor
+    std::atomic<uint32_t> parsed {0}; // number of messages/packets successfully parsed
+    std::atomic<uint32_t> errors {0}; // number of parse errors
 
     /**
      * @brief clear parse state
@@ -35,6 +39,18 @@ public:
      */
     virtual void parseBuffer(const QByteArray& data) = 0;
 
+    /**
+     * @brief asynchronous use with the link receive time of the parsed messages, also used for latency tracing
+     * @param data the next sequence of bytes in the serial stream being parsed
+     * @param receivedNs when data was received by the link, from Tracer::timestampNs, 0 if unknown
+     */
+    void parseBuffer(const QByteArray& data, qint64 receivedNs)
+    {
+        _receivedNs = receivedNs;
+        parseBuffer(data);
+        _receivedNs = 0;
+    }
+
     /**
      * @brief synchronous use, Child should return flags indicating incremental parse result/status
      * @param byte the next byte in serial stream being parsed
@@ -50,9 +66,28 @@ public:
     ping_message rxMessage() const { return _rxMessage; }
 
 signals:
-    void newMessage(const ping_message& msg);
+    // receivedNs is when the link received the end of the message, 0 if unknown
+    void newMessage(const ping_message& msg, qint64 receivedNs);
+    // Emitted before newMessage when the message is traced
+    void messageTraced(const Tracer::Context& context);
     void parseError();
 
 protected:
+    /**
+     * @brief Start the trace of a parsed message, should be called before newMessage
+     *
+     */
+    void traceMessage()
+    {
+        Tracer::Context context = Tracer::self()->begin(_receivedNs);
+        if (context.isValid()) {
+            Tracer::self()->mark(context, Tracer::Parse);
+            emit messageTraced(context);
+        }
+    }
+
     ping_message _rxMessage;
+    qint64 _receivedNs = 0;
 };
+
+Q_DECLARE_METATYPE(ping_message)
@@ -14,7 +14,6 @@
 #include <QThread>
 #include <QUrl>
 
-#include "hexvalidator.h"
 #include "link/seriallink.h"
 #include "networkmanager.h"
 #include "networktool.h"
@@ -73,12 +72,12 @@ Ping::Ping()
 
     // Wait for device id to load the correct settings
     connect(this, &Ping::srcIdChanged, this, &Ping::setLastPingConfiguration);
+    connect(&_lastPingConfigurationTimer, &QTimer::timeout, this, &Ping::checkLastPingConfiguration);
 
     connect(this, &Ping::firmwareVersionMinorChanged, this, [this] {
         // Wait for firmware information to be available before looking for new versions
-        static bool once = false;
-        if (!once) {
-            once = true;
+        if (!_firmwareVersionChecked) {
+            _firmwareVersionChecked = true;
             NetworkTool::self()->checkNewFirmware(
                 "ping1d", std::bind(&Ping::checkNewFirmwareInGitHubPayload, this, std::placeholders::_1));
         }
@@ -316,7 +315,8 @@ void Ping::flash(const QString& fileUrl, bool sendPingGotoBootloader, int baud,
 {
     flasher()->setState(Flasher::Idle);
     flasher()->setState(Flasher::StartingFlash);
-    if (!HexValidator::isValidFile(fileUrl)) {
+    // The image is parsed once here and kept by the flasher
+    if (!flasher()->setFirmwarePath(fileUrl)) {
         auto errorMsg = QStringLiteral("File does not contain a valid Intel Hex format: %1").arg(fileUrl);
         qCWarning(PING_PROTOCOL_PING) << errorMsg;
         flasher()->setState(Flasher::Error, errorMsg);
@@ -361,7 +361,6 @@ void Ping::flash(const QString& fileUrl, bool sendPingGotoBootloader, int baud,
 
     auto flashSensor = [=] {
         flasher()->setBaudRate(baud);
-        flasher()->setFirmwarePath(fileUrl);
         flasher()->setLink(link()->configuration()[0]);
         flasher()->setVerify(verify);
         flasher()->flash();
@@ -415,35 +414,34 @@ void Ping::setLastPingConfiguration()
     output += QStringLiteral("}");
     qCDebug(PING_PROTOCOL_PING).noquote() << output;
 
-    // Set loaded configuration in device
-    static QString debugMessage
+    // Set loaded configuration in device, the timer checks until the device accepts it
+    _lastPingConfigurationTimer.start(500);
+}
+
+void Ping::checkLastPingConfiguration()
+{
+    static const QString debugMessage
         = QStringLiteral("Device configuration does not match. Waiting for (%1), got (%2) for %3");
-    static auto lastPingConfigurationTimer = new QTimer();
-    connect(lastPingConfigurationTimer, &QTimer::timeout, this, [this] {
-        bool stopLastPingConfigurationTimer = true;
-        for (const auto& key : _pingConfiguration.keys()) {
-            auto& dataStruct = _pingConfiguration[key];
-            if (dataStruct.value != dataStruct.getClassValue()) {
-                qCDebug(PING_PROTOCOL_PING)
-                    << debugMessage.arg(dataStruct.value).arg(dataStruct.getClassValue()).arg(key);
-                dataStruct.setClassValue(dataStruct.value);
-                stopLastPingConfigurationTimer = false;
-            }
-            if (key.contains("automaticMode") && dataStruct.value) {
-                qCDebug(PING_PROTOCOL_PING) << "Device was running with last configuration in auto mode.";
-                // If it's running in automatic mode
-                // no further configuration is necessary
-                break;
-            }
+    bool stopLastPingConfigurationTimer = true;
+    for (const auto& key : _pingConfiguration.keys()) {
+        auto& dataStruct = _pingConfiguration[key];
+        if (dataStruct.value != dataStruct.getClassValue()) {
+            qCDebug(PING_PROTOCOL_PING) << debugMessage.arg(dataStruct.value).arg(dataStruct.getClassValue()).arg(key);
+            dataStruct.setClassValue(dataStruct.value);
+            stopLastPingConfigurationTimer = false;
         }
-        if (stopLastPingConfigurationTimer) {
-            qCDebug(PING_PROTOCOL_PING) << "Last configuration done, timer will stop now.";
-            lastPingConfigurationTimer->stop();
-            do_continuous_start(ContinuousId::PROFILE);
+        if (key.contains("automaticMode") && dataStruct.value) {
+            qCDebug(PING_PROTOCOL_PING) << "Device was running with last configuration in auto mode.";
+            // If it's running in automatic mode
+            // no further configuration is necessary
+            break;
         }
-    });
-    lastPingConfigurationTimer->start(500);
-    lastPingConfigurationTimer->start();
+    }
+    if (stopLastPingConfigurationTimer) {
+        qCDebug(PING_PROTOCOL_PING) << "Last configuration done, timer will stop now.";
+        _lastPingConfigurationTimer.stop();
+        do_continuous_start(ContinuousId::PROFILE);
+    }
 }
 
 void Ping::setPingFrequency(float pingFrequency)
@@ -545,7 +543,12 @@ void Ping::resetSensorLocalVariables()
     _lastPingConfigurationSrcId = -1;
 }
 
-Ping::~Ping() { updatePingConfigurationSettings(); }
+Ping::~Ping()
+{
+    // Messages must not reach a sensor that is being destroyed
+    stopParserThread();
+    updatePingConfigurationSettings();
+}
 
 QDebug operator<<(QDebug d, const Ping::messageStatus& other)
 {
@@ -410,6 +410,12 @@ private:
     void updatePingConfigurationSettings();
     void setLastPingConfiguration();
 
+    /**
+     * @brief Apply the last configuration again until the device reports it
+     *
+     */
+    void checkLastPingConfiguration();
+
     /**
      * @brief Internal function used to use as a flash callback
      *
@@ -453,6 +459,12 @@ private:
     // For automatic periodic updates (board voltage and temperature)
     QTimer _periodicRequestTimer;
 
+    // Retry the last configuration until the device accepts it
+    QTimer _lastPingConfigurationTimer;
+
+    // New firmware versions are checked once per sensor
+    bool _firmwareVersionChecked = false;
+
     QSharedPointer<QProcess> _firmwareProcess;
 
     struct settingsConfiguration {
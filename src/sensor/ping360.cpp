@@ -16,7 +16,6 @@
 #include <QThread>
 #include <QUrl>
 
-#include "hexvalidator.h"
 #include "link/seriallink.h"
 #include "networkmanager.h"
 #include "networktool.h"
@@ -72,10 +71,9 @@ Ping360::Ping360()
         qCWarning(PING_PROTOCOL_PING360) << "Profile message timeout, new request will be done.";
         requestNextProfile();
 
-        static int timeoutedTime = 0;
-        timeoutedTime += _timeoutProfileMessage.interval();
-        if (timeoutedTime > _sensorRestartTimeoutMs) {
-            timeoutedTime = 0;
+        _timeoutedTimeMs += _timeoutProfileMessage.interval();
+        if (_timeoutedTimeMs > _sensorRestartTimeoutMs) {
+            _timeoutedTimeMs = 0;
             _timeoutProfileMessage.setInterval(_sensorTimeout);
         }
     });
@@ -105,9 +103,8 @@ Ping360::Ping360()
                                        << _commonVariables.deviceInformation.firmware_version_patch;
 
         // Wait for firmware information to be available before looking for new versions
-        static bool once = false;
-        if (!once && _commonVariables.deviceInformation.initialized) {
-            once = true;
+        if (!_firmwareVersionChecked && _commonVariables.deviceInformation.initialized) {
+            _firmwareVersionChecked = true;
 
             if (_commonVariables.deviceInformation.firmware_version_major == 3
                 && _commonVariables.deviceInformation.firmware_version_minor == 3
@@ -124,6 +121,17 @@ Ping360::Ping360()
         _sensorSettings.end_angle = (angle_offset() + _sectorSize / 2 - 1) % 400;
     });
 
+    // The interface does not need heading updates faster than it can draw them,
+    // the timer only runs after attitude samples arrive
+    _headingUpdateTimer.setInterval(_headingUpdatePeriodMs);
+    connect(&_headingUpdateTimer, &QTimer::timeout, this, [this] {
+        const float heading = headingAt(AttitudeBuffer::timestampNs());
+        if (heading != _heading) {
+            _heading = heading;
+            emit headingChanged();
+        }
+    });
+
     // By default heading integration is enabled
     enableHeadingIntegration(true);
 }
@@ -163,7 +171,7 @@ void Ping360::checkBaudrateProcess()
     // We use the pre configuration message to check for valid baud rates
     startPreConfigurationProcess();
 
-    static int count = _ABRTotalNumberOfMessages;
+    int& count = _baudRateDetection.remainingMessages;
 
     if (_resetBaudRateDetection) {
         count = _ABRTotalNumberOfMessages;
@@ -301,6 +309,9 @@ void Ping360::handleMessage(const ping_message& msg)
         // Parse message
         const ping360_device_data deviceData = *static_cast<const ping360_device_data*>(&msg);
 
+        // Heading of the vehicle when the link received the profile, not when it is handled or drawn
+        _profileHeading = headingAt(_messageReceivedNs);
+
         // Get angle to request next message
         _angle = deviceData.angle();
 
@@ -354,6 +365,9 @@ void Ping360::handleMessage(const ping_message& msg)
         // Parse message
         const ping360_auto_device_data autoDeviceData = *static_cast<const ping360_auto_device_data*>(&msg);
 
+        // Heading of the vehicle when the link received the profile, not when it is handled or drawn
+        _profileHeading = headingAt(_messageReceivedNs);
+
         // Get angle to request next message
         _angle = autoDeviceData.angle();
 
@@ -529,21 +543,18 @@ void Ping360::setBaudRateAndRequestProfile(int baudRate)
 void Ping360::detectBaudrates()
 {
     // Check all valid baudrates
-    static int index = 0;
+    int& index = _baudRateDetection.index;
 
     // baudrate to error
-    static QMap<int, int> baudRateToError;
+    QMap<int, int>& baudRateToError = _baudRateDetection.baudRateToError;
 
     // last parser error count
-    static int lastParserErrorCount = 0;
-    static int lastParserMsgsCount = 0;
+    int& lastParserErrorCount = _baudRateDetection.lastParserErrorCount;
+    int& lastParserMsgsCount = _baudRateDetection.lastParserMsgsCount;
 
     if (_resetBaudRateDetection) {
         _resetBaudRateDetection = false;
-        index = 0;
-        baudRateToError.clear();
-        lastParserErrorCount = 0;
-        lastParserMsgsCount = 0;
+        _baudRateDetection = {};
     };
 
     // Check error margin
@@ -647,9 +658,13 @@ void Ping360::resetSettings()
 void Ping360::enableHeadingIntegration(bool enable)
 {
     if (enable) {
-        connect(MavlinkManager::self(), &MavlinkManager::mavlinkMessage, this, &Ping360::processMavlinkMessage);
+        MavlinkManager::self()->subscribe(MAVLINK_MSG_ID_ATTITUDE, this,
+            [this](const mavlink_message_t& message) { processMavlinkMessage(message); });
     } else {
-        disconnect(MavlinkManager::self(), &MavlinkManager::mavlinkMessage, this, &Ping360::processMavlinkMessage);
+        MavlinkManager::self()->unsubscribe(MAVLINK_MSG_ID_ATTITUDE, this);
+        _headingUpdateTimer.stop();
+        _attitudeBuffer.clear();
+        _profileHeading = 0;
         _heading = 0;
         emit headingChanged();
     }
@@ -661,13 +676,25 @@ void Ping360::processMavlinkMessage(const mavlink_message_t& message)
     case MAVLINK_MSG_ID_ATTITUDE: {
         mavlink_attitude_t attitude;
         mavlink_msg_attitude_decode(&message, &attitude);
-        _heading = attitude.yaw * 200 / M_PI;
-        emit headingChanged();
+        _attitudeBuffer.append(AttitudeBuffer::timestampNs(), attitude.yaw);
+        if (!_headingUpdateTimer.isActive()) {
+            _headingUpdateTimer.start();
+        }
         break;
     }
     default:
-        qCWarning(PING_PROTOCOL_PING360) << "Unhandled mavlink message ID:" << message.msgid;
+        // Only subscribed messages are delivered
+        qCDebug(PING_PROTOCOL_PING360) << "Unhandled mavlink message ID:" << message.msgid;
+    }
+}
+
+float Ping360::headingAt(qint64 timestampNs) const
+{
+    float yaw;
+    if (!_attitudeBuffer.yawAt(timestampNs, yaw)) {
+        return 0;
     }
+    return yaw * 200 / M_PI;
 }
 
 float Ping360::profileFrequency() const
@@ -680,6 +707,8 @@ float Ping360::profileFrequency() const
 
 Ping360::~Ping360()
 {
+    // Messages must not reach a sensor that is being destroyed
+    stopParserThread();
     updateSensorConfigurationSettings();
 
     // TODO: Find a better way
@@ -8,6 +8,7 @@
 #include <QProcess>
 #include <QTimer>
 
+#include "attitudebuffer.h"
 #include "mavlinkmanager.h"
 #include "parser.h"
 #include "ping-message-common.h"
@@ -154,8 +155,8 @@ public:
     uint16_t angle()
     {
         // Only use heading correction if running in full scam mode (sector size == resolution)
-        const int angle
-            = _angle + angle_offset() + (_sectorSize == _angularResolutionGrad ? static_cast<int>(_heading) : 0);
+        const int angle = _angle + angle_offset()
+            + (_sectorSize == _angularResolutionGrad ? static_cast<int>(_profileHeading) : 0);
         return angle % _angularResolutionGrad;
     }
     Q_PROPERTY(int angle READ angle NOTIFY angleChanged)
@@ -693,8 +694,14 @@ private:
     // Sector size in gradians, default is full circle
     int _sectorSize = 400;
 
-    // Sensor heading in radians
+    // Sensor heading in gradians, updated for the interface at display rate
     float _heading = 0;
+    // Sensor heading in gradians when the last profile was received
+    float _profileHeading = 0;
+    // Vehicle attitude history, filled by MAVLink messages
+    AttitudeBuffer _attitudeBuffer;
+    QTimer _headingUpdateTimer;
+    static constexpr int _headingUpdatePeriodMs = 1000 / 60;
 
     QTimer _messageFrequencyTimer;
     QTimer _timeoutProfileMessage;
@@ -708,6 +715,27 @@ private:
     QTimer _baudrateConfigurationTimer;
     bool _resetBaudRateDetection = true;
 
+    /**
+     * @brief State of the automatic baud rate detection
+     *
+     */
+    struct BaudRateDetection {
+        // Position in the list of valid baud rates
+        int index = 0;
+        // Number of failed messages for each baud rate
+        QMap<int, int> baudRateToError;
+        int lastParserErrorCount = 0;
+        int lastParserMsgsCount = 0;
+        // Messages left to check the actual baud rate
+        int remainingMessages = _ABRTotalNumberOfMessages;
+    } _baudRateDetection;
+
+    // Time without profiles, used to detect a sensor restart
+    int _timeoutedTimeMs = 0;
+
+    // The firmware version is checked once per sensor
+    bool _firmwareVersionChecked = false;
+
     // Helper structure to hold frequency information for each message
     struct MessageFrequencyHelper {
         // Hold last frequency
@@ -866,4 +894,12 @@ private:
      * @param message
      */
     void processMavlinkMessage(const mavlink_message_t& message);
+
+    /**
+     * @brief Return the heading in gradians at a time
+     *
+     * @param timestampNs from AttitudeBuffer::timestampNs
+     * @return float
+     */
+    float headingAt(qint64 timestampNs) const;
 };
@@ -9,7 +9,8 @@ void PingParserExt::parseBuffer(const QByteArray& data)
         if (state == PingParser::ParseState::NEW_MESSAGE) {
             parsed++;
             _rxMessage = _parser.rxMessage;
-            emit newMessage(_rxMessage);
+            traceMessage();
+            emit newMessage(_rxMessage, _receivedNs);
         } else if (state == PingParser::ParseState::ERROR) {
             errors++;
             emit parseError();
@@ -8,10 +8,18 @@ PING_LOGGING_CATEGORY(PING_PROTOCOL_PINGSENSOR, "ping.protocol.pingsensor")
 PingSensor::PingSensor(PingDeviceType pingDeviceType)
     : Sensor({SensorFamily::PING, {static_cast<int>(pingDeviceType)}})
 {
+    qRegisterMetaType<ping_message>();
+    qRegisterMetaType<Tracer::Context>();
     _parser = new PingParserExt();
+    // Messages are parsed in the sensor parser thread and handled in the sensor thread
     connect(dynamic_cast<PingParserExt*>(_parser), &PingParserExt::newMessage, this, &PingSensor::handleMessagePrivate,
-        Qt::DirectConnection);
-    connect(dynamic_cast<PingParserExt*>(_parser), &PingParserExt::parseError, this, &PingSensor::parserErrorsChanged);
+        Qt::QueuedConnection);
+    connect(dynamic_cast<PingParserExt*>(_parser), &PingParserExt::parseError, this, &PingSensor::parserErrorsChanged,
+        Qt::QueuedConnection);
+    connect(
+        _parser, &Parser::messageTraced, this, [this](const Tracer::Context& context) { _traceContext = context; },
+        Qt::QueuedConnection);
+    startParserThread();
 }
 
 void PingSensor::request(int id) const
@@ -36,8 +44,14 @@ void PingSensor::writeMessage(const ping_message& msg) const
     }
 }
 
-void PingSensor::handleMessagePrivate(const ping_message& msg)
+void PingSensor::handleMessagePrivate(const ping_message& msg, qint64 receivedNs)
 {
+    _messageReceivedNs = receivedNs ? receivedNs : Tracer::timestampNs();
+
+    Tracer::Context traceContext = _traceContext;
+    _traceContext = {};
+    Tracer::self()->mark(traceContext, Tracer::Dispatch);
+
     qCDebug(PING_PROTOCOL_PINGSENSOR) << QStringLiteral("Handling Message: %1 [%2]")
                                              .arg(PingHelper::nameFromMessageId(
                                                  static_cast<PingEnumNamespace::PingMessageId>(msg.message_id())))
@@ -136,7 +150,12 @@ void PingSensor::handleMessagePrivate(const ping_message& msg)
         break;
     }
 
+    Tracer::self()->mark(traceContext, Tracer::HandleMessagePrivate);
+
+    // Visualizers draw the message while it is handled
+    Tracer::setCurrent(traceContext);
     handleMessage(msg);
+    Tracer::setCurrent({});
 }
 
 void PingSensor::printStatus() const
@@ -161,4 +180,4 @@ void PingSensor::printStatus() const
     printSensorInformation();
 }
 
-PingSensor::~PingSensor() = default;
+PingSensor::~PingSensor() { stopParserThread(); }
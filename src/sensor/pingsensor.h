@@ -172,8 +172,9 @@ protected:
      * @brief Handle new ping protocol messages
      *
      * @param msg
+     * @param receivedNs when the link received the message, from Tracer::timestampNs
      */
-    void handleMessagePrivate(const ping_message& msg);
+    void handleMessagePrivate(const ping_message& msg, qint64 receivedNs);
 
     /**
      * @brief Handle new ping protocol messages
@@ -224,6 +225,12 @@ protected:
 
     int _lostMessages {0};
 
+    // When the link received the message being handled, from Tracer::timestampNs
+    qint64 _messageReceivedNs {0};
+
 private:
     Q_DISABLE_COPY(PingSensor)
+
+    // Trace of the next message to be handled
+    Tracer::Context _traceContext;
 };
@@ -5,6 +5,7 @@
 #include "filelink.h"
 #include "filemanager.h"
 #include "sensor.h"
+#include "tracer.h"
 
 #include <ping-message-common.h>
 #include <ping-message.h>
@@ -57,8 +58,36 @@ void Sensor::connectLink(const LinkConfiguration conConf, const LinkConfiguratio
 
     emit linkChanged();
 
+    connect(link(), &AbstractLink::connectionLost, this, &Sensor::connectionClose);
+
     if (_parser) {
-        connect(link(), &AbstractLink::newData, _parser, &Parser::parseBuffer, Qt::DirectConnection);
+        // Log replay waits until the sensor handled the data, the event queues do not grow with fast replays
+        const bool flowControl = link()->type() == LinkType::File;
+        link()->setFlowControl(flowControl);
+
+        // Data is timestamped when received, before waiting for the parser thread
+        connect(link(), &AbstractLink::newData, this,
+            [this, parser = _parser, flowControl, link = QPointer<AbstractLink>(link())](const QByteArray& data) {
+                const qint64 receivedNs = Tracer::timestampNs();
+                QMetaObject::invokeMethod(
+                    parser,
+                    [this, parser, data, receivedNs, flowControl, link] {
+                        parser->parseBuffer(data, receivedNs);
+                        if (!flowControl) {
+                            return;
+                        }
+                        // Queued after the messages of the data, it runs once the sensor handled them
+                        QMetaObject::invokeMethod(
+                            this,
+                            [link] {
+                                if (link) {
+                                    link->dataConsumed();
+                                }
+                            },
+                            Qt::QueuedConnection);
+                    },
+                    Qt::QueuedConnection);
+            });
     }
 
     emit connectionOpen();
@@ -118,6 +147,66 @@ void Sensor::connectLinkLog(const LinkConfiguration& logConf)
     emit linkLogChanged();
 }
 
+void Sensor::connectLinkForward(const LinkConfiguration& forwardConf)
+{
+    QObject::disconnect(_forwardConnection);
+    _forwardEncoder.setDevice(nullptr);
+    _linkForward.clear();
+
+    if (!forwardConf.isValid()) {
+        qCWarning(PING_PROTOCOL_SENSOR) << LinkConfiguration::errorToString(forwardConf.error());
+        return;
+    }
+
+    // Encoded frames must arrive in a single read, only datagrams keep their boundaries
+    if (forwardConf.type() != LinkType::Udp || !_parser) {
+        qCWarning(PING_PROTOCOL_SENSOR) << "Messages can only be forwarded with an UDP link:" << forwardConf;
+        return;
+    }
+
+    _linkForward = QSharedPointer<Link>(new Link(forwardConf));
+    linkForward()->startConnection();
+    if (!linkForward()->isOpen()) {
+        qCCritical(PING_PROTOCOL_SENSOR) << "Connection with forward fail !" << forwardConf
+                                         << linkForward()->errorString();
+        _linkForward.clear();
+        return;
+    }
+
+    // Messages are encoded one by one, the link data may have partial messages
+    _forwardEncoder.setDevice(linkForward()->device());
+    _forwardConnection = connect(_parser, &Parser::newMessage, this, [this](const ping_message& msg) {
+        _forwardEncoder.write(QByteArray(reinterpret_cast<const char*>(msg.msgData), msg.msgDataLength()));
+    });
+}
+
+void Sensor::disconnectLink()
+{
+    qCDebug(PING_PROTOCOL_SENSOR) << "Disconnecting" << name();
+    if (linkLog() && linkLog()->isOpen()) {
+        linkLog()->finishConnection();
+    }
+
+    if (linkForward()) {
+        QObject::disconnect(_forwardConnection);
+        linkForward()->finishConnection();
+    }
+
+    if (!link() || !link()->isOpen()) {
+        return;
+    }
+    link()->finishConnection();
+    emit connectionClose();
+}
+
+void Sensor::startParserThread()
+{
+    // Each sensor has its own parser thread, a busy or stalled sensor does not delay the others
+    _parserThread.setObjectName(QStringLiteral("SensorParser"));
+    _parser->moveToThread(&_parserThread);
+    _parserThread.start();
+}
+
 void Sensor::setControlPanel(const QUrl& url)
 {
     if (!url.isValid()) {
@@ -227,4 +316,14 @@ void Sensor::setName(const QString& name)
     emit nameChanged();
 }
 
-Sensor::~Sensor() = default;
+void Sensor::stopParserThread()
+{
+    _parserThread.quit();
+    _parserThread.wait();
+}
+
+Sensor::~Sensor()
+{
+    stopParserThread();
+    delete _parser;
+}
@@ -3,11 +3,13 @@
 #include <QPointer>
 #include <QQmlComponent>
 #include <QQuickItem>
+#include <QThread>
 
 #include "flasher.h"
 #include "link.h"
 #include "logger.h"
 #include "parser.h"
+#include "profilecodec.h"
 #include "protocoldetector.h"
 #include "sensorinfo.h"
 
@@ -43,6 +45,13 @@ public:
     AbstractLink* linkLog() const { return _linkOut.data() ? _linkOut->self() : nullptr; };
     Q_PROPERTY(AbstractLink* linkLog READ linkLog NOTIFY linkLogChanged)
 
+    /**
+     * @brief Return forward link
+     *
+     * @return AbstractLink*
+     */
+    AbstractLink* linkForward() const { return _linkForward.data() ? _linkForward->self() : nullptr; };
+
     /**
      * @brief Return sensor name
      *
@@ -68,6 +77,21 @@ public:
      */
     void connectLinkLog(const LinkConfiguration& logConf);
 
+    /**
+     * @brief Forward the sensor messages to another application
+     *  Profiles are compressed with the most accurate level that fits in the forward link throughput,
+     *  the receiving UDP link decodes them
+     *
+     * @param forwardConf UDP link configuration
+     */
+    void connectLinkForward(const LinkConfiguration& forwardConf);
+
+    /**
+     * @brief Close the connection, log and forward links
+     *
+     */
+    Q_INVOKABLE void disconnectLink();
+
     /**
      * @brief Return true if sensor is connected
      *
@@ -158,9 +182,13 @@ protected:
     // This class should be a singleton that will work with the future DeviceManager class
     // TODO: Move to a singleton and integrate with DeviceManager
     Flasher _flasher;
+    QMetaObject::Connection _forwardConnection;
+    ProfileEncoder _forwardEncoder;
+    QSharedPointer<Link> _linkForward;
     QSharedPointer<Link> _linkIn;
     QSharedPointer<Link> _linkOut;
     Parser* _parser; // communication implementation
+    QThread _parserThread;
 
     QString _name;
 
@@ -193,6 +221,20 @@ protected:
      */
     void setName(const QString& name);
 
+    /**
+     * @brief Move the parser to the sensor parser thread
+     *  Data from the link is queued to the parser and messages are queued back to the sensor
+     *
+     */
+    void startParserThread();
+
+    /**
+     * @brief Stop the parser thread, nothing is parsed or queued to the sensor after it
+     *  Called by the destructor of the most derived sensor, before its members are destroyed
+     *
+     */
+    void stopParserThread();
+
 signals:
     void autoDetectUpdate(bool autodetect);
 
@@ -78,7 +78,6 @@ void SettingsManager::set(const QString& settingName, const QVariant& value)
         qCDebug(SETTINGSMANAGER) << QStringLiteral("In %1:").arg(settingName) << value;
     }
     _settings.setValue(settingName, value);
-    _settings.sync();
 }
 
 QObject* SettingsManager::qmlSingletonRegister(QQmlEngine* engine, QJSEngine* scriptEngine)
@@ -98,5 +97,6 @@ SettingsManager* SettingsManager::self()
 SettingsManager::~SettingsManager()
 {
     saveLinkConfigurations();
+    // Everything is written before the application exits
     _settings.sync();
 }
@@ -1,12 +1,12 @@
 #pragma once
 
 #include <QLoggingCategory>
-#include <QSettings>
 #include <QStringListModel>
 
 #include "linkconfiguration.h"
 #include "qjsonsettings.h"
 #include "settingsmanagerhelper.h"
+#include "settingsstore.h"
 #include "varianttree.h"
 
 class QJSEngine;
@@ -58,11 +58,11 @@ public:
     }
 
     /**
-     * @brief Return QSettings reference
+     * @brief Return the settings store
      *
-     * @return QSettings&
+     * @return SettingsStore&
      */
-    QSettings& settings() { return _settings; };
+    SettingsStore& settings() { return _settings; };
 
     /**
      * @brief Return SettingsManager pointer
@@ -109,7 +109,7 @@ private:
     void loadLinkConfigurations();
 
     QVector<LinkConfiguration> _lastLinkConfigurations;
-    QSettings _settings;
+    SettingsStore _settings;
     VariantTree _tree;
 
     /**
@@ -119,12 +119,17 @@ private:
     // Everything after this line should be AUTO_PROPERTY
     AUTO_PROPERTY(uint, applicationOpacityIndex, 0)
     AUTO_PROPERTY(bool, alwaysOnTop, false)
+    AUTO_PROPERTY(bool, compressSensorLogs, false)
     AUTO_PROPERTY(bool, debugMode, false)
     AUTO_PROPERTY(uint, enabledCategories, 0)
     AUTO_PROPERTY(bool, logScrollLock, true)
-    AUTO_PROPERTY(bool, realTimeReplay, true)
+    AUTO_PROPERTY(bool, renderProfiler, false)
     AUTO_PROPERTY(bool, replayMenu, false)
+    AUTO_PROPERTY(float, replaySpeed, 1)
     AUTO_PROPERTY(bool, reset, false)
+    AUTO_PROPERTY(uint, sensorLogFsyncPolicy, 0)
+    AUTO_PROPERTY(uint, sensorLogRotationMinutes, 0)
+    AUTO_PROPERTY(uint, sensorLogRotationSizeMB, 0)
     AUTO_PROPERTY(bool, darkTheme, false)
     AUTO_PROPERTY(bool, enableSensorAdvancedConfiguration, false)
     // AUTO_PROPERTY_MODEL(QString, adistanceUnits, QStringList, MODEL({"Metric", "Imperial"})) // Example
@@ -57,7 +57,6 @@ template <typename T> T qVariantValueOf(const QVariant& variant) { return varian
  *        if(_myName == value) { return; }
  *        _myName = value;
  *        _settings.setValue(QStringLiteral("myName"), QVariant::fromValue(value));
- *        _settings.sync();
  *        qCDebug(SETTINGSMANAGER) << QStringLiteral("Save %1 with:").arg("myName") << value;
  *        emit myNameChanged();
  *    }
@@ -89,7 +88,6 @@ public:
         }                                                                                                              \
         _##NAME = value;                                                                                               \
         _settings.setValue(QStringLiteral(#NAME), QVariant::fromValue(value));                                         \
-        _settings.sync();                                                                                              \
         qCDebug(SETTINGSMANAGER) << QStringLiteral("Save %1 with:").arg(#NAME) << value;                               \
         emit NAME##Changed();                                                                                          \
     }                                                                                                                  \
@@ -0,0 +1,148 @@
+#include <QSettings>
+
+#include "logger.h"
+#include "settingsmanager.h"
+#include "settingsstore.h"
+
+SettingsStore::SettingsStore(const QString& organization, const QString& application)
+    : _organization(organization)
+    , _application(application)
+{
+    const QSettings settings(_organization, _application);
+    for (const auto& key : settings.allKeys()) {
+        _values.insert(key, settings.value(key));
+    }
+
+    _thread.reset(QThread::create([this] { run(); }));
+    _thread->setObjectName(QStringLiteral("SettingsStore"));
+    _thread->start(QThread::LowPriority);
+}
+
+bool SettingsStore::contains(const QString& key) const
+{
+    QMutexLocker locker(&_mutex);
+    return _values.contains(key);
+}
+
+QVariant SettingsStore::value(const QString& key, const QVariant& defaultValue) const
+{
+    QMutexLocker locker(&_mutex);
+    return _values.value(key, defaultValue);
+}
+
+void SettingsStore::setValue(const QString& key, const QVariant& value)
+{
+    QMutexLocker locker(&_mutex);
+    _values.insert(key, value);
+    _dirtyKeys.insert(key);
+    markChanged();
+}
+
+void SettingsStore::clear()
+{
+    QMutexLocker locker(&_mutex);
+    _values.clear();
+    _dirtyKeys.clear();
+    _clearRequested = true;
+    markChanged();
+}
+
+void SettingsStore::markChanged()
+{
+    if (_change == _writtenChange) {
+        _firstPendingChange.start();
+    }
+    _lastChange.start();
+    _change++;
+    _statistics.changes++;
+    _changed.wakeOne();
+}
+
+void SettingsStore::sync()
+{
+    QMutexLocker locker(&_mutex);
+    if (!_thread) {
+        return;
+    }
+
+    _syncRequested = true;
+    _changed.wakeOne();
+    while (_writtenChange != _change) {
+        _written.wait(&_mutex);
+    }
+    _syncRequested = false;
+}
+
+void SettingsStore::run()
+{
+    // QSettings is not thread safe, the worker has its own object
+    QSettings settings(_organization, _application);
+    settings.setAtomicSyncRequired(true);
+
+    QMutexLocker locker(&_mutex);
+    while (true) {
+        while (_change == _writtenChange && !_stop) {
+            _changed.wait(&_mutex);
+        }
+        if (_change == _writtenChange) {
+            break;
+        }
+
+        // Coalesce changes until they stop
+        while (!_stop && !_syncRequested) {
+            const qint64 remainingMs = std::min(
+                debounceMs - _lastChange.elapsed(), maxDelayMs - _firstPendingChange.elapsed());
+            if (remainingMs <= 0) {
+                break;
+            }
+            _changed.wait(&_mutex, remainingMs);
+        }
+
+        const quint64 change = _change;
+        const bool clear = _clearRequested;
+        QVariantMap changes;
+        for (const auto& key : qAsConst(_dirtyKeys)) {
+            changes.insert(key, _values.value(key));
+        }
+        _dirtyKeys.clear();
+        _clearRequested = false;
+        locker.unlock();
+
+        if (clear) {
+            settings.clear();
+        }
+        for (auto iterator = changes.cbegin(); iterator != changes.cend(); ++iterator) {
+            settings.setValue(iterator.key(), iterator.value());
+        }
+        settings.sync();
+        if (settings.status() != QSettings::NoError) {
+            qCWarning(SETTINGSMANAGER) << "Failed to write settings:" << settings.status();
+        }
+
+        locker.relock();
+        _writtenChange = change;
+        _statistics.writes++;
+        _statistics.writtenKeys += changes.size();
+        _written.wakeAll();
+    }
+}
+
+SettingsStore::Statistics SettingsStore::statistics() const
+{
+    QMutexLocker locker(&_mutex);
+    return _statistics;
+}
+
+SettingsStore::~SettingsStore()
+{
+    {
+        QMutexLocker locker(&_mutex);
+        _stop = true;
+        _changed.wakeOne();
+    }
+    _thread->wait();
+
+    const Statistics counters = statistics();
+    qCDebug(SETTINGSMANAGER) << "Settings written" << counters.writes << "times for" << counters.changes
+                             << "changes," << counters.changes - counters.writes << "writes avoided.";
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QThread>
+#include <QVariantMap>
+#include <QWaitCondition>
+
+#include <memory>
+
+/**
+ * @brief Settings kept in memory and written behind by a worker thread
+ *  Changes are visible immediately and the modified keys are written when changes stop for debounceMs,
+ *  or after maxDelayMs of continuous changes, so sliders and configuration bursts result in a single write.
+ *  QSettings writes the file atomically, with a temporary file that replaces the old one.
+ */
+class SettingsStore {
+public:
+    /**
+     * @brief Store counters
+     *
+     */
+    struct Statistics {
+        qint64 changes = 0;
+        qint64 writes = 0;
+        qint64 writtenKeys = 0;
+    };
+
+    // Time without changes before writing
+    static const int debounceMs = 500;
+    // Maximum time that a change waits to be written
+    static const int maxDelayMs = 2000;
+
+    /**
+     * @brief Load all settings and start the worker thread
+     *
+     * @param organization
+     * @param application
+     */
+    SettingsStore(const QString& organization, const QString& application);
+
+    /**
+     * @brief Write pending changes and stop the worker thread
+     *
+     */
+    ~SettingsStore();
+
+    /**
+     * @brief Check if the key exists
+     *
+     * @param key
+     * @return true
+     * @return false
+     */
+    bool contains(const QString& key) const;
+
+    /**
+     * @brief Return the key value
+     *
+     * @param key
+     * @param defaultValue returned if the key does not exist
+     * @return QVariant
+     */
+    QVariant value(const QString& key, const QVariant& defaultValue = {}) const;
+
+    /**
+     * @brief Change the key value, it is written later by the worker thread
+     *
+     * @param key
+     * @param value
+     */
+    void setValue(const QString& key, const QVariant& value);
+
+    /**
+     * @brief Remove all keys
+     *
+     */
+    void clear();
+
+    /**
+     * @brief Wait until all changes are written
+     *
+     */
+    void sync();
+
+    /**
+     * @brief Return the store counters
+     *  Writes avoided are changes - writes
+     *
+     * @return Statistics
+     */
+    Statistics statistics() const;
+
+private:
+    Q_DISABLE_COPY(SettingsStore)
+
+    void markChanged();
+    void run();
+
+    const QString _organization;
+    const QString _application;
+
+    mutable QMutex _mutex;
+    QWaitCondition _changed;
+    QWaitCondition _written;
+    QVariantMap _values;
+    QSet<QString> _dirtyKeys;
+    bool _clearRequested = false;
+    bool _syncRequested = false;
+    bool _stop = false;
+    // Each change has a number, used to know when it was written
+    quint64 _change = 0;
+    quint64 _writtenChange = 0;
+    QElapsedTimer _firstPendingChange;
+    QElapsedTimer _lastChange;
+    Statistics _statistics;
+
+    std::unique_ptr<QThread> _thread;
+};
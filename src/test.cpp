@@ -3,24 +3,274 @@
 
 #include <QApplication>
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
 #include <QQmlEngine>
 #include <QQuickStyle>
+#include <QRandomGenerator>
 #include <QRegularExpression>
+#include <QSemaphore>
+#include <QSerialPort>
+#include <QTemporaryDir>
+#include <QUdpSocket>
+#include <QtEndian>
+#include <QtMath>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <unistd.h>
+#endif
 
 #include "abstractlink.h"
+#include "attitudebuffer.h"
+#include "filelink.h"
 #include "filemanager.h"
+#include "intelhex.h"
 #include "linkconfiguration.h"
+#include "logeditor.h"
+#include "logfilereader.h"
+#include "logfilewriter.h"
+#include "logfixture.h"
+#include "logkeyframes.h"
+#include "loglistmodel.h"
+#include "logoverview.h"
 #include "logger.h"
+#include "logqueue.h"
+#include "mavlinkmanager.h"
 #include "ping.h"
+#include "ping1dsimulationlink.h"
+#include "processlog.h"
+#include "profilechart.h"
+#include "profilecodec.h"
+#include "renderstatistics.h"
 #include "settingsmanager.h"
+#include "stm32bootloader.h"
+#include "tracer.h"
 #include "util.h"
 #include "waterfall.h"
 
 #include "test.h"
 
 #include "ping-message-ping1d.h"
+#include "ping-message-ping360.h"
+#include "ping-parser.h"
+
+#include <mavlink_msg_attitude.h>
+
+namespace {
+/**
+ * @brief Create an Intel HEX record with its checksum
+ *
+ * @param address
+ * @param type
+ * @param data
+ * @return QByteArray
+ */
+QByteArray intelHexRecord(quint16 address, quint8 type, const QByteArray& data)
+{
+    QByteArray bytes;
+    bytes.append(static_cast<char>(data.size()));
+    bytes.append(static_cast<char>(address >> 8));
+    bytes.append(static_cast<char>(address));
+    bytes.append(static_cast<char>(type));
+    bytes.append(data);
+    quint8 sum = 0;
+    for (const char byte : qAsConst(bytes)) {
+        sum += static_cast<quint8>(byte);
+    }
+    bytes.append(static_cast<char>(-sum));
+    return ':' + bytes.toHex().toUpper() + '\n';
+}
+
+#ifdef Q_OS_UNIX
+/**
+ * @brief STM32 bootloader stand-in on the master side of a pseudo terminal
+ *
+ */
+class BootloaderStandIn {
+public:
+    static const quint32 flashAddress = 0x08000000;
+
+    BootloaderStandIn(bool checksum, int nackedWrites)
+        : memory(64 * 1024, static_cast<char>(0xFF))
+        , _checksum(checksum)
+        , _nackedWrites(nackedWrites)
+    {
+        _master = posix_openpt(O_RDWR | O_NOCTTY);
+        if (_master < 0 || grantpt(_master) || unlockpt(_master)) {
+            return;
+        }
+        slaveName = ptsname(_master);
+        _thread.reset(QThread::create([this] { run(); }));
+        _thread->start();
+    }
+
+    ~BootloaderStandIn()
+    {
+        _stop = true;
+        if (_thread) {
+            _thread->wait();
+        }
+        if (_master >= 0) {
+            close(_master);
+        }
+    }
+
+    QString slaveName;
+    QByteArray memory;
+    std::atomic<quint32> goAddress {0};
+
+private:
+    bool read(char* data, int size)
+    {
+        for (int received = 0; received < size;) {
+            pollfd descriptor {_master, POLLIN, 0};
+            if (_stop) {
+                return false;
+            }
+            if (poll(&descriptor, 1, 50) <= 0) {
+                continue;
+            }
+            const auto result = ::read(_master, data + received, size - received);
+            if (result <= 0) {
+                return false;
+            }
+            received += result;
+        }
+        return true;
+    }
+
+    void reply(const QByteArray& data)
+    {
+        const auto written = ::write(_master, data.constData(), data.size());
+        Q_UNUSED(written)
+    }
+    void reply(quint8 byte) { reply(QByteArray(1, static_cast<char>(byte))); }
+
+    bool readAddress(quint32& address)
+    {
+        char frame[5];
+        if (!read(frame, 5) || (frame[0] ^ frame[1] ^ frame[2] ^ frame[3]) != frame[4]) {
+            return false;
+        }
+        address = qFromBigEndian<quint32>(frame);
+        return true;
+    }
+
+    void run()
+    {
+        char command[2];
+        if (!read(command, 1) || static_cast<quint8>(command[0]) != Stm32Bootloader::synchronization) {
+            return;
+        }
+        reply(Stm32Bootloader::ack);
+
+        QByteArray commands("\x00\x11\x21\x31\x44", 5);
+        if (_checksum) {
+            commands.append(static_cast<char>(Stm32Bootloader::GetChecksum));
+        }
+
+        while (read(command, 2)) {
+            if (static_cast<quint8>(command[0] ^ command[1]) != 0xFF) {
+                reply(Stm32Bootloader::nack);
+                continue;
+            }
+
+            const quint8 code = command[0];
+            if (!commands.contains(command[0])) {
+                reply(Stm32Bootloader::nack);
+                continue;
+            }
+            reply(Stm32Bootloader::ack);
+
+            quint32 address = 0;
+            if (code != Stm32Bootloader::Get && code != Stm32Bootloader::ExtendedErase) {
+                if (!readAddress(address) || address < flashAddress
+                    || address >= flashAddress + static_cast<quint32>(memory.size())) {
+                    reply(Stm32Bootloader::nack);
+                    continue;
+                }
+                reply(Stm32Bootloader::ack);
+            }
+            const int offset = address - flashAddress;
+
+            switch (code) {
+            case Stm32Bootloader::Get:
+                reply(static_cast<quint8>(commands.size()));
+                reply(0x31);
+                reply(commands);
+                reply(Stm32Bootloader::ack);
+                break;
+            case Stm32Bootloader::ExtendedErase: {
+                char erase[3];
+                read(erase, 3);
+                memory.fill(static_cast<char>(0xFF));
+                reply(Stm32Bootloader::ack);
+                break;
+            }
+            case Stm32Bootloader::WriteMemory: {
+                char size;
+                read(&size, 1);
+                QByteArray data(static_cast<quint8>(size) + 2, 0);
+                read(data.data(), data.size());
+                char checksum = size;
+                for (int i = 0; i < data.size() - 1; i++) {
+                    checksum ^= data[i];
+                }
+                // Simulate data lost while the bootloader replies
+                if (checksum != data.back() || _nackedWrites-- > 0) {
+                    reply(Stm32Bootloader::nack);
+                    break;
+                }
+                memory.replace(offset, data.size() - 1, data.constData(), data.size() - 1);
+                reply(Stm32Bootloader::ack);
+                break;
+            }
+            case Stm32Bootloader::ReadMemory: {
+                char size[2];
+                read(size, 2);
+                reply(Stm32Bootloader::ack);
+                reply(memory.mid(offset, static_cast<quint8>(size[0]) + 1));
+                break;
+            }
+            case Stm32Bootloader::GetChecksum: {
+                quint32 words = 0;
+                readAddress(words);
+                reply(Stm32Bootloader::ack);
+                // The computation is acknowledged before the CRC
+                reply(Stm32Bootloader::ack);
+                QByteArray crc(4, 0);
+                qToBigEndian<quint32>(Stm32Bootloader::crc32(memory.mid(offset, words * 4)), crc.data());
+                reply(crc);
+                reply(crc[0] ^ crc[1] ^ crc[2] ^ crc[3]);
+                break;
+            }
+            case Stm32Bootloader::Go:
+                goAddress = address;
+                return;
+            }
+        }
+    }
+
+    bool _checksum;
+    int _master = -1;
+    int _nackedWrites;
+    std::atomic<bool> _stop {false};
+    std::unique_ptr<QThread> _thread;
+};
+#endif
+} // namespace
 
 void Test::initTestCase()
 {
@@ -29,6 +279,72 @@ void Test::initTestCase()
     SettingsManager::self();
 }
 
+void Test::attitudeBuffer()
+{
+    AttitudeBuffer buffer;
+    float yaw;
+    QVERIFY2(!buffer.yawAt(0, yaw), qPrintable("Empty buffer returned a heading."));
+
+    buffer.append(1000, 0.0f);
+    buffer.append(2000, 1.0f);
+    QVERIFY2(buffer.yawAt(1500, yaw) && qFuzzyCompare(yaw, 0.5f), qPrintable("Heading was not interpolated."));
+    QVERIFY2(buffer.yawAt(500, yaw) && qFuzzyIsNull(yaw), qPrintable("Old time did not use first sample."));
+    QVERIFY2(buffer.yawAt(5000, yaw) && qFuzzyCompare(yaw, 1.0f), qPrintable("New time did not use last sample."));
+
+    // Interpolation goes through the shortest way around the circle
+    buffer.append(3000, M_PI - 0.1f);
+    buffer.append(4000, -M_PI + 0.1f);
+    QVERIFY2(buffer.yawAt(3500, yaw) && qAbs(qAbs(yaw) - M_PI) < 1e-3,
+        qPrintable(QString("Heading did not wrap around: %1").arg(yaw)));
+
+    // Only the most recent samples are kept
+    for (int i {0}; i < AttitudeBuffer::capacity * 2; i++) {
+        buffer.append(10000 + i, i);
+    }
+    QVERIFY2(buffer.yawAt(0, yaw) && qFuzzyCompare(yaw, static_cast<float>(AttitudeBuffer::capacity)),
+        qPrintable(QString("Oldest sample is wrong: %1").arg(yaw)));
+
+    buffer.clear();
+    QVERIFY2(!buffer.yawAt(20000, yaw), qPrintable("Cleared buffer returned a heading."));
+}
+
+void Test::fileLink()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable("Failed to create temporary directory."));
+    LogSensorStruct header;
+    header.init();
+    LogFileWriter writer;
+    const QString fileName = dir.filePath(QStringLiteral("flow.bin"));
+    QVERIFY2(writer.open(fileName, header), qPrintable("Failed to create log."));
+    const int numberOfRecords = 100;
+    for (int i = 0; i < numberOfRecords; i++) {
+        writer.append(i * 1000000ll, QByteArray(8, static_cast<char>(i)));
+    }
+    writer.close();
+
+    FileLink link;
+    QVERIFY2(link.setConfiguration({LinkType::File, {fileName, "r"}, "Replay"}), qPrintable("Failed to open log."));
+    link.setFlowControl(true);
+    int received = 0;
+    connect(&link, &AbstractLink::newData, this, [&received](const QByteArray&) { received++; });
+    QVERIFY2(link.startConnection(), qPrintable("Failed to start replay."));
+    link._processLog->setSpeed(0);
+
+    // The replay stops when the consumer does not report the handled packages
+    QTRY_VERIFY_WITH_TIMEOUT(received == ProcessLog::maxPackagesInFlight, 5000);
+    QTest::qWait(100);
+    QVERIFY2(received == ProcessLog::maxPackagesInFlight,
+        qPrintable(QString("Replay did not wait for the consumer: %1 packages.").arg(received)));
+
+    for (int consumed = 0; consumed < numberOfRecords; consumed++) {
+        QTRY_VERIFY_WITH_TIMEOUT(received > consumed, 5000);
+        link.dataConsumed();
+    }
+    QVERIFY2(received == numberOfRecords, qPrintable(QString("Replay sent %1 packages.").arg(received)));
+    link.finishConnection();
+}
+
 void Test::fileManager()
 {
     auto fileManager = FileManager::self();
@@ -72,6 +388,311 @@ void Test::fileManager()
     // TODO: Populate gradients folder and test FileManager.getFilesFrom
 }
 
+void Test::intelHex()
+{
+    QByteArray first(16, 0);
+    QByteArray second(16, 0);
+    for (int i {0}; i < first.size(); i++) {
+        first[i] = static_cast<char>(i);
+        second[i] = static_cast<char>(i + first.size());
+    }
+
+    // Records out of order with contiguous data
+    const QByteArray content = intelHexRecord(0, 0x04, QByteArray("\x08\x00", 2))
+        + intelHexRecord(0x0100, 0x00, QByteArray("\xAA\xBB\xCC", 3)) + intelHexRecord(0x0010, 0x00, second)
+        + intelHexRecord(0x0000, 0x00, first) + intelHexRecord(0x0000, 0x05, QByteArray(4, 0))
+        + intelHexRecord(0, 0x01, {});
+
+    IntelHex image;
+    QVERIFY2(image.parse(content), qPrintable("Valid file was refused."));
+    QVERIFY2(image.segments().size() == 2,
+        qPrintable(QString("Wrong number of segments: %1").arg(image.segments().size())));
+    QVERIFY2(image.segments()[0].address == 0x08000000 && image.segments()[0].data == first + second,
+        qPrintable("Contiguous records were not merged."));
+    QVERIFY2(image.segments()[1].address == 0x08000100, qPrintable("Extended linear address was not used."));
+    QVERIFY2(image.size() == 35, qPrintable(QString("Wrong image size: %1").arg(image.size())));
+
+    const QByteArray segmentAddress
+        = intelHexRecord(0, 0x02, QByteArray("\x10\x00", 2)) + intelHexRecord(0x0004, 0x00, first);
+    QVERIFY2(image.parse(segmentAddress) && image.segments()[0].address == 0x10004,
+        qPrintable("Extended segment address was not used."));
+
+    QByteArray wrongChecksum = intelHexRecord(0x0000, 0x00, first);
+    wrongChecksum[wrongChecksum.size() - 2] = wrongChecksum[wrongChecksum.size() - 2] == '0' ? '1' : '0';
+    QVERIFY2(!image.parse(wrongChecksum), qPrintable("Record with wrong checksum was accepted."));
+    QVERIFY2(!image.parse(intelHexRecord(0x0000, 0x00, first) + intelHexRecord(0x0008, 0x00, first)),
+        qPrintable("Overlapping records were accepted."));
+    QVERIFY2(!image.parse(":00000001FF\n"), qPrintable("File without data was accepted."));
+    QVERIFY2(!image.parse(":0400000001020304\n"), qPrintable("Record with wrong size was accepted."));
+}
+
+void Test::logEditor()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable("Failed to create temporary directory."));
+
+    // Two logs of ten seconds, both with timestamps starting from zero
+    LogSensorStruct logSensorStruct;
+    logSensorStruct.init();
+    const int numberOfRecords = 100;
+    QStringList inputs;
+    for (int log = 0; log < 2; log++) {
+        inputs.append(dir.filePath(QStringLiteral("input%1.bin").arg(log)));
+        LogFileWriter writer;
+        QVERIFY2(writer.open(inputs.last(), logSensorStruct), qPrintable("Failed to create log."));
+        for (int i = 0; i < numberOfRecords; i++) {
+            writer.append(qint64(i) * 100 * 1000 * 1000, QStringLiteral("%1:%2").arg(log).arg(i).toLatin1());
+        }
+        writer.close();
+    }
+
+    struct Log {
+        QFile file;
+        LogFileReader reader;
+    };
+    const auto openLog = [](Log& log, const QString& fileName) {
+        log.file.setFileName(fileName);
+        if (!log.file.open(QIODevice::ReadOnly)) {
+            return false;
+        }
+        QDataStream stream(&log.file);
+        LogSensorStruct readLogSensorStruct;
+        stream >> readLogSensorStruct;
+        return readLogSensorStruct.isValid()
+            && log.reader.open(fileName, log.file.pos(), readLogSensorStruct.version);
+    };
+
+    // Concatenated records keep their order and timestamps keep increasing,
+    // the index is removed to check the timestamps stored in the records
+    const QString concatenated = dir.filePath(QStringLiteral("concatenated.bin"));
+    QVERIFY2(LogEditor::concatenate(inputs, concatenated), qPrintable("Failed to concatenate logs."));
+    QFile::remove(LogIndex::sidecarFileName(concatenated));
+    {
+        Log log;
+        QVERIFY2(openLog(log, concatenated), qPrintable("Failed to read concatenated log."));
+        QVERIFY2(log.reader.size() == 2 * numberOfRecords,
+            qPrintable(QString("Wrong number of records: %1").arg(log.reader.size())));
+        for (int i = 0; i < log.reader.size(); i++) {
+            const QString expected = QStringLiteral("%1:%2").arg(i / numberOfRecords).arg(i % numberOfRecords);
+            QVERIFY2(log.reader.data(i) == expected.toLatin1(), qPrintable(QString("Wrong record %1").arg(i)));
+            QVERIFY2(i == 0 || log.reader.timestampNs(i) > log.reader.timestampNs(i - 1),
+                qPrintable(QString("Timestamp goes back at record %1").arg(i)));
+        }
+    }
+
+    // v1 logs store the time of the day, the second log overlaps the first one and is moved after it
+    logSensorStruct.version = 1;
+    QStringList v1Inputs;
+    for (int log = 0; log < 2; log++) {
+        v1Inputs.append(dir.filePath(QStringLiteral("input%1_v1.bin").arg(log)));
+        LogFileWriter writer;
+        QVERIFY2(writer.open(v1Inputs.last(), logSensorStruct), qPrintable("Failed to create log."));
+        for (int i = 0; i < numberOfRecords; i++) {
+            writer.append(qint64(i) * 100 * 1000 * 1000, QStringLiteral("%1:%2").arg(log).arg(i).toLatin1());
+        }
+        writer.close();
+    }
+    const QString v1Concatenated = dir.filePath(QStringLiteral("concatenated_v1.bin"));
+    QVERIFY2(LogEditor::concatenate(v1Inputs, v1Concatenated), qPrintable("Failed to concatenate v1 logs."));
+    QFile::remove(LogIndex::sidecarFileName(v1Concatenated));
+    {
+        Log log;
+        QVERIFY2(openLog(log, v1Concatenated), qPrintable("Failed to read concatenated v1 log."));
+        QVERIFY2(log.reader.size() == 2 * numberOfRecords,
+            qPrintable(QString("Wrong number of v1 records: %1").arg(log.reader.size())));
+        for (int i = 1; i < log.reader.size(); i++) {
+            QVERIFY2(log.reader.timestampNs(i) > log.reader.timestampNs(i - 1),
+                qPrintable(QString("v1 timestamp goes back at record %1").arg(i)));
+        }
+    }
+
+    // The range is extended to complete chunks
+    const QString extracted = dir.filePath(QStringLiteral("extracted.bin"));
+    const qint64 second = 1000 * 1000 * 1000;
+    QVERIFY2(LogEditor::extract(inputs.first(), extracted, 2 * second, 5 * second),
+        qPrintable("Failed to extract range."));
+    {
+        Log log;
+        QVERIFY2(openLog(log, extracted), qPrintable("Failed to read extracted log."));
+        QVERIFY2(log.reader.size() > 30 && log.reader.size() < numberOfRecords,
+            qPrintable(QString("Wrong number of records: %1").arg(log.reader.size())));
+        QVERIFY2(log.reader.timestampNs(0) <= 2 * second
+                && log.reader.timestampNs(log.reader.size() - 1) >= 5 * second,
+            qPrintable("Extracted log does not cover the range."));
+    }
+
+    // Parts have all the records of the original log
+    const QStringList parts = LogEditor::split(concatenated, dir.filePath(QStringLiteral("part.bin")), 0, 3 * second);
+    QVERIFY2(parts.size() >= 6, qPrintable(QString("Wrong number of parts: %1").arg(parts.size())));
+    int splitRecords = 0;
+    for (const auto& part : parts) {
+        Log log;
+        QVERIFY2(openLog(log, part), qPrintable("Failed to read part."));
+        splitRecords += log.reader.size();
+    }
+    QVERIFY2(splitRecords == 2 * numberOfRecords, qPrintable(QString("Records lost in parts: %1").arg(splitRecords)));
+}
+
+void Test::logKeyframes()
+{
+    // Ping360 sweep with 2 gradians steps, some messages are split between two packages
+    LogFixture fixture;
+    QVERIFY2(fixture.create(QStringLiteral("keyframes.bin")), qPrintable("Failed to create log."));
+    const int numberOfSamples = 200;
+    const int numberOfMessages = 3000;
+    ping360_device_data deviceData(numberOfSamples);
+    deviceData.set_number_of_samples(numberOfSamples);
+    deviceData.set_data_length(numberOfSamples);
+    int numberOfPackages = 0;
+    for (int i = 0; i < numberOfMessages; i++) {
+        deviceData.set_angle((i * 2) % LogKeyframes::ping360Angles);
+        deviceData.updateChecksum();
+        const QByteArray message(reinterpret_cast<const char*>(deviceData.msgData), deviceData.msgDataLength());
+        if (i % 10) {
+            fixture.writer.append(numberOfPackages++, message);
+        } else {
+            fixture.writer.append(numberOfPackages++, message.left(100));
+            fixture.writer.append(numberOfPackages++, message.mid(100));
+        }
+    }
+    QVERIFY2(fixture.open(), qPrintable("Failed to read log."));
+
+    LogKeyframes keyframes;
+    keyframes.build(fixture.fileName, &fixture.reader);
+    QTRY_VERIFY_WITH_TIMEOUT(keyframes.isReady(), 10000);
+    QVERIFY2(QFile::exists(LogKeyframes::sidecarFileName(fixture.fileName)), qPrintable("Keyframes were not cached."));
+
+    // The next session uses the cached keyframes without a new pass
+    LogKeyframes cachedKeyframes;
+    cachedKeyframes.build(fixture.fileName, &fixture.reader);
+    QVERIFY2(cachedKeyframes.isReady(), qPrintable("Cached keyframes were not loaded."));
+
+    for (const LogKeyframes* restored : {&keyframes, &cachedKeyframes}) {
+        for (const int index : {1500, 2049, numberOfPackages - 1}) {
+            const QByteArray snapshot = restored->snapshotForIndex(index);
+            const QVector<int> packages = restored->packagesForIndex(index);
+            QVERIFY2(!snapshot.isEmpty(), qPrintable(QString("No snapshot at %1").arg(index)));
+
+            // A complete sweep, with the snapshot and the newest profile of each angle after it
+            PingParser parser(10240);
+            QSet<int> angles;
+            auto parse = [&parser, &angles](const QByteArray& data) {
+                for (const auto byte : data) {
+                    if (parser.parseByte(byte) == PingParser::ParseState::NEW_MESSAGE) {
+                        angles.insert(static_cast<ping360_device_data*>(&parser.rxMessage)->angle());
+                    }
+                }
+            };
+            parse(snapshot);
+            for (const int package : packages) {
+                QVERIFY2(package < index, qPrintable("Restored package is after the seek position."));
+                parse(fixture.reader.data(package));
+            }
+            QVERIFY2(angles.size() == LogKeyframes::ping360Angles / 2,
+                qPrintable(QString("Incomplete sweep at %1: %2 angles").arg(index).arg(angles.size())));
+            QVERIFY2(packages.size() <= index % LogKeyframes::keyframeInterval + 1,
+                qPrintable(QString("Too many packages to restore: %1").arg(packages.size())));
+        }
+    }
+}
+
+void Test::logListModel()
+{
+    // Messages of two categories, more than the model can keep
+    LogListModel model;
+    model.start();
+    model.filter(0b01);
+    const int numberOfMessages = LogListModel::capacity + 100;
+    for (int i = 0; i < numberOfMessages; i++) {
+        emit model.append(QString::number(i), QStringLiteral("Message %1").arg(i), Qt::gray, i % 2 ? 0b10 : 0b01);
+    }
+    QVERIFY2(model.rowCount() == LogListModel::capacity / 2,
+        qPrintable(QString("Wrong number of rows: %1").arg(model.rowCount())));
+    QVERIFY2(model.data(model.index(0), LogListModel::Time).toString() == QStringLiteral("100"),
+        qPrintable("Oldest messages were not removed."));
+
+    model.filter(0b11);
+    QVERIFY2(model.rowCount() == LogListModel::capacity, qPrintable("Filter does not show all categories."));
+    QVERIFY2(model.data(model.index(model.rowCount() - 1), LogListModel::Display).toString()
+            == QStringLiteral("Message %1").arg(numberOfMessages - 1),
+        qPrintable("Last message is not the newest."));
+}
+
+void Test::logOverview()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable("Failed to create temporary directory."));
+
+    // Five seconds of Ping1D profiles, the bottom is lost in the last two
+    const QString fileName = dir.filePath(QStringLiteral("overview.bin"));
+    LogSensorStruct logSensorStruct;
+    logSensorStruct.init();
+    LogFileWriter writer;
+    QVERIFY2(writer.open(fileName, logSensorStruct), qPrintable("Failed to create log."));
+    ping1d_profile profile(200);
+    profile.set_profile_data_length(200);
+    for (int i = 0; i < 50; i++) {
+        const int second = i / 10;
+        profile.set_distance(1000 + second * 100);
+        profile.set_confidence(second < 3 ? 100 : 20);
+        profile.updateChecksum();
+        writer.append(i * 100 * 1000 * 1000,
+            QByteArray(reinterpret_cast<const char*>(profile.msgData), profile.msgDataLength()));
+    }
+    writer.close();
+
+    QFile file(fileName);
+    QVERIFY2(file.open(QIODevice::ReadOnly), qPrintable("Failed to open log."));
+    QDataStream stream(&file);
+    LogSensorStruct readLogSensorStruct;
+    stream >> readLogSensorStruct;
+    LogFileReader reader;
+    QVERIFY2(reader.open(fileName, file.pos(), readLogSensorStruct.version), qPrintable("Failed to read log."));
+
+    // Built in background the first time, loaded from the cache after it
+    for (int pass = 0; pass < 2; pass++) {
+        LogOverview overview;
+        overview.build(fileName, &reader);
+        QTRY_VERIFY_WITH_TIMEOUT(overview.isReady(), 5000);
+        QVERIFY2(QFile::exists(LogOverview::sidecarFileName(fileName)), qPrintable("Overview was not cached."));
+        QVERIFY2(overview.bins().size() == 5 && overview.thumbnail().width() == 5,
+            qPrintable(QString("Wrong number of seconds: %1").arg(overview.bins().size())));
+        QVERIFY2(overview.bins()[2].meanDistance == 1200 && overview.bins()[2].profiles == 10,
+            qPrintable(QString("Wrong statistics: %1").arg(overview.bins()[2].meanDistance)));
+        QVERIFY2(overview.lowConfidenceSeconds(50) == QVector<int>({3, 4}),
+            qPrintable("Wrong low confidence seconds."));
+    }
+}
+
+void Test::logQueue()
+{
+    // Every accepted value of the producers is received once by the consumer
+    LogQueue<int> queue(1024);
+    std::atomic<int> pushed {0};
+    std::atomic<bool> producing {true};
+    QVector<QThread*> producers;
+    for (int producer = 0; producer < 4; producer++) {
+        producers.append(QThread::create([&queue, &pushed] {
+            for (int i = 0; i < 10000; i++) {
+                int value = i;
+                pushed += queue.push(std::move(value));
+            }
+        }));
+        producers.last()->start();
+    }
+    int popped = 0;
+    int value;
+    while (producing || !queue.isEmpty()) {
+        producing = std::any_of(
+            producers.cbegin(), producers.cend(), [](QThread* thread) { return thread->isRunning(); });
+        while (queue.pop(value)) {
+            popped++;
+        }
+    }
+    qDeleteAll(producers);
+    QVERIFY2(popped == pushed, qPrintable(QString("Queue lost values: %1 of %2").arg(popped).arg(pushed.load())));
+}
+
 void Test::logger()
 {
     auto logger = Logger::self();
@@ -83,6 +704,304 @@ void Test::logger()
     QVERIFY2(!logger->isEmpty(), qPrintable("Log file is empty."));
 }
 
+void Test::mavlinkManager()
+{
+    auto manager = MavlinkManager::self();
+    auto encode = [](const mavlink_message_t& message) {
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        const auto length = mavlink_msg_to_send_buffer(buffer, &message);
+        return QByteArray(reinterpret_cast<const char*>(buffer), length);
+    };
+
+    mavlink_message_t message;
+    mavlink_msg_attitude_pack(1, 1, &message, 0, 0.1f, 0.2f, 0.3f, 0, 0, 0);
+    const QByteArray attitude = encode(message);
+    // Heartbeat has no CRC information in the manager, it is only counted
+    mavlink_msg_heartbeat_pack(
+        1, 1, &message, MAV_TYPE_SUBMARINE, MAV_AUTOPILOT_ARDUPILOTMEGA, 0, 0, MAV_STATE_ACTIVE);
+    const QByteArray heartbeat = encode(message);
+
+    manager->_messageCounters.clear();
+
+    // Subscribed messages are delivered, also when split between calls
+    QObject context;
+    int received = 0;
+    float yaw = 0;
+    manager->subscribe(MAVLINK_MSG_ID_ATTITUDE, &context, [&](const mavlink_message_t& message) {
+        received++;
+        yaw = mavlink_msg_attitude_get_yaw(&message);
+    });
+    manager->parseData(attitude + heartbeat + attitude.left(5));
+    manager->parseData(attitude.mid(5));
+    QVERIFY2(received == 2 && qFuzzyCompare(yaw, 0.3f),
+        qPrintable(QString("Subscriber received %1 of 2 messages, yaw %2.").arg(received).arg(yaw)));
+
+    // A new subscription of the same context replaces the previous one
+    int replaced = 0;
+    manager->subscribe(MAVLINK_MSG_ID_ATTITUDE, &context, [&replaced](const mavlink_message_t&) { replaced++; });
+    manager->parseData(attitude);
+    QVERIFY2(received == 2 && replaced == 1, qPrintable("Subscription was not replaced."));
+
+    manager->unsubscribe(MAVLINK_MSG_ID_ATTITUDE, &context);
+    manager->parseData(attitude);
+    QVERIFY2(replaced == 1, qPrintable("Handler called after unsubscribe."));
+    QVERIFY2(!manager->_subscribers.contains(MAVLINK_MSG_ID_ATTITUDE), qPrintable("Empty subscription was kept."));
+
+    // Handlers of destroyed contexts are not called and their subscriptions are removed
+    {
+        QObject temporary;
+        manager->subscribe(MAVLINK_MSG_ID_ATTITUDE, &temporary, [&received](const mavlink_message_t&) { received++; });
+    }
+    manager->parseData(attitude);
+    QVERIFY2(received == 2, qPrintable("Handler called after its context was destroyed."));
+    QVERIFY2(!manager->_subscribers.contains(MAVLINK_MSG_ID_ATTITUDE),
+        qPrintable("Subscription of a destroyed context was kept."));
+
+    // Rates count every framed message, with or without subscribers and CRC information
+    QThread::msleep(10);
+    manager->updateMessageRates();
+    const auto rates = manager->messageRates();
+    const float attitudeRate = rates.value(QString::number(MAVLINK_MSG_ID_ATTITUDE)).toFloat();
+    const float heartbeatRate = rates.value(QString::number(MAVLINK_MSG_ID_HEARTBEAT)).toFloat();
+    QVERIFY2(heartbeatRate > 0 && qFuzzyCompare(attitudeRate, 5 * heartbeatRate),
+        qPrintable(QString("Wrong message rates, attitude %1 and heartbeat %2.").arg(attitudeRate).arg(heartbeatRate)));
+    QVERIFY2(manager->_messageCounters.isEmpty(), qPrintable("Counters were not restarted."));
+}
+
+void Test::processLog()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable("Failed to create temporary directory."));
+
+    // One second of log with a package every 5 ms
+    const QString fileName = dir.filePath(QStringLiteral("replay.bin"));
+    const int numberOfRecords = 201;
+    const qint64 periodNs = 5 * 1000 * 1000;
+    LogSensorStruct logSensorStruct;
+    logSensorStruct.init();
+    LogFileWriter writer;
+    QVERIFY2(writer.open(fileName, logSensorStruct), qPrintable("Failed to create log."));
+    for (int i = 0; i < numberOfRecords; i++) {
+        writer.append(i * periodNs, QByteArray(64, static_cast<char>(i)));
+    }
+    writer.close();
+
+    QFile file(fileName);
+    QVERIFY2(file.open(QIODevice::ReadOnly), qPrintable("Failed to open log."));
+    QDataStream stream(&file);
+    LogSensorStruct readLogSensorStruct;
+    stream >> readLogSensorStruct;
+    LogFileReader reader;
+    QVERIFY2(reader.open(fileName, file.pos(), readLogSensorStruct.version), qPrintable("Failed to read log."));
+
+    for (const float speed : {4.0f, 8.0f, 0.0f}) {
+        ProcessLog processLog;
+        processLog.setReader(&reader);
+        processLog.setSpeed(speed);
+
+        // Packages are handled in the replay thread, the main event loop latency would hide the schedule
+        std::atomic<int> packages {0};
+        bool ordered = true;
+        QVector<qint64> arrivalNs;
+        arrivalNs.reserve(numberOfRecords);
+        QElapsedTimer timer;
+        connect(
+            &processLog, &ProcessLog::newPackage, this,
+            [&](const QByteArray& data) {
+                // Arrival time relative to the first package, the schedule is anchored on it
+                if (arrivalNs.isEmpty()) {
+                    timer.start();
+                }
+                arrivalNs.append(timer.nsecsElapsed());
+                ordered &= data.at(0) == static_cast<char>(packages.load());
+                packages++;
+                processLog.packageConsumed();
+            },
+            Qt::DirectConnection);
+
+        std::unique_ptr<QThread> thread(QThread::create([&processLog] { processLog.run(); }));
+        thread->start();
+        QTRY_VERIFY_WITH_TIMEOUT(packages == numberOfRecords, 5000);
+        processLog.stop();
+        thread->wait();
+
+        QVERIFY2(ordered, qPrintable(QString("Replay at %1x delivered packages out of order.").arg(speed)));
+
+        if (speed > 0) {
+            // Each package has an absolute deadline, errors do not accumulate along the log
+            QVector<qint64> errorsNs;
+            errorsNs.reserve(arrivalNs.size());
+            for (int i = 0; i < arrivalNs.size(); i++) {
+                errorsNs.append(qAbs(arrivalNs[i] - static_cast<qint64>(i * periodNs / speed)));
+            }
+            std::sort(errorsNs.begin(), errorsNs.end());
+            const qint64 typicalErrorNs = errorsNs[errorsNs.size() * 95 / 100];
+            const qint64 worstErrorNs = errorsNs.last();
+
+            // Most packages must hit the deadline within a scheduler tick, a few may be delayed by a loaded machine
+            const qint64 typicalToleranceNs = 2 * 1000 * 1000;
+            const qint64 worstToleranceNs = 20 * 1000 * 1000;
+            QVERIFY2(typicalErrorNs < typicalToleranceNs && worstErrorNs < worstToleranceNs,
+                qPrintable(QString("Replay at %1x missed the deadlines by %2 us (95th percentile) and %3 us (worst).")
+                               .arg(speed)
+                               .arg(typicalErrorNs / 1000)
+                               .arg(worstErrorNs / 1000)));
+        }
+    }
+}
+
+void Test::profileChart()
+{
+    // A narrow echo in a long profile, from 0 to 10 meters
+    QVector<float> points(20000, 0.1f);
+    points[12345] = 1;
+    QVector<float> rowMinimums(100);
+    QVector<float> rowMaximums(100);
+
+    // Zoomed out, 200 samples per row
+    ProfileChart::decimate(points, 0, 10, 0, 10, rowMinimums, rowMaximums);
+    QVERIFY2(rowMaximums[12345 / 200] == 1, qPrintable("Echo was lost in the decimation."));
+    QVERIFY2(rowMinimums[12345 / 200] == 0.1f, qPrintable("Row minimum was not kept."));
+    for (int row = 0; row < rowMaximums.size(); row++) {
+        if (row != 12345 / 200) {
+            QVERIFY2(rowMaximums[row] == 0.1f, qPrintable(QString("Wrong maximum in row %1.").arg(row)));
+        }
+    }
+
+    // Zoomed in, each sample is in a few rows
+    ProfileChart::decimate(points, 0, 10, 6.17, 6.18, rowMinimums, rowMaximums);
+    QVERIFY2(std::count(rowMaximums.cbegin(), rowMaximums.cend(), 1.0f) >= 2,
+        qPrintable("Echo was lost when zoomed in."));
+
+    // The profile ends in the middle of the chart
+    ProfileChart::decimate(points, 0, 10, 0, 20, rowMinimums, rowMaximums);
+    QVERIFY2(rowMaximums[25] == 0.1f && rowMaximums[75] == 0 && rowMinimums[49] == 0.1f,
+        qPrintable("Rows outside of the profile are not empty."));
+
+    // Statistics are only published while they are shown
+    ProfileChart chart;
+    QVERIFY2(!chart._renderStatisticsTimer.isActive(), qPrintable("Render statistics published while hidden."));
+    chart.setRenderStatisticsEnabled(true);
+    QVERIFY2(chart._renderStatisticsTimer.isActive(), qPrintable("Render statistics were not enabled."));
+    chart.setRenderStatisticsEnabled(false);
+    QVERIFY2(!chart._renderStatisticsTimer.isActive() && chart.renderStatistics().isEmpty(),
+        qPrintable("Render statistics were not disabled."));
+}
+
+void Test::profileCodec()
+{
+    // Simulated profile: noise floor, a smooth target and a flat tail
+    const int numberOfSamples = 1200;
+    ping360_device_data deviceData(numberOfSamples);
+    deviceData.set_angle(42);
+    deviceData.set_number_of_samples(numberOfSamples);
+    deviceData.set_data_length(numberOfSamples);
+    for (int i = 0; i < numberOfSamples; i++) {
+        int point = i < 500 ? (i * 7) % 13 : i < 700 ? 255 * qSin((i - 500) * M_PI / 200) : 20;
+        deviceData.set_data_at(i, point);
+    }
+    deviceData.updateChecksum();
+    const QByteArray message(reinterpret_cast<const char*>(deviceData.msgData), deviceData.msgDataLength());
+
+    for (auto level : {ProfileCodec::Level::Lossless, ProfileCodec::Level::Quantized, ProfileCodec::Level::Decimated}) {
+        const QByteArray encoded = ProfileCodec::encode(message, level);
+        const QByteArray decoded = ProfileCodec::decode(encoded);
+
+        QVERIFY2(ProfileCodec::isEncoded(encoded), qPrintable("Profile was not encoded."));
+        QVERIFY2(encoded.size() < message.size(),
+            qPrintable(QString("Encoded profile is not smaller: %1 >= %2").arg(encoded.size()).arg(message.size())));
+        QVERIFY2(decoded.size() == message.size(),
+            qPrintable(QString("Decoded profile size does not match: %1").arg(decoded.size())));
+        if (level == ProfileCodec::Level::Lossless) {
+            QVERIFY2(decoded == message, qPrintable("Lossless decoding does not match original message."));
+        }
+
+        // Decoded message should be valid for the parser
+        PingParser parser(10240);
+        int parsedMessages = 0;
+        for (const auto byte : decoded) {
+            parsedMessages += parser.parseByte(byte) == PingParser::ParseState::NEW_MESSAGE;
+        }
+        QVERIFY2(parsedMessages == 1, qPrintable("Decoded message is not valid."));
+    }
+
+    // The level follows the measured ratios and the link throughput
+    ProfileEncoder encoder;
+    QVERIFY2(ProfileCodec::decode(encoder.encode(message)) == message,
+        qPrintable("Encoder without link throughput is not lossless."));
+    const std::array<float, 4> ratios {1, encoder.ratio(ProfileCodec::Level::Lossless),
+        encoder.ratio(ProfileCodec::Level::Quantized), encoder.ratio(ProfileCodec::Level::Decimated)};
+    QVERIFY2(ratios[1] > 1 && ratios[2] > ratios[1] && ratios[3] > ratios[2],
+        qPrintable(QString("Wrong measured ratios: %1 %2 %3").arg(ratios[1]).arg(ratios[2]).arg(ratios[3])));
+    const float rawRate = 10000;
+    const float headroom = 1.25f;
+    QVERIFY2(ProfileCodec::levelForThroughput(rawRate * headroom / ratios[1] * 1.001f, rawRate, ratios)
+            == ProfileCodec::Level::Lossless,
+        qPrintable("Lossless level was not used when it fits in the link."));
+    QVERIFY2(ProfileCodec::levelForThroughput(rawRate * headroom / ratios[2] * 1.001f, rawRate, ratios)
+            == ProfileCodec::Level::Quantized,
+        qPrintable("Quantized level was not used when it fits in the link."));
+    QVERIFY2(ProfileCodec::levelForThroughput(rawRate / 100, rawRate, ratios) == ProfileCodec::Level::Decimated,
+        qPrintable("Decimated level was not used for a slow link."));
+
+    // Forwarded profiles arrive as encoded datagrams
+    QUdpSocket receiver;
+    QVERIFY2(receiver.bind(QHostAddress::LocalHost), qPrintable("Failed to bind receiver."));
+    QUdpSocket sender;
+    sender.connectToHost(QHostAddress::LocalHost, receiver.localPort());
+    QVERIFY2(sender.waitForConnected(1000), qPrintable("Failed to connect sender."));
+    ProfileEncoder forwardEncoder;
+    forwardEncoder.setDevice(&sender);
+    QVERIFY2(forwardEncoder.write(message), qPrintable("Failed to forward profile."));
+    QVERIFY2(receiver.waitForReadyRead(1000), qPrintable("Forwarded profile did not arrive."));
+    QByteArray datagram(receiver.pendingDatagramSize(), Qt::Uninitialized);
+    receiver.readDatagram(datagram.data(), datagram.size());
+    QVERIFY2(ProfileCodec::isEncoded(datagram) && ProfileCodec::decode(datagram) == message,
+        qPrintable("Forwarded profile does not match original message."));
+
+    // Everything else should pass without changes
+    const QByteArray notEncoded("BR not a profile");
+    QVERIFY2(ProfileCodec::decode(notEncoded) == notEncoded, qPrintable("Raw data was changed by decoder."));
+}
+
+void Test::renderStatistics()
+{
+    RenderStatistics statistics(10);
+
+    // Profiles that arrive before a frame are merged in it
+    for (int i = 0; i < 3; i++) {
+        statistics.profileIngested();
+    }
+    statistics.frameStarted();
+    statistics.frameFinished(1000);
+
+    // Repaints without profiles do not count in the pacing
+    statistics.frameStarted();
+    statistics.frameFinished(1000);
+
+    // A profile that waits four periods to be painted
+    statistics.profileIngested();
+    QTest::qSleep(40);
+    statistics.frameStarted();
+    statistics.frameFinished(1000);
+
+    QVariantMap summary = statistics.takeSummary();
+    QVERIFY2(summary["profiles"].toInt() == 4, qPrintable("Wrong number of profiles."));
+    QVERIFY2(summary["maxProfilesPerFrame"].toInt() == 3, qPrintable("Wrong number of profiles per frame."));
+    QVERIFY2(summary["mergedProfiles"].toInt() == 2, qPrintable("Wrong number of merged profiles."));
+    QVERIFY2(summary["lateFrames"].toInt() == 1, qPrintable("Late frame was not detected."));
+    QVERIFY2(summary["skippedFrames"].toInt() >= 2,
+        qPrintable(QString("Wrong number of skipped frames: %1").arg(summary["skippedFrames"].toInt())));
+    QVERIFY2(summary["delayMaxMs"].toDouble() >= 40, qPrintable("Frame delay was not measured."));
+    QVERIFY2(summary["fps"].toDouble() > 0, qPrintable("Frame rate was not measured."));
+    QVERIFY2(summary["uploadKiBps"].toDouble() > 0, qPrintable("Uploaded data was not measured."));
+
+    // Each summary starts a new window
+    summary = statistics.takeSummary();
+    QVERIFY2(summary["profiles"].toInt() == 0 && summary["lateFrames"].toInt() == 0,
+        qPrintable("Summary window was not restarted."));
+}
+
 void Test::ringVector()
 {
     // Create RingVector
@@ -104,6 +1023,172 @@ void Test::ringVector()
     }
 }
 
+void Test::sensorLog()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable("Failed to create temporary directory."));
+
+    // Ping360 sized profiles, 20 ms apart, with noise floor and a moving target
+    const int numberOfRecords = 20000;
+    const qint64 periodNs = 20 * 1000 * 1000;
+    QVector<QByteArray> records;
+    for (int i = 0; i < 16; i++) {
+        QByteArray record(1220, Qt::Uninitialized);
+        for (int sample = 0; sample < record.size(); sample++) {
+            const int target = qAbs(sample - 500 - 10 * i) < 40 ? 200 : 0;
+            record[sample] = static_cast<char>(target + QRandomGenerator::global()->bounded(30));
+        }
+        records.append(record);
+    }
+
+    struct Configuration {
+        uint version;
+        bool compression;
+    };
+    qint64 v1Size = 0;
+    for (const auto& configuration : {Configuration {1, false}, Configuration {2, false}, Configuration {2, true}}) {
+        const QString fileName = dir.filePath(
+            QStringLiteral("log_v%1_%2.bin").arg(configuration.version).arg(configuration.compression));
+        LogSensorStruct logSensorStruct;
+        logSensorStruct.init();
+        logSensorStruct.version = configuration.version;
+
+        QElapsedTimer timer;
+        timer.start();
+        LogFileWriter writer;
+        writer.setCompression(configuration.compression);
+        QVERIFY2(writer.open(fileName, logSensorStruct), qPrintable("Failed to create log."));
+        for (int i = 0; i < numberOfRecords; i++) {
+            writer.append(i * periodNs, records[i % records.size()]);
+        }
+        writer.close();
+        const qint64 writeNs = timer.nsecsElapsed();
+
+        // Remove the index to measure the full parse
+        QFile::remove(LogIndex::sidecarFileName(fileName));
+
+        QFile file(fileName);
+        QVERIFY2(file.open(QIODevice::ReadOnly), qPrintable("Failed to open log."));
+        QDataStream stream(&file);
+        LogSensorStruct readLogSensorStruct;
+        stream >> readLogSensorStruct;
+        QVERIFY2(readLogSensorStruct.isValid() && readLogSensorStruct.version == configuration.version,
+            qPrintable(QString("Invalid log header, version: %1").arg(readLogSensorStruct.version)));
+
+        // Batch tools parse without leaving an index next to the log
+        timer.restart();
+        LogFileReader reader;
+        reader.setReadOnly(true);
+        QVERIFY2(reader.open(fileName, file.pos(), configuration.version), qPrintable("Failed to read log."));
+        qint64 readBytes = 0;
+        for (int i = 0; i < reader.size(); i++) {
+            readBytes += reader.data(i).size();
+        }
+        const qint64 readNs = timer.nsecsElapsed();
+        QVERIFY2(!QFile::exists(LogIndex::sidecarFileName(fileName)), qPrintable("Read only log was indexed."));
+
+        QVERIFY2(reader.size() == numberOfRecords,
+            qPrintable(QString("Number of records does not match: %1").arg(reader.size())));
+        for (int i : {0, 1, 255, 256, 257, numberOfRecords / 2, numberOfRecords - 1}) {
+            QVERIFY2(reader.data(i) == records[i % records.size()],
+                qPrintable(QString("Record %1 does not match in %2").arg(i).arg(fileName)));
+            QVERIFY2(reader.timestampNs(i) == i * periodNs,
+                qPrintable(QString("Timestamp %1 does not match in %2: %3")
+                               .arg(i)
+                               .arg(fileName)
+                               .arg(reader.timestampNs(i))));
+        }
+        QVERIFY2(reader.indexForTimestamp(1000 * periodNs + 1) == 1000,
+            qPrintable(QString("Wrong index for timestamp: %1").arg(reader.indexForTimestamp(1000 * periodNs + 1))));
+
+        // Size and CPU time for one hour of Ping360 at 133 profiles per second
+        v1Size = v1Size ? v1Size : file.size();
+        const double megabytes = readBytes / (1024.0 * 1024.0);
+        const double recordsPerHour = 133 * 3600;
+        qDebug() << QStringLiteral("%1: write %2 MB/s, read %3 MB/s, size %4% of v1, write CPU %5 s/hour")
+                        .arg(QFileInfo(fileName).fileName())
+                        .arg(megabytes * 1e9 / writeNs, 0, 'f', 1)
+                        .arg(megabytes * 1e9 / readNs, 0, 'f', 1)
+                        .arg(100.0 * file.size() / v1Size, 0, 'f', 1)
+                        .arg(writeNs * 1e-9 * recordsPerHour / numberOfRecords, 0, 'f', 2);
+    }
+
+    // Rotation by duration, every rotated file is a complete log
+    const QString fileName = dir.filePath(QStringLiteral("log_rotation.bin"));
+    LogSensorStruct logSensorStruct;
+    logSensorStruct.init();
+    LogFileWriter::Configuration configuration;
+    configuration.rotationDurationNs = 2000 * periodNs;
+    LogFileWriter writer;
+    writer.setConfiguration(configuration);
+    QVERIFY2(writer.open(fileName, logSensorStruct), qPrintable("Failed to create log."));
+    for (int i = 0; i < 5000; i++) {
+        writer.append(i * periodNs, records[i % records.size()]);
+    }
+    writer.close();
+
+    const auto statistics = writer.statistics();
+    QVERIFY2(statistics.files == 3 && statistics.writtenRecords == 5000 && statistics.droppedRecords == 0,
+        qPrintable(QString("Wrong rotation: %1 files, %2 records, %3 dropped")
+                       .arg(statistics.files)
+                       .arg(statistics.writtenRecords)
+                       .arg(statistics.droppedRecords)));
+    for (int part = 0; part < statistics.files; part++) {
+        QFile file(LogFileWriter::partFileName(fileName, part));
+        QVERIFY2(file.open(QIODevice::ReadOnly), qPrintable("Failed to open rotated log."));
+        QDataStream stream(&file);
+        LogSensorStruct readLogSensorStruct;
+        stream >> readLogSensorStruct;
+        LogFileReader reader;
+        QVERIFY2(reader.open(file.fileName(), file.pos(), readLogSensorStruct.version),
+            qPrintable("Failed to read rotated log."));
+        const int expectedRecords = part < 2 ? 2000 : 1000;
+        QVERIFY2(reader.size() == expectedRecords && reader.timestampNs(0) == part * 2000 * periodNs,
+            qPrintable(QString("Wrong rotated log %1: %2 records").arg(part).arg(reader.size())));
+    }
+}
+
+void Test::sensorThreads()
+{
+    // Two sensors, the parser thread of the first one stalls like a link that blocks
+    Ping stalled;
+    Ping running;
+    QSemaphore stall;
+    QMetaObject::invokeMethod(
+        stalled._parser, [&stall] { stall.acquire(); }, Qt::QueuedConnection);
+
+    ping1d_profile profile(200);
+    profile.set_profile_data_length(200);
+    profile.updateChecksum();
+    const QByteArray message(reinterpret_cast<const char*>(profile.msgData), profile.msgDataLength());
+    const int numberOfMessages = 100;
+    for (Parser* parser : {stalled._parser, running._parser}) {
+        for (int i = 0; i < numberOfMessages; i++) {
+            // Same path as the link data, queued to the parser thread
+            QMetaObject::invokeMethod(
+                parser, [parser, message] { parser->parseBuffer(message); }, Qt::QueuedConnection);
+        }
+    }
+
+    QTRY_VERIFY_WITH_TIMEOUT(running._parser->parsed == numberOfMessages, 5000);
+    QVERIFY2(stalled._parser->parsed == 0, qPrintable("Stalled sensor parsed messages."));
+
+    // The stalled sensor continues from where it stopped
+    stall.release();
+    QTRY_VERIFY_WITH_TIMEOUT(stalled._parser->parsed == numberOfMessages, 5000);
+
+    // A sensor destroyed while its parser is busy stops the parser before its own members are destroyed
+    auto destroyed = std::make_unique<Ping>();
+    Parser* destroyedParser = destroyed->_parser;
+    for (int i = 0; i < numberOfMessages; i++) {
+        QMetaObject::invokeMethod(
+            destroyedParser, [destroyedParser, message] { destroyedParser->parseBuffer(message); },
+            Qt::QueuedConnection);
+    }
+    destroyed.reset();
+    QTest::qWait(100);
+}
+
 void Test::settingsManager()
 {
     auto settingsManager = SettingsManager::self();
@@ -135,6 +1220,147 @@ void Test::settingsManager()
         qFuzzyCompare(scalar, 3.280839895), qPrintable(QString("Distance scalar in meters is wrong: %1").arg(scalar)));
     // Back to default value
     settingsManager->distanceUnitsIndex(0);
+
+    // A burst of changes is written at once
+    const auto before = settingsManager->settings().statistics();
+    for (int i = 0; i < 100; i++) {
+        settingsManager->replaySpeed(i % 2 ? 2 : 1);
+    }
+    settingsManager->replaySpeed(1);
+    settingsManager->settings().sync();
+    const auto after = settingsManager->settings().statistics();
+    QVERIFY2(after.changes - before.changes >= 100 && after.writes - before.writes < 5,
+        qPrintable(QString("Changes were not coalesced: %1 writes").arg(after.writes - before.writes)));
+}
+
+void Test::simulationLink()
+{
+    Ping1DSimulationLink link;
+    const LinkConfiguration configuration {
+        LinkType::Ping1DSimulation, {"rate=0", "samples=300", "templates=4", "fragment=7"}, "Simulation"};
+    QVERIFY2(link.setConfiguration(configuration), qPrintable("Valid simulation arguments were refused."));
+
+    quint64 bytes = 0;
+    int fragments = 0;
+    bool fragmented = true;
+    PingParser parser(10240);
+    int parsedMessages = 0;
+    connect(&link, &AbstractLink::newData, [&](const QByteArray& newData) {
+        fragmented &= !newData.isEmpty() && newData.size() <= 7;
+        fragments++;
+        bytes += newData.size();
+        for (const auto byte : newData) {
+            parsedMessages += parser.parseByte(byte) == PingParser::ParseState::NEW_MESSAGE;
+        }
+    });
+
+    // Profiles sent by request arrive complete, without waiting for the next one
+    const int numberOfProfiles = 10;
+    for (int i {0}; i < numberOfProfiles; i++) {
+        link.sendProfile();
+        QVERIFY2(parsedMessages == i + 1,
+            qPrintable(QString("Profile %1 was not complete, parsed %2.").arg(i).arg(parsedMessages)));
+    }
+    QVERIFY2(fragmented && fragments > numberOfProfiles, qPrintable("Data was not split in fragments."));
+    QVERIFY2(link._pendingData.isEmpty(), qPrintable("Data was kept after the profile."));
+    QVERIFY2(link.statistics().bytes == bytes, qPrintable("Wrong number of bytes."));
+
+    const LinkConfiguration corrupted {LinkType::Ping1DSimulation, {"rate=0", "corruption=1"}, "Simulation"};
+    QVERIFY2(link.setConfiguration(corrupted), qPrintable("Valid simulation arguments were refused."));
+    link.sendProfile();
+    QVERIFY2(link.statistics().corruptedProfiles == 1, qPrintable("Profile was not corrupted."));
+
+    const LinkConfiguration invalid {LinkType::Ping1DSimulation, {"rate=fast"}, "Simulation"};
+    QVERIFY2(!link.setConfiguration(invalid), qPrintable("Invalid simulation argument was accepted."));
+}
+
+void Test::stm32Bootloader()
+{
+#ifdef Q_OS_UNIX
+    QByteArray firmware(3001, 0);
+    for (int i {0}; i < firmware.size(); i++) {
+        firmware[i] = static_cast<char>(QRandomGenerator::global()->bounded(256));
+    }
+    QByteArray content = intelHexRecord(0, 0x04, QByteArray("\x08\x00", 2));
+    for (int offset {0}; offset < firmware.size(); offset += 32) {
+        content += intelHexRecord(offset, 0x00, firmware.mid(offset, 32));
+    }
+    content += intelHexRecord(0x2000, 0x00, QByteArray("\x01\x02\x03\x04\x05", 5));
+    IntelHex image;
+    QVERIFY2(image.parse(content), qPrintable("Firmware image was refused."));
+
+    // Reference value of the STM32 CRC unit for the word 0x12345678
+    const QByteArray memoryCrc = QByteArray("\x78\x56\x34\x12", 4);
+    QVERIFY2(Stm32Bootloader::crc32(memoryCrc) == 0xDF8A8A2B,
+        qPrintable(QString("Wrong CRC: %1").arg(Stm32Bootloader::crc32(memoryCrc), 8, 16)));
+
+    // Verification with checksum and readback, and a pipelined write that is lost
+    for (const bool checksum : {true, false}) {
+        BootloaderStandIn standIn(checksum, checksum ? 0 : 1);
+        QVERIFY2(!standIn.slaveName.isEmpty(), qPrintable("Failed to create pseudo terminal."));
+
+        QSerialPort port(standIn.slaveName);
+        port.setBaudRate(QSerialPort::Baud115200);
+        port.setParity(QSerialPort::EvenParity);
+        QVERIFY2(port.open(QIODevice::ReadWrite), qPrintable(port.errorString()));
+
+        float lastProgress = -1;
+        bool progressIncreases = true;
+        Stm32Bootloader bootloader(&port);
+        bootloader.setProgressCallback([&lastProgress, &progressIncreases](float progress) {
+            progressIncreases &= progress >= lastProgress;
+            lastProgress = progress;
+        });
+
+        QVERIFY2(bootloader.flash(image, true), qPrintable(bootloader.errorString()));
+        QVERIFY2(bootloader.supports(Stm32Bootloader::GetChecksum) == checksum,
+            qPrintable("Wrong list of bootloader commands."));
+        QVERIFY2(standIn.memory.left(firmware.size()) == firmware, qPrintable("Firmware was not written."));
+        QVERIFY2(standIn.memory.mid(0x2000, 8) == QByteArray("\x01\x02\x03\x04\x05\xFF\xFF\xFF", 8),
+            qPrintable("Second segment was not written."));
+        QVERIFY2(standIn.goAddress == BootloaderStandIn::flashAddress,
+            qPrintable(QString("Wrong application address: %1").arg(standIn.goAddress.load(), 8, 16)));
+        QVERIFY2(progressIncreases && qFuzzyCompare(lastProgress, 100.0f),
+            qPrintable(QString("Wrong progress: %1").arg(lastProgress)));
+    }
+#else
+    QSKIP("Pseudo terminals are not available.");
+#endif
+}
+
+void Test::tracer()
+{
+    auto tracer = Tracer::self();
+    QVERIFY2(!tracer->begin(Tracer::timestampNs()).isValid(), qPrintable("Context created with tracing disabled."));
+
+    tracer->setEnabled(true);
+    tracer->_recordEvents = true;
+    const int numberOfStages = Tracer::Paint + 1;
+    Tracer::Context context = tracer->begin(Tracer::timestampNs());
+    QVERIFY2(context.isValid(), qPrintable("Context was not created."));
+    for (int stage = 0; stage < numberOfStages; stage++) {
+        tracer->mark(context, static_cast<Tracer::Stage>(stage));
+    }
+    tracer->setEnabled(false);
+    tracer->_recordEvents = false;
+
+    const QVariantMap statistics = tracer->statistics();
+    QVERIFY2(statistics[QStringLiteral("Total")].toMap()[QStringLiteral("count")].toInt() == 1,
+        qPrintable("Total latency was not recorded."));
+    QVERIFY2(statistics[QStringLiteral("Draw")].toMap()[QStringLiteral("count")].toInt() == 1,
+        qPrintable("Stage latency was not recorded."));
+
+    QTemporaryDir dir;
+    const QString fileName = dir.filePath(QStringLiteral("trace.json"));
+    QVERIFY2(tracer->writeTrace(fileName), qPrintable("Failed to write trace."));
+    QFile file(fileName);
+    QVERIFY2(file.open(QIODevice::ReadOnly), qPrintable("Failed to open trace."));
+    const QJsonArray events = QJsonDocument::fromJson(file.readAll()).object()[QStringLiteral("traceEvents")].toArray();
+    int stageEvents = 0;
+    for (const auto& event : events) {
+        stageEvents += event.toObject()[QStringLiteral("ph")].toString() == QStringLiteral("X");
+    }
+    QVERIFY2(stageEvents == numberOfStages, qPrintable(QString("Wrong number of trace events: %1").arg(stageEvents)));
 }
 
 void Test::waterfallGradient()
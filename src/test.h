@@ -13,30 +13,138 @@ private slots:
      */
     void initTestCase();
 
+    /**
+     * @brief Test heading interpolation of the attitude history
+     *
+     */
+    void attitudeBuffer();
+
+    /**
+     * @brief Test log replay flow control
+     *
+     */
+    void fileLink();
+
     /**
      * @brief Test file manager
      *
      */
     void fileManager();
 
+    /**
+     * @brief Test Intel HEX parser
+     *
+     */
+    void intelHex();
+
+    /**
+     * @brief Test log cutting, splitting and concatenation
+     *
+     */
+    void logEditor();
+
+    /**
+     * @brief Test keyframes used to restore the view after a seek
+     *
+     */
+    void logKeyframes();
+
+    /**
+     * @brief Test log model ring and category filter
+     *
+     */
+    void logListModel();
+
+    /**
+     * @brief Test log overview and its cache
+     *
+     */
+    void logOverview();
+
+    /**
+     * @brief Test lock free queue of the logger with concurrent producers
+     *
+     */
+    void logQueue();
+
     /**
      * @brief Test logger singleton
      *
      */
     void logger();
 
+    /**
+     * @brief Test MAVLink subscriptions and message rates
+     *
+     */
+    void mavlinkManager();
+
+    /**
+     * @brief Test log replay speed
+     *
+     */
+    void processLog();
+
+    /**
+     * @brief Test profile chart min/max decimation
+     *
+     */
+    void profileChart();
+
+    /**
+     * @brief Test profile compression codec
+     *
+     */
+    void profileCodec();
+
+    /**
+     * @brief Test render statistics of profiles, frames and pacing
+     *
+     */
+    void renderStatistics();
+
     /**
      * @brief Test ring vector
      *
      */
     void ringVector();
 
+    /**
+     * @brief Test sensor log write and read in all versions
+     *
+     */
+    void sensorLog();
+
+    /**
+     * @brief Test that a stalled sensor does not delay the parser of another one
+     *
+     */
+    void sensorThreads();
+
     /**
      * @brief Test settings manager
      *
      */
     void settingsManager();
 
+    /**
+     * @brief Test load generator of simulation links
+     *
+     */
+    void simulationLink();
+
+    /**
+     * @brief Test STM32 bootloader protocol against a pseudo terminal
+     *
+     */
+    void stm32Bootloader();
+
+    /**
+     * @brief Test latency tracing
+     *
+     */
+    void tracer();
+
     /**
      * @brief Test waterfall gradient
      *
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <QLoggingCategory>
-#include <QtCharts>
+#include <QObject>
+#include <QStringList>
+#include <QSysInfo>
 
 class QJSEngine;
 class QQmlEngine;
@@ -18,20 +20,6 @@ class Util : public QObject {
     Q_OBJECT
 
 public:
-    /**
-     * @brief Create a QAbstractSeries from a list of points
-     *
-     * @param series
-     * @param points
-     * @param initPos
-     * @param finalPos
-     * @param minPoint
-     * @param maxPoint
-     * @param multiplier
-     */
-    Q_INVOKABLE void update(QtCharts::QAbstractSeries* series, const QVector<double>& points, const float initPos,
-        const float finalPos, const float minPoint, const float maxPoint, const float multiplier = 1);
-
     /**
      * @brief Return a list of the available serial ports
      *
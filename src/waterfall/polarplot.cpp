@@ -25,10 +25,6 @@ PolarPlot::PolarPlot(QQuickItem* parent)
     setAcceptHoverEvents(true);
     _image.fill(QColor(Qt::transparent));
 
-    connect(&_updateTimer, &QTimer::timeout, this, [&] { update(); });
-    _updateTimer.setSingleShot(true);
-    _updateTimer.start(50);
-
     connect(this, &Waterfall::mousePosChanged, this, &PolarPlot::updateMouseColumnData);
     connect(this, &Waterfall::themeChanged, this, &PolarPlot::clear);
 }
@@ -39,18 +35,22 @@ void PolarPlot::clear()
     _image.fill(Qt::transparent);
     _distances.fill(0, _angularResolution);
     _maxDistance = 0;
+    scheduleUpdate();
 }
 
 void PolarPlot::paint(QPainter* painter)
 {
-    static QPixmap pix;
+    paintStarted();
     if (painter != _painter) {
         _painter = painter;
     }
 
     // http://blog.qt.io/blog/2006/05/13/fast-transformed-pixmapimage-drawing/
-    pix = QPixmap::fromImage(_image, Qt::NoFormatConversion);
+    const QPixmap pix = QPixmap::fromImage(_image, Qt::NoFormatConversion);
     _painter->drawPixmap(QRect(0, 0, width(), height()), pix, QRect(0, 0, _image.width(), _image.height()));
+
+    // The whole image is converted to a texture in each paint
+    paintFinished(_image.sizeInBytes());
 }
 
 void PolarPlot::setImage(const QImage& image)
@@ -64,6 +64,9 @@ void PolarPlot::setImage(const QImage& image)
 void PolarPlot::draw(
     const QVector<double>& points, float angle, float initPoint, float length, float angleGrad, float sectorSize)
 {
+    _traceContext = Tracer::current();
+    Tracer::self()->mark(_traceContext, Tracer::HandleMessage);
+
     static const int maxGradian = 400;
     const float sectorSizeGradian = sectorSize * 200.0f / 180.0f;
 
@@ -106,12 +109,11 @@ void PolarPlot::draw(
         }
     }
 
-    // Fix max update in 20Hz at max
-    if (!_updateTimer.isActive()) {
-        _updateTimer.start(50);
-    }
+    _renderStatistics.profileIngested();
+    Tracer::self()->mark(_traceContext, Tracer::Draw);
 
-    emit imageChanged();
+    // Profiles drawn in the same frame are painted together
+    scheduleUpdate();
 }
 
 void PolarPlot::updateMouseColumnData()
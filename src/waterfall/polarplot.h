@@ -2,7 +2,6 @@
 
 #include <QImage>
 #include <QQuickPaintedItem>
-#include <QTimer>
 
 #include "logger.h"
 #include "ringvector.h"
@@ -116,5 +115,4 @@ private:
     QPainter* _painter;
     float _sectorSizeDegrees;
     static uint16_t _angularResolution;
-    QTimer _updateTimer;
 };
@@ -0,0 +1,202 @@
+#include "profilechart.h"
+
+#include <algorithm>
+
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+#include <QtMath>
+
+PING_LOGGING_CATEGORY(profilechart, "ping.profilechart")
+
+ProfileChart::ProfileChart(QQuickItem* parent)
+    : QQuickItem(parent)
+    , _color(Qt::green)
+    , _flip(false)
+    , _colorChanged(false)
+    , _initialDepth(0)
+    , _finalDepth(0)
+    , _minDepthToDraw(0)
+    , _maxDepthToDraw(0)
+{
+    setFlag(ItemHasContents);
+    connect(this, &QQuickItem::widthChanged, this, &QQuickItem::update);
+    connect(this, &QQuickItem::heightChanged, this, &QQuickItem::update);
+
+    // The summary is published from the GUI thread, paint nodes are updated in the render thread
+    connect(&_renderStatisticsTimer, &QTimer::timeout, this, [this] {
+        _renderStatisticsSummary = _renderStatistics.takeSummary();
+        emit renderStatisticsChanged();
+    });
+}
+
+void ProfileChart::setRenderStatisticsEnabled(bool enabled)
+{
+    if (enabled == renderStatisticsEnabled()) {
+        return;
+    }
+
+    if (enabled) {
+        // Start a new window, frames counted while hidden are not part of it
+        _renderStatistics.takeSummary();
+        _renderStatisticsTimer.start(1000);
+    } else {
+        _renderStatisticsTimer.stop();
+        _renderStatisticsSummary.clear();
+        emit renderStatisticsChanged();
+    }
+    emit renderStatisticsEnabledChanged();
+}
+
+void ProfileChart::draw(
+    const QVector<double>& points, float initialDepth, float finalDepth, float minDepthToDraw, float maxDepthToDraw)
+{
+    if (initialDepth > finalDepth) {
+        qCDebug(profilechart) << "Initial depth need to be lower than final depth.";
+        return;
+    }
+
+    // Keep the capacity of the last profile
+    _points.resize(points.size());
+    std::copy(points.cbegin(), points.cend(), _points.begin());
+    _initialDepth = initialDepth;
+    _finalDepth = finalDepth;
+    _minDepthToDraw = minDepthToDraw;
+    _maxDepthToDraw = maxDepthToDraw;
+
+    _renderStatistics.profileIngested();
+    update();
+}
+
+void ProfileChart::clear()
+{
+    _points.resize(0);
+    update();
+}
+
+void ProfileChart::setColor(const QColor& color)
+{
+    if (_color == color) {
+        return;
+    }
+
+    _color = color;
+    _colorChanged = true;
+    emit colorChanged();
+    update();
+}
+
+void ProfileChart::setFlip(bool flip)
+{
+    if (_flip == flip) {
+        return;
+    }
+
+    _flip = flip;
+    emit flipChanged();
+    update();
+}
+
+void ProfileChart::decimate(const QVector<float>& points, float initialDepth, float finalDepth, float minDepth,
+    float maxDepth, QVector<float>& rowMinimums, QVector<float>& rowMaximums)
+{
+    const int rows = rowMinimums.size();
+    const int size = points.size();
+    if (!size || finalDepth <= initialDepth || maxDepth <= minDepth) {
+        std::fill(rowMinimums.begin(), rowMinimums.end(), 0.0f);
+        std::fill(rowMaximums.begin(), rowMaximums.end(), 0.0f);
+        return;
+    }
+
+    const double samplesPerMeter = size / static_cast<double>(finalDepth - initialDepth);
+    const double samplesPerRow = (maxDepth - minDepth) / static_cast<double>(rows) * samplesPerMeter;
+    const double firstRowStart = (minDepth - initialDepth) * samplesPerMeter;
+
+    for (int row = 0; row < rows; row++) {
+        const double start = firstRowStart + row * samplesPerRow;
+        const double end = start + samplesPerRow;
+        if (end <= 0 || start >= size) {
+            rowMinimums[row] = 0;
+            rowMaximums[row] = 0;
+            continue;
+        }
+
+        // The last sample is the first one of the next row, connecting both
+        const int first = std::max(0, static_cast<int>(std::floor(start)));
+        const int last = std::min(size - 1, static_cast<int>(std::floor(end)));
+        float minimum = points[first];
+        float maximum = minimum;
+        for (int i = first + 1; i <= last; i++) {
+            minimum = std::min(minimum, points[i]);
+            maximum = std::max(maximum, points[i]);
+        }
+
+        // Part of the row is outside of the profile
+        if (start < 0 || end > size) {
+            minimum = std::min(minimum, 0.0f);
+            maximum = std::max(maximum, 0.0f);
+        }
+
+        rowMinimums[row] = minimum;
+        rowMaximums[row] = maximum;
+    }
+}
+
+QSGNode* ProfileChart::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data)
+{
+    Q_UNUSED(data)
+
+    _renderStatistics.frameStarted();
+
+    const int rows = std::max(1, qCeil(height()));
+    // Each row has a line in both traces
+    const int vertexCount = rows * 4;
+
+    auto node = static_cast<QSGGeometryNode*>(oldNode);
+    if (!node) {
+        auto geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), vertexCount);
+        geometry->setDrawingMode(QSGGeometry::DrawLines);
+        geometry->setLineWidth(1);
+        auto material = new QSGFlatColorMaterial;
+        material->setColor(_color);
+
+        node = new QSGGeometryNode;
+        node->setGeometry(geometry);
+        node->setMaterial(material);
+        node->setFlags(QSGNode::OwnsGeometry | QSGNode::OwnsMaterial);
+        _colorChanged = false;
+    }
+
+    QSGGeometry* geometry = node->geometry();
+    if (geometry->vertexCount() != vertexCount) {
+        geometry->allocate(vertexCount);
+    }
+
+    if (_colorChanged) {
+        static_cast<QSGFlatColorMaterial*>(node->material())->setColor(_color);
+        node->markDirty(QSGNode::DirtyMaterial);
+        _colorChanged = false;
+    }
+
+    _rowMinimums.resize(rows);
+    _rowMaximums.resize(rows);
+    decimate(_points, _initialDepth, _finalDepth, _minDepthToDraw, _maxDepthToDraw, _rowMinimums, _rowMaximums);
+
+    const float center = width() / 2;
+    QSGGeometry::Point2D* vertices = geometry->vertexDataAsPoint2D();
+    for (int row = 0; row < rows; row++) {
+        const float y = _flip ? height() - row - 0.5f : row + 0.5f;
+        const float minimum = center + _rowMinimums[row] * center;
+        // Lines have at least one pixel to show flat regions
+        const float maximum = std::max(center + _rowMaximums[row] * center, minimum + 1);
+        vertices[0].set(minimum, y);
+        vertices[1].set(maximum, y);
+        // Mirrored trace
+        vertices[2].set(2 * center - minimum, y);
+        vertices[3].set(2 * center - maximum, y);
+        vertices += 4;
+    }
+    node->markDirty(QSGNode::DirtyGeometry);
+
+    _renderStatistics.frameFinished(vertexCount * sizeof(QSGGeometry::Point2D));
+    return node;
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <QColor>
+#include <QQuickItem>
+#include <QTimer>
+#include <QVector>
+
+#include "logger.h"
+#include "renderstatistics.h"
+
+Q_DECLARE_LOGGING_CATEGORY(profilechart)
+
+/**
+ * @brief Amplitude chart of a profile, drawn with its mirrored trace
+ *  Depth is in the vertical axis and amplitude in the horizontal axis, from the center.
+ *  The profile is decimated for each pixel row keeping the minimum and maximum samples,
+ *  narrow echoes are visible at any zoom. Both traces are lines of a single vertex buffer
+ *  that is only reallocated when the height changes.
+ */
+class ProfileChart : public QQuickItem {
+    Q_OBJECT
+public:
+    /**
+     * @brief Construct a new Profile Chart object
+     *
+     * @param parent
+     */
+    ProfileChart(QQuickItem* parent = nullptr);
+
+    /**
+     * @brief Draw a profile
+     *
+     * @param points normalized amplitudes [0-1]
+     * @param initialDepth depth of the first sample
+     * @param finalDepth depth after the last sample
+     * @param minDepthToDraw depth at the top of the chart
+     * @param maxDepthToDraw depth at the bottom of the chart
+     */
+    Q_INVOKABLE void draw(const QVector<double>& points, float initialDepth, float finalDepth, float minDepthToDraw,
+        float maxDepthToDraw);
+
+    /**
+     * @brief Remove the profile
+     *
+     */
+    Q_INVOKABLE void clear();
+
+    /**
+     * @brief Decimate a profile keeping the minimum and maximum of each row
+     *  Each row includes the samples that overlap it and the first sample of the next row,
+     *  so consecutive rows are connected. Rows without samples are zero.
+     *
+     * @param points
+     * @param initialDepth depth of the first sample
+     * @param finalDepth depth after the last sample
+     * @param minDepth depth at the start of the first row
+     * @param maxDepth depth at the end of the last row
+     * @param rowMinimums output, its size is the number of rows
+     * @param rowMaximums output, same size of rowMinimums
+     */
+    static void decimate(const QVector<float>& points, float initialDepth, float finalDepth, float minDepth,
+        float maxDepth, QVector<float>& rowMinimums, QVector<float>& rowMaximums);
+
+    /**
+     * @brief Return the trace color
+     *
+     * @return QColor
+     */
+    QColor color() const { return _color; }
+
+    /**
+     * @brief Set the trace color
+     *
+     * @param color
+     */
+    void setColor(const QColor& color);
+    Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
+
+    /**
+     * @brief Check if depth increases to the top of the chart
+     *
+     * @return true
+     * @return false
+     */
+    bool flip() const { return _flip; }
+
+    /**
+     * @brief Set the depth direction
+     *
+     * @param flip
+     */
+    void setFlip(bool flip);
+    Q_PROPERTY(bool flip READ flip WRITE setFlip NOTIFY flipChanged)
+
+    /**
+     * @brief Return the render statistics of the last second
+     *  Check RenderStatistics::takeSummary
+     *
+     * @return QVariantMap
+     */
+    QVariantMap renderStatistics() const { return _renderStatisticsSummary; }
+    Q_PROPERTY(QVariantMap renderStatistics READ renderStatistics NOTIFY renderStatisticsChanged)
+
+    /**
+     * @brief Check if the render statistics are published
+     *
+     * @return true
+     * @return false
+     */
+    bool renderStatisticsEnabled() const { return _renderStatisticsTimer.isActive(); }
+
+    /**
+     * @brief Publish the render statistics every second, only needed while they are shown
+     *
+     * @param enabled
+     */
+    void setRenderStatisticsEnabled(bool enabled);
+    Q_PROPERTY(bool renderStatisticsEnabled READ renderStatisticsEnabled WRITE setRenderStatisticsEnabled NOTIFY
+            renderStatisticsEnabledChanged)
+
+signals:
+    void colorChanged();
+    void flipChanged();
+    void renderStatisticsChanged();
+    void renderStatisticsEnabledChanged();
+
+protected:
+    /**
+     * @brief Update the vertices of the traces in the render thread
+     *
+     * @param oldNode
+     * @param data
+     * @return QSGNode*
+     */
+    QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data) override;
+
+private:
+    Q_DISABLE_COPY(ProfileChart)
+
+    QColor _color;
+    bool _flip;
+    bool _colorChanged;
+
+    // Last profile, read by the render thread while the GUI thread is blocked
+    QVector<float> _points;
+    float _initialDepth;
+    float _finalDepth;
+    float _minDepthToDraw;
+    float _maxDepthToDraw;
+
+    // Decimation buffers, reused by all frames with the same height
+    QVector<float> _rowMinimums;
+    QVector<float> _rowMaximums;
+
+    // A profile should be painted in the next two frames of a 60Hz display
+    static const int _expectedPaintDelayMs = 33;
+    RenderStatistics _renderStatistics {_expectedPaintDelayMs};
+    QVariantMap _renderStatisticsSummary;
+    QTimer _renderStatisticsTimer;
+};
@@ -62,6 +62,77 @@ Waterfall::Waterfall(QQuickItem* parent)
     setAcceptHoverEvents(true);
     setGradients();
     setTheme("Thermal blue");
+
+    // The summary is published from the GUI thread, paint can run in the render thread
+    connect(&_renderStatisticsTimer, &QTimer::timeout, this, [this] {
+        _renderStatisticsSummary = _renderStatistics.takeSummary();
+        emit renderStatisticsChanged();
+    });
+}
+
+void Waterfall::setRenderStatisticsEnabled(bool enabled)
+{
+    if (enabled == renderStatisticsEnabled()) {
+        return;
+    }
+
+    if (enabled) {
+        // Start a new window, frames counted while hidden are not part of it
+        _renderStatistics.takeSummary();
+        _renderStatisticsTimer.start(1000);
+    } else {
+        _renderStatisticsTimer.stop();
+        _renderStatisticsSummary.clear();
+        emit renderStatisticsChanged();
+    }
+    emit renderStatisticsEnabledChanged();
+}
+
+void Waterfall::scheduleUpdate()
+{
+    _dirty = true;
+    if (_updatePending) {
+        return;
+    }
+
+    _updatePending = true;
+    update();
+}
+
+void Waterfall::handleFrameSwapped()
+{
+    _updatePending = false;
+    if (_dirty) {
+        scheduleUpdate();
+    }
+}
+
+void Waterfall::itemChange(ItemChange change, const ItemChangeData& value)
+{
+    if (change == ItemSceneChange) {
+        disconnect(_frameSwappedConnection);
+        _updatePending = false;
+        if (value.window) {
+            // frameSwapped is emitted by the render thread
+            _frameSwappedConnection = connect(
+                value.window, &QQuickWindow::frameSwapped, this, &Waterfall::handleFrameSwapped, Qt::QueuedConnection);
+            scheduleUpdate();
+        }
+    }
+    QQuickPaintedItem::itemChange(change, value);
+}
+
+void Waterfall::paintStarted()
+{
+    _renderStatistics.frameStarted();
+    _dirty = false;
+}
+
+void Waterfall::paintFinished(qint64 uploadBytes)
+{
+    _renderStatistics.frameFinished(uploadBytes);
+    Tracer::self()->mark(_traceContext, Tracer::Paint);
+    _traceContext = {};
 }
 
 void Waterfall::setGradients()
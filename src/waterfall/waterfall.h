@@ -2,9 +2,13 @@
 
 #include <QImage>
 #include <QQuickPaintedItem>
+#include <QQuickWindow>
+#include <QTimer>
 
 #include "logger.h"
+#include "renderstatistics.h"
 #include "ringvector.h"
+#include "tracer.h"
 #include "waterfallgradient.h"
 
 Q_DECLARE_LOGGING_CATEGORY(waterfall)
@@ -154,6 +158,32 @@ public:
     WaterfallGradient* waterfallGradient() { return &_gradient; };
     Q_PROPERTY(WaterfallGradient* waterfallGradient READ waterfallGradient NOTIFY themeChanged)
 
+    /**
+     * @brief Return the render statistics of the last second
+     *  Check RenderStatistics::takeSummary
+     *
+     * @return QVariantMap
+     */
+    QVariantMap renderStatistics() const { return _renderStatisticsSummary; }
+    Q_PROPERTY(QVariantMap renderStatistics READ renderStatistics NOTIFY renderStatisticsChanged)
+
+    /**
+     * @brief Check if the render statistics are published
+     *
+     * @return true
+     * @return false
+     */
+    bool renderStatisticsEnabled() const { return _renderStatisticsTimer.isActive(); }
+
+    /**
+     * @brief Publish the render statistics every second, only needed while they are shown
+     *
+     * @param enabled
+     */
+    void setRenderStatisticsEnabled(bool enabled);
+    Q_PROPERTY(bool renderStatisticsEnabled READ renderStatisticsEnabled WRITE setRenderStatisticsEnabled NOTIFY
+            renderStatisticsEnabledChanged)
+
 signals:
     void antialiasingChanged();
 
@@ -165,8 +195,41 @@ signals:
     void themeChanged();
     void themesChanged();
     void smoothChanged();
+    void renderStatisticsChanged();
+    void renderStatisticsEnabledChanged();
 
 protected:
+    /**
+     * @brief Mark the item as dirty and request an update in the next frame of the window
+     *  Only one update is requested per frame, data that arrives while a frame is rendered
+     *  is painted in the next one.
+     *
+     */
+    void scheduleUpdate();
+
+    /**
+     * @brief Start the paint measurement and clear the dirty flag
+     *  Must be called at the start of paint
+     *
+     */
+    void paintStarted();
+
+    /**
+     * @brief Finish the paint measurement and the trace of the last drawn message
+     *  Must be called at the end of paint
+     *
+     * @param uploadBytes bytes converted to a texture by the paint
+     */
+    void paintFinished(qint64 uploadBytes);
+
+    /**
+     * @brief Follow the frames of the window where the item is shown
+     *
+     * @param change
+     * @param value
+     */
+    void itemChange(ItemChange change, const ItemChangeData& value) override;
+
     bool _containsMouse;
     WaterfallGradient _gradient;
     static QList<WaterfallGradient> _gradients;
@@ -174,6 +237,11 @@ protected:
     bool _smooth;
     QString _theme;
     QStringList _themes;
+    // Trace of the last drawn message, finished when painted
+    Tracer::Context _traceContext;
+    // A profile should be painted in the next two frames of a 60Hz display
+    static const int _expectedPaintDelayMs = 33;
+    RenderStatistics _renderStatistics {_expectedPaintDelayMs};
 
 private:
     Q_DISABLE_COPY(Waterfall)
@@ -189,4 +257,19 @@ private:
      *
      */
     void loadUserGradients();
+
+    /**
+     * @brief Request the update of data drawn while the last frame was rendered
+     *
+     */
+    void handleFrameSwapped();
+
+    // New data was drawn and it was not painted yet, paint runs while the GUI thread is blocked
+    bool _dirty = false;
+    // An update was requested and the frame was not swapped yet
+    bool _updatePending = false;
+    QMetaObject::Connection _frameSwappedConnection;
+
+    QVariantMap _renderStatisticsSummary;
+    QTimer _renderStatisticsTimer;
 };
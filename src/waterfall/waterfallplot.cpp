@@ -21,7 +21,6 @@ WaterfallPlot::WaterfallPlot(QQuickItem* parent)
     , _minDepthToDrawInPixels(0)
     , _mouseDepth(0)
     , _painter(nullptr)
-    , _updateTimer(new QTimer(this))
 {
     // This is the max depth that ping returns
     setWaterfallMaxDepth(70);
@@ -30,10 +29,6 @@ WaterfallPlot::WaterfallPlot(QQuickItem* parent)
     setAcceptHoverEvents(true);
     _image.fill(QColor(Qt::transparent));
 
-    connect(_updateTimer, &QTimer::timeout, this, [&] { update(); });
-    _updateTimer->setSingleShot(true);
-    _updateTimer->start(50);
-
     connect(this, &Waterfall::mousePosChanged, this, &WaterfallPlot::updateMouseColumnData);
 }
 
@@ -45,25 +40,22 @@ void WaterfallPlot::setWaterfallMaxDepth(float maxDepth)
 
 void WaterfallPlot::paint(QPainter* painter)
 {
-    static QPixmap pix;
+    paintStarted();
     if (painter != _painter) {
         _painter = painter;
     }
 
-    static uint16_t first;
-
-    if (_currentDrawIndex < _displayWidth) {
-        first = 0;
-    } else {
-        first = _currentDrawIndex - _displayWidth;
-    }
+    const uint16_t first = _currentDrawIndex < _displayWidth ? 0 : _currentDrawIndex - _displayWidth;
 
     // http://blog.qt.io/blog/2006/05/13/fast-transformed-pixmapimage-drawing/
-    pix = QPixmap::fromImage(_image, Qt::NoFormatConversion);
+    const QPixmap pix = QPixmap::fromImage(_image, Qt::NoFormatConversion);
     // Code for debug, draw the entire waterfall
     //_painter->drawPixmap(_painter->viewport(), pix, QRect(0, 0, _image.width(), _image.height()));
     _painter->drawPixmap(QRect(0, 0, width(), height()), pix,
         QRect(first, _minDepthToDrawInPixels, _displayWidth, _maxDepthToDrawInPixels));
+
+    // The whole image is converted to a texture in each paint
+    paintFinished(_image.sizeInBytes());
 }
 
 void WaterfallPlot::setImage(const QImage& image)
@@ -82,6 +74,7 @@ void WaterfallPlot::clear()
     _mouseDepth = 0;
     _DCRing.fill({static_cast<float>(_image.height()), 0, 0, 0}, _displayWidth);
     _image.fill(Qt::transparent);
+    scheduleUpdate();
 }
 
 void WaterfallPlot::draw(const QVector<double>& points, float confidence, float initPoint, float length, float distance)
@@ -95,8 +88,8 @@ void WaterfallPlot::draw(const QVector<double>& points, float confidence, float
         lastMinDepth: Returns the minimum point in the chart
         _minDepthToDraw: Minimum depth point, populated by lastMinDepth
         _maxDepthToDraw: Maximum depth point, calculated from lastMaxDC
-        dynamicPixelsPerMeterScalar: Calculate the delta between number of pixels per meter
-            dynamicPixelsPerMeterScalar = 400/((_maxDepthToDraw - _minDepthToDraw)*_minPixelsPerMeter);
+        _dynamicPixelsPerMeterScalar: Calculate the delta between number of pixels per meter
+            _dynamicPixelsPerMeterScalar = 400/((_maxDepthToDraw - _minDepthToDraw)*_minPixelsPerMeter);
 
         old (oldest sample)     new (last sample)
         |                       |
@@ -121,18 +114,24 @@ void WaterfallPlot::draw(const QVector<double>& points, float confidence, float
         +-----------------------+  - _maxDepthToDrawInPixels = 400px
 
         _minDepthToDrawInPixels: The lowest pixel that will appears for the user
-            _minDepthToDrawInPixels = (_minDepthToDraw*_minPixelsPerMeter*dynamicPixelsPerMeterScalar);
+            _minDepthToDrawInPixels = (_minDepthToDraw*_minPixelsPerMeter*_dynamicPixelsPerMeterScalar);
         _maxDepthToDrawInPixels: Is defined to be 400 pixels
         virtualFloor: It's the lowest pixel position to start drawing the last sample
-            virtualFloor = (initPoint*_minPixelsPerMeter*dynamicPixelsPerMeterScalar);
+            virtualFloor = (initPoint*_minPixelsPerMeter*_dynamicPixelsPerMeterScalar);
         virtualFloor: It's the highest delta pixel position (from virtualFloor) to finish drawing the last sample
-            virtualHeight = ((length + initPoint - _minDepthToDraw)*_minPixelsPerMeter*dynamicPixelsPerMeterScalar);
+            virtualHeight = ((length + initPoint - _minDepthToDraw)*_minPixelsPerMeter*_dynamicPixelsPerMeterScalar);
     */
 
-    // Declare oldImage variable to do image spins
-    static QImage old = _image;
-    // Declare oldPoints variable to do some filter
-    static QVector<double> oldPoints = points;
+    _traceContext = Tracer::current();
+    Tracer::self()->mark(_traceContext, Tracer::HandleMessage);
+
+    // Image used to do image spins and previous points used by the smooth filter
+    if (_oldImage.isNull()) {
+        _oldImage = _image;
+    }
+    if (_oldPoints.size() != points.size()) {
+        _oldPoints = points;
+    }
 
     // This ring vector will store variables of the last n samples for user access
     _DCRing.append({initPoint, length, confidence, distance});
@@ -168,60 +167,57 @@ void WaterfallPlot::draw(const QVector<double>& points, float confidence, float
      *
      * dst is the rectangle that will be used to draw old in `image`.
      * src is the rectangle that will be used as source to be drawed in `image`,
-     *        the default value is old.rect().
+     *        the default value is _oldImage.rect().
      *
      */
     auto redrawImage = [&](const QRect& dst, QRect src = QRect()) {
         // Use old as default rect
         if (src.isEmpty()) {
-            src = old.rect();
+            src = _oldImage.rect();
         }
 
         // Swap is faster
-        _image.swap(old);
+        _image.swap(_oldImage);
         _image.fill(Qt::transparent);
         QPainter painter(&_image);
         // Clean everything and start from zero
         painter.fillRect(_image.rect(), Qt::transparent);
-        // QRect(0, 0, _image.width(), _image.height()*dynamicPixelsPerMeterScalar), old
-        painter.drawImage(dst, old, src);
+        // QRect(0, 0, _image.width(), _image.height()*_dynamicPixelsPerMeterScalar), old
+        painter.drawImage(dst, _oldImage, src);
         painter.end();
     };
 
-    static DCPack _maxDC;
-    _maxDC = lastMaxDC();
+    const DCPack maxDC = lastMaxDC();
     _minDepthToDraw = lastMinDepth();
-    _maxDepthToDraw = _maxDC.initialDepth + _maxDC.length;
+    _maxDepthToDraw = maxDC.initialDepth + maxDC.length;
     emit minDepthToDrawChanged();
     emit maxDepthToDrawChanged();
 
-    static bool inDynamic = false;
-    static float dynamicPixelsPerMeterScalar = 1.0;
     // If the points/resolution is **NOT** bigger than 1pixel/point
     if ((_maxDepthToDraw - _minDepthToDraw) * _minPixelsPerMeter < 200) {
-        if (!inDynamic) {
-            inDynamic = true;
-            dynamicPixelsPerMeterScalar = 200 / _minPixelsPerMeter;
-            redrawImage(QRect(0, 0, _image.width(), _image.height() * dynamicPixelsPerMeterScalar));
+        if (!_inDynamic) {
+            _inDynamic = true;
+            _dynamicPixelsPerMeterScalar = 200 / _minPixelsPerMeter;
+            redrawImage(QRect(0, 0, _image.width(), _image.height() * _dynamicPixelsPerMeterScalar));
         }
     } else {
         // If the points/resolution is bigger than 1pixel/point
-        if (inDynamic) {
-            redrawImage(QRect(0, 0, _image.width(), _image.height() / dynamicPixelsPerMeterScalar));
+        if (_inDynamic) {
+            redrawImage(QRect(0, 0, _image.width(), _image.height() / _dynamicPixelsPerMeterScalar));
         }
-        inDynamic = false;
-        dynamicPixelsPerMeterScalar = 1;
+        _inDynamic = false;
+        _dynamicPixelsPerMeterScalar = 1;
     }
     _minDepthToDrawInPixels = _minDepthToDraw * _minPixelsPerMeter;
-    _maxDepthToDrawInPixels = (_maxDepthToDraw - _minDepthToDraw) * _minPixelsPerMeter * dynamicPixelsPerMeterScalar;
+    _maxDepthToDrawInPixels = (_maxDepthToDraw - _minDepthToDraw) * _minPixelsPerMeter * _dynamicPixelsPerMeterScalar;
     int virtualFloor = initPoint * _minPixelsPerMeter;
-    int virtualHeight = length * _minPixelsPerMeter * dynamicPixelsPerMeterScalar;
+    int virtualHeight = length * _minPixelsPerMeter * _dynamicPixelsPerMeterScalar;
 
     // Copy tail to head
     // TODO: can we get even better and allocate just once at initialization? ie circular buffering
     if (_currentDrawIndex >= _image.width()) {
         redrawImage(QRect(0, 0, _displayWidth, _image.height()),
-            QRect(old.width() - _displayWidth, 0, _displayWidth, old.height()));
+            QRect(_oldImage.width() - _displayWidth, 0, _displayWidth, _oldImage.height()));
 
         // Start painting from the beginning
         _currentDrawIndex = _displayWidth;
@@ -249,23 +245,23 @@ void WaterfallPlot::draw(const QVector<double>& points, float confidence, float
                                                 .arg(_minDepthToDrawInPixels)
                                                 .arg(_maxDepthToDrawInPixels);
         qCDebug(waterfallplot).noquote() << QStringLiteral(
-            "initPoint: %1\t length: %2\t _minPixelsPerMeter: %3\t dynamicPixelsPerMeterScalar: %4")
+            "initPoint: %1\t length: %2\t _minPixelsPerMeter: %3\t _dynamicPixelsPerMeterScalar: %4")
                                                 .arg(initPoint)
                                                 .arg(length)
                                                 .arg(_minPixelsPerMeter)
-                                                .arg(dynamicPixelsPerMeterScalar);
+                                                .arg(_dynamicPixelsPerMeterScalar);
         return;
     }
 
     if (smooth()) {
 #pragma omp for
         for (int i = 0; i < points.length(); i++) {
-            oldPoints[i] = points[i] * 0.2 + oldPoints[i] * 0.8;
+            _oldPoints[i] = points[i] * 0.2 + _oldPoints[i] * 0.8;
         }
 
 #pragma omp for
         for (int i = 0; i < virtualHeight; i++) {
-            _image.setPixelColor(_currentDrawIndex, i + virtualFloor, valueToRGB(oldPoints[factor * i]));
+            _image.setPixelColor(_currentDrawIndex, i + virtualFloor, valueToRGB(_oldPoints[factor * i]));
         }
     } else {
 #pragma omp for
@@ -274,21 +270,16 @@ void WaterfallPlot::draw(const QVector<double>& points, float confidence, float
         }
     }
     _currentDrawIndex++; // This can get to be an issue at very fast update rates from ping
+    _renderStatistics.profileIngested();
+    Tracer::self()->mark(_traceContext, Tracer::Draw);
 
-    // Fix max update in 20Hz at max
-    if (!_updateTimer->isActive()) {
-        _updateTimer->start(50);
-    }
+    // Profiles drawn in the same frame are painted together
+    scheduleUpdate();
 }
 
 void WaterfallPlot::updateMouseColumnData()
 {
-    static uint16_t first;
-    if (_currentDrawIndex < _displayWidth) {
-        first = 0;
-    } else {
-        first = _currentDrawIndex - _displayWidth;
-    }
+    const uint16_t first = _currentDrawIndex < _displayWidth ? 0 : _currentDrawIndex - _displayWidth;
 
     int widthPos = _mousePos.x() * _displayWidth / width();
     _mousePos.setX(_mousePos.x() * _displayWidth / width() + first);
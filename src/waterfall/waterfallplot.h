@@ -136,7 +136,10 @@ private:
 
     uint16_t _currentDrawIndex;
     static uint16_t _displayWidth;
+    // Keep the waterfall scaled when there is less than 1 pixel per point
+    float _dynamicPixelsPerMeterScalar = 1.0;
     QImage _image;
+    bool _inDynamic = false;
     float _maxDepthToDraw;
     float _maxDepthToDrawInPixels;
     float _minDepthToDraw;
@@ -145,8 +148,10 @@ private:
     float _mouseColumnConfidence;
     float _mouseColumnDepth;
     float _mouseDepth;
+    // Buffer used to redraw the image and points of the smooth filter
+    QImage _oldImage;
+    QVector<double> _oldPoints;
     QPainter* _painter;
-    QTimer* _updateTimer;
     float _waterfallDepth;
 
     /**
@@ -30,6 +30,31 @@ mkdir -p ${build_test}
 cmake -B ${build_test} -DCMAKE_BUILD_TYPE=Debug && cmake --build ${build_test} --parallel --config Debug
 xvfb-run --server-args="-screen 0 1024x768x24" $build_test/test || exit 1
 
+echob "Run benchmarks:"
+# Timings of a debug build do not represent the application, benchmarks have their own release build
+build_benchmark="$projectpath/build_benchmark"
+rm -rf $build_benchmark
+mkdir -p ${build_benchmark}
+cmake -B ${build_benchmark} -DCMAKE_BUILD_TYPE=Release \
+    && cmake --build ${build_benchmark} --parallel --config Release --target benchmarks || exit 1
+# Results are compared with the committed baseline, set PING_BENCHMARK_UPDATE_BASELINE=1 to replace it
+benchmark_baseline="${scriptpath}/benchmark-baseline.json"
+if [ -n "${PING_BENCHMARK_UPDATE_BASELINE}" ]; then
+    echob "Benchmark baseline will be replaced."
+elif [ -f "${benchmark_baseline}" ]; then
+    export PING_BENCHMARK_BASELINE=${benchmark_baseline}
+else
+    # The "::warning::" prefix is shown as an annotation by GitHub Actions
+    echo "::warning::No benchmark baseline in ${benchmark_baseline}, regressions are not checked." \
+        "Commit the benchmarks.json of a release build, e.g. the artifact of this job."
+fi
+PING_BENCHMARK_OUTPUT=${build_benchmark}/benchmarks.json \
+    xvfb-run --server-args="-screen 0 1024x768x24" $build_benchmark/benchmarks || exit 1
+if [ -n "${PING_BENCHMARK_UPDATE_BASELINE}" ]; then
+    cp ${build_benchmark}/benchmarks.json ${benchmark_baseline}
+    echob "Benchmark baseline saved in ${benchmark_baseline}, commit it to check for regressions."
+fi
+
 echob "Do runtime test:"
 ${scriptpath}/compile.sh --autokill --no-deploy --debug || exit 1
 export DISPLAY=:99.0